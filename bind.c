@@ -448,10 +448,14 @@ MYLOG(DETAIL_LOG_LEVEL, "num_params=%d,%d\n", stmt->num_params, stmt->proc_retur
 	}
 	else
 	{
+		ConnectionClass *conn = SC_get_conn(stmt);
+		Int2	stmt_type;
 		po_ind_t multi = FALSE, proc_return = 0;
 
 		stmt->proc_return = 0;
-		SC_scanQueryAndCountParams(stmt->statement, SC_get_conn(stmt), NULL, pcpar, &multi, &proc_return);
+		/* processed before, possibly with other parameter types */
+		if (!CC_lookup_scanned(conn, stmt->statement, &stmt_type, pcpar, &multi))
+			SC_scanQueryAndCountParams(stmt->statement, conn, NULL, pcpar, &multi, &proc_return);
 		stmt->num_params = *pcpar;
 		stmt->proc_return = proc_return;
 		stmt->multi_statement = multi;
@@ -833,6 +837,17 @@ MYLOG(DETAIL_LOG_LEVEL, "freeall=%d allocated=%d gdata=%p\n", freeall, self->all
 	}
 }
 
+/*	The size of the buffers SQLGetData keeps the converted values in */
+SQLULEN	GDATA_get_memory_size(const GetDataInfo *self)
+{
+	SQLULEN	size = self->fdata.ttlbuflen;
+	int	i;
+
+	for (i = 0; i < self->allocated; i++)
+		size += self->gdata[i].ttlbuflen;
+	return size;
+}
+
 void GetDataInfoInitialize(GetDataInfo *gdata_info)
 {
 	GETDATA_RESET(gdata_info->fdata);
@@ -121,6 +121,7 @@ void	GetDataInfoInitialize(GetDataInfo *gdata);
 void	extend_getdata_info(GetDataInfo *gdata, int num_columns, BOOL shrink);
 void	reset_a_getdata_info(GetDataInfo *gdata, int icol);
 void	GDATA_unbind_cols(GetDataInfo *gdata, BOOL freeall);
+SQLULEN	GDATA_get_memory_size(const GetDataInfo *gdata);
 void	PutDataInfoInitialize(PutDataInfo *pdata);
 void	extend_putdata_info(PutDataInfo *pdata, int num_params, BOOL shrink);
 void	reset_a_putdata_info(PutDataInfo *pdata, int ipar);
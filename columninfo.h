@@ -27,6 +27,7 @@ struct ColumnInfoClass_
 		Int4	atttypmod;	/* the length of bpchar/varchar */
 		OID	relid;		/* the relation id */
 		Int2	attid;		/* the attribute number */
+		Int2	format;		/* 0: text, 1: binary */
 	}	*coli_array;
 };
 
@@ -38,6 +39,8 @@ struct ColumnInfoClass_
 #define CI_get_atttypmod(self, col)		(self->coli_array[col].atttypmod)
 #define CI_get_relid(self, col)	(self->coli_array[col].relid)
 #define CI_get_attid(self, col)	(self->coli_array[col].attid)
+#define CI_get_format(self, col)	(self->coli_array[col].format)
+#define CI_is_binary(self, col)	(0 != (self->coli_array[col].format))
 
 ColumnInfoClass *CI_Constructor(void);
 void		CI_Destructor(ColumnInfoClass *self);
@@ -217,6 +217,7 @@ PGAPI_Disconnect(HDBC hdbc)
 		return SQL_INVALID_HANDLE;
 	}
 
+	CC_complete_async_execs(conn);
 	if (conn->status == CONN_EXECUTING)
 	{
 		CC_set_error(conn, CONN_IN_USE, "A transaction is currently being executed", func);
@@ -281,6 +282,16 @@ reset_current_schema(ConnectionClass *self)
 	self->current_schema_valid = FALSE;
 }
 
+static void
+reset_rules_table(ConnectionClass *self)
+{
+	if (self->rules_table)
+	{
+		free(self->rules_table);
+		self->rules_table = NULL;
+	}
+}
+
 static ConnectionClass *
 CC_alloc(void)
 {
@@ -366,6 +377,7 @@ CC_Destructor(ConnectionClass *self)
 {
 	MYLOG(0, "entering self=%p\n", self);
 
+	CC_complete_async_execs(self);
 	if (self->status == CONN_EXECUTING)
 		return 0;
 
@@ -426,6 +438,27 @@ CC_cursor_count(ConnectionClass *self)
 	return count;
 }
 
+/*
+ *	Return how much memory the results of this connection hold. The
+ *	result exclude isn't counted.
+ */
+SQLULEN
+CC_get_result_memory(ConnectionClass *self, const QResultClass *exclude)
+{
+	StatementClass *stmt;
+	SQLULEN		size = 0;
+	int			i;
+
+	CONNLOCK_ACQUIRE(self);
+	for (i = 0; i < self->num_stmts; i++)
+	{
+		if (stmt = self->stmts[i], NULL != stmt)
+			size += SC_get_result_memory(stmt, exclude);
+	}
+	CONNLOCK_RELEASE(self);
+
+	return size;
+}
 
 void
 CC_clear_error(ConnectionClass *self)
@@ -655,6 +688,7 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	StatementClass *stmt;
 	DescriptorClass *desc;
 
+	CC_complete_async_execs(self);
 	if (self->status == CONN_EXECUTING)
 		return FALSE;
 
@@ -670,6 +704,9 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 		PQfinish(self->pqconn);
 		self->pqconn = NULL;
 	}
+	self->streaming_res = NULL;
+	self->prefetch_res = NULL;
+	self->async_stmt = NULL;
 
 	MYLOG(0, "after PQfinish\n");
 
@@ -736,6 +773,9 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	}
 	/* Free cached table info */
 	CC_clear_col_info(self, TRUE);
+	CC_clear_plan_cache(self);
+	CC_clear_stmt_cache(self);
+	reset_rules_table(self);
 	if (self->num_discardp > 0 && self->discardp)
 	{
 		for (i = 0; i < self->num_discardp; i++)
@@ -1606,6 +1646,10 @@ MYLOG(0, "entering opt=%x\n", opt);
 			CONNLOCK_ACQUIRE(conn);
 			conn->pqconn = NULL;
 		}
+		conn->streaming_res = NULL;
+		conn->prefetch_res = NULL;
+		conn->async_stmt = NULL;
+		CC_clear_plan_cache(conn);
 	}
 	else if (set_no_trans)
 	{
@@ -1656,6 +1700,27 @@ is_setting_search_path(const char *query)
 	return FALSE;
 }
 
+/*
+ * Let libpq return the rows of the query just sent in chunks of
+ * FetchChunkSize rows. Returns FALSE if it's not available, in which
+ * case the caller falls back to the single-row mode.
+ */
+static BOOL
+CC_set_rows_mode(ConnectionClass *self)
+{
+#ifdef	LIBPQ_HAS_CHUNK_MODE
+	int	chunk_size = self->connInfo.fetch_chunk_size;
+
+	if (chunk_size > 1 &&
+		PQsetChunkedRowsMode(self->pqconn, chunk_size))
+	{
+		MYLOG(DETAIL_LOG_LEVEL, "chunked rows mode size=%d\n", chunk_size);
+		return TRUE;
+	}
+#endif /* LIBPQ_HAS_CHUNK_MODE */
+	return FALSE;
+}
+
 static BOOL
 CC_from_PGresult(QResultClass *res, StatementClass *stmt,
 				 ConnectionClass *conn, const char *cursor, PGresult **pgres)
@@ -1694,6 +1759,7 @@ CC_internal_rollback(ConnectionClass *self, int rollback_type, BOOL ignore_abort
 
 	if (!CC_is_in_error_trans(self))
 		return 1;
+	CC_finish_pending_rows(self);
 	switch (rollback_type)
 	{
 		case PER_STATEMENT_ROLLBACK:
@@ -1751,6 +1817,67 @@ CC_internal_rollback(ConnectionClass *self, int rollback_type, BOOL ignore_abort
 	return ret;
 }
 
+/*
+ *	Finish the asynchronous executions of the statements, e.g. before
+ *	the connection is closed.
+ */
+void
+CC_complete_async_execs(ConnectionClass *self)
+{
+	int		i;
+	StatementClass	*stmt;
+
+	for (i = 0; i < self->num_stmts; i++)
+	{
+		if (NULL != (stmt = self->stmts[i]) && SC_async_executing(stmt))
+		{
+			ENTER_STMT_CS(stmt);
+			SC_complete_async_exec(stmt);
+			LEAVE_STMT_CS(stmt);
+		}
+	}
+}
+
+/*
+ *	Read all the rest of the rows of the streaming result into its
+ *	tuple cache (spilling to a file, see QR_read_streaming_rows()), and
+ *	receive the result of the FETCH sent in advance, so that the
+ *	connection can be used for other queries.
+ */
+void
+CC_finish_pending_rows(ConnectionClass *self)
+{
+	QResultClass	*res;
+	PGresult	*pgres;
+	int		func_cs_count = 0;
+
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	/* the owner of the asynchronous execution reads its result later */
+	if (NULL != self->async_stmt)
+		SC_wait_async_exec(self->async_stmt);
+	if (NULL != (res = self->streaming_res))
+	{
+		MYLOG(0, "reading the rest of the rows of %p\n", res);
+		if (!QR_read_streaming_rows(res, 0))
+			MYLOG(0, "error while reading the rows: %s\n", SAFE_STR(QR_get_message(res)));
+	}
+	if (NULL != (res = self->prefetch_res))
+	{
+		/* The rows are read into the tuple cache by QR_next_tuple() */
+		MYLOG(0, "receiving the prefetched rows of %p\n", res);
+		self->prefetch_res = NULL;
+		while (self->pqconn && (pgres = PQgetResult(self->pqconn)) != NULL)
+		{
+			if (NULL == res->prefetched)
+				res->prefetched = pgres;
+			else
+				PQclear(pgres);
+		}
+		LIBPQ_update_transaction_status(self);
+	}
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+}
+
 /*
  *	The "result_in" is only used by QR_next_tuple() to fetch another group of rows into
  *	the same existing QResultClass (this occurs when the tuple cache is depleted and
@@ -1778,7 +1905,7 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 		create_keyset = ((flag & CREATE_KEYSET) != 0),
 		issue_begin = ((flag & GO_INTO_TRANSACTION) != 0 && !CC_is_in_trans(self)),
 		rollback_on_error, query_rollback, end_with_commit,
-		read_only, prepend_savepoint = FALSE,
+		read_only, prepend_savepoint = FALSE, stream_rows,
 		ignore_roundtrip_time = ((self->connInfo.extra_opts & BIT_IGNORE_ROUND_TRIP_TIME) != 0);
 
 	char		*ptr;
@@ -1826,6 +1953,7 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 		CLEANUP_FUNC_CONN_CS(func_cs_count, self);
 		return rhold;
 	}
+	CC_finish_pending_rows(self);
 
 	/*
 	 *	In case the round trip time can be ignored, the query
@@ -1924,6 +2052,13 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Couldn't alloc buffer for query.", "");
 		goto cleanup;
 	}
+	/*
+	 * The rows of a single query are left in the connection and read as
+	 * they are fetched, only when nothing else has to be read after them.
+	 */
+	stream_rows = ((flag & STREAM_ROWS) != 0 && NULL != stmt &&
+		NULL == qi && NULL == appendq && !create_keyset &&
+		!issue_begin && !query_rollback && !prepend_savepoint);
 
 	/* Set up notice receiver */
 	nrarg.conn = self;
@@ -1940,7 +2075,8 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 		CC_set_error(self, CONNECTION_COMMUNICATION_ERROR, errmsg, func);
 		goto cleanup;
 	}
-	PQsetSingleRowMode(self->pqconn);
+	if (!CC_set_rows_mode(self))
+		PQsetSingleRowMode(self->pqconn);
 
 	cmdres = qi ? qi->result_in : NULL;
 	if (cmdres)
@@ -2054,7 +2190,13 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 				 */
 				else if (strnicmp(cmdbuffer, "DROP TABLE", 10) == 0 ||
 						 strnicmp(cmdbuffer, "ALTER TABLE", 11) == 0)
+				{
 					CC_clear_col_info(self, FALSE);
+					reset_rules_table(self);
+				}
+				else if (strnicmp(cmdbuffer, "CREATE RULE", 11) == 0 ||
+						 strnicmp(cmdbuffer, "DROP RULE", 9) == 0)
+					reset_rules_table(self);
 				else
 				{
 					ptr = strrchr(cmdbuffer, ' ');
@@ -2062,11 +2204,14 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 						res->recent_processed_row_count = atoi(ptr + 1);
 					else
 						res->recent_processed_row_count = -1;
-					if (self->current_schema_valid &&
+					if ((self->current_schema_valid || self->rules_table) &&
 						strnicmp(cmdbuffer, "SET", 3) == 0)
 					{
 						if (is_setting_search_path(query))
+						{
 							reset_current_schema(self);
+							reset_rules_table(self);
+						}
 					}
 				}
 
@@ -2099,6 +2244,9 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 			case PGRES_TUPLES_OK:
 				QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(pgres));
 			case PGRES_SINGLE_TUPLE:
+#ifdef	LIBPQ_HAS_CHUNK_MODE
+			case PGRES_TUPLES_CHUNK:
+#endif /* LIBPQ_HAS_CHUNK_MODE */
 				if (query_completed)
 				{
 					QR_concat(res, QR_Constructor());
@@ -2144,8 +2292,21 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 						if (cursor && cursor[0])
 							QR_set_synchronize_keys(res);
 					}
+					if (stream_rows && res == cmdres)
+					{
+						QR_set_streaming(res);
+						res->cache_size = self->connInfo.drivers.fetch_max;
+					}
 					if (CC_from_PGresult(res, stmt, self, cursor, &pgres))
+					{
 						query_completed = TRUE;
+						if (QR_stream_pending(res))
+						{
+							MYLOG(0, " streaming the rows of res = %p\n", res);
+							ReadyToReturn = TRUE;
+							retres = cmdres;
+						}
+					}
 					else
 					{
 						aborted = TRUE;
@@ -2227,6 +2388,9 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 			PQclear(pgres);
 			pgres = NULL;
 		}
+		/* the rest of the results are read by QR_read_streaming_rows() */
+		if (NULL != self->streaming_res)
+			break;
 	}
 
 cleanup:
@@ -2406,6 +2570,7 @@ CC_send_function(ConnectionClass *self, const char *fn_name, void *result_buf, i
 	/* Finish the pending extended query first */
 #define	return DONT_CALL_RETURN_FROM_HERE???
 	ENTER_INNER_CONN_CS(self, func_cs_count);
+	CC_finish_pending_rows(self);
 
 	SPRINTF_FIXED(sqlbuffer, "SELECT pg_catalog.%s%s", fn_name,
 			 func_param_str[nargs]);
@@ -2653,6 +2818,53 @@ CC_get_current_schema(ConnectionClass *conn)
 	return (const char *) conn->current_schema;
 }
 
+/*
+ *	Does the table, as written in a statement, have INSERT rules ?
+ *	The answer for the last table asked is kept until a rule is
+ *	created or dropped, a table is dropped or altered, or the
+ *	search_path is set. TRUE is returned when it can't be told.
+ */
+BOOL
+CC_has_insert_rules(ConnectionClass *conn, const char *table, size_t tablelen)
+{
+	QResultClass	*res;
+	char		*escaped;
+	PQExpBufferData	query = {0};
+	BOOL		has_rules = TRUE;
+
+	if (conn->rules_table &&
+		strlen(conn->rules_table) == tablelen &&
+		strncmp(conn->rules_table, table, tablelen) == 0)
+		return conn->rules_table_has_rules;
+	reset_rules_table(conn);
+	if (NULL == (escaped = identifierEscape((const SQLCHAR *) table, tablelen, conn, NULL, -1, FALSE)))
+		return TRUE;
+	initPQExpBuffer(&query);
+	printfPQExpBuffer(&query,
+		"select count(*) from pg_catalog.pg_rewrite"
+		" where ev_class = '%s'::regclass and ev_type = '3'", escaped);
+	free(escaped);
+	if (PQExpBufferDataBroken(query))
+		return TRUE;
+	res = CC_send_query(conn, query.data, NULL, ROLLBACK_ON_ERROR | IGNORE_ABORT_ON_CONN | READ_ONLY_QUERY, NULL);
+	if (QR_command_maybe_successful(res) &&
+		QR_get_num_total_tuples(res) == 1)
+	{
+		has_rules = (0 != atoi(QR_get_value_backend_text(res, 0, 0)));
+		if (NULL != (conn->rules_table = malloc(tablelen + 1)))
+		{
+			memcpy(conn->rules_table, table, tablelen);
+			conn->rules_table[tablelen] = '\0';
+			conn->rules_table_has_rules = (char) has_rules;
+		}
+	}
+	QR_Destructor(res);
+	termPQExpBuffer(&query);
+	MYLOG(0, "%.*s has_rules=%d\n", (int) tablelen, table, has_rules);
+
+	return has_rules;
+}
+
 int	CC_mark_a_object_to_discard(ConnectionClass *conn, int type, const char *plan)
 {
 	int	cnt = conn->num_discardp + 1, plansize;
@@ -2694,6 +2906,353 @@ int	CC_discard_marked_objects(ConnectionClass *conn)
 	return 1;
 }
 
+/*
+ *	The cache of server-side prepared statements.
+ *
+ *	The statements of a connection which prepare the same query with the
+ *	same parameter types share one named plan and its description. When
+ *	the cache is full, the least recently used plan which no statement
+ *	uses is deallocated. The entries move when the cache changes, so a
+ *	pointer to an entry is valid only until the next CC_add_plan() or
+ *	CC_remove_plan().
+ */
+static BOOL
+plan_matches(const PlanCacheEntry *entry, const char *query, Int2 num_params, const OID *param_types)
+{
+	if (entry->num_params != num_params ||
+		strcmp(entry->query, query) != 0)
+		return FALSE;
+	return (num_params <= 0 ||
+			0 == memcmp(entry->param_types, param_types, sizeof(OID) * num_params));
+}
+
+PlanCacheEntry *
+CC_lookup_plan(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types)
+{
+	PlanCacheEntry	*entry;
+	int	i;
+
+	for (i = 0, entry = conn->plan_cache; i < conn->num_plans; i++, entry++)
+	{
+		if (plan_matches(entry, query, num_params, param_types))
+		{
+			entry->refcnt++;
+			entry->last_used = ++conn->plan_cache_clock;
+			conn->plan_cache_hits++;
+			MYLOG(0, "hit %s refcnt=%d\n", entry->plan_name, entry->refcnt);
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Add an entry for a plan about to be prepared. Returns NULL if the
+ * cache is disabled or full of plans in use.
+ */
+PlanCacheEntry *
+CC_add_plan(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types)
+{
+	PlanCacheEntry	*entry, *victim = NULL;
+	int	i, cache_size = conn->connInfo.plan_cache_size;
+
+	if (cache_size <= 0)
+		return NULL;
+	conn->plan_cache_misses++;
+	/* the size may have been reduced */
+	while (conn->num_plans >= cache_size)
+	{
+		victim = NULL;
+		for (i = 0, entry = conn->plan_cache; i < conn->num_plans; i++, entry++)
+		{
+			if (entry->refcnt > 0)
+				continue;
+			if (NULL == victim || entry->last_used < victim->last_used)
+				victim = entry;
+		}
+		if (NULL == victim)
+		{
+			MYLOG(0, "all the %d plans are in use\n", conn->num_plans);
+			return NULL;
+		}
+		MYLOG(0, "evicting %s\n", victim->plan_name);
+		if (CONN_CONNECTED == conn->status)
+		{
+			if (CC_is_in_error_trans(conn))
+				CC_mark_a_object_to_discard(conn, 's', victim->plan_name);
+			else
+			{
+				QResultClass	*res;
+				char		cmd[64];
+
+				SPRINTF_FIXED(cmd, "DEALLOCATE \"%s\"", victim->plan_name);
+				res = CC_send_query(conn, cmd, NULL, IGNORE_ABORT_ON_CONN | ROLLBACK_ON_ERROR, NULL);
+				QR_Destructor(res);
+			}
+		}
+		CC_remove_plan(conn, victim);
+	}
+	if (conn->num_plans >= conn->plan_cache_alloc)
+	{
+		int	alloc = conn->plan_cache_alloc > 0 ? conn->plan_cache_alloc * 2 : 16;
+
+		if (alloc > cache_size)
+			alloc = cache_size;
+		if (alloc <= conn->num_plans)
+			alloc = conn->num_plans + 1;
+		if (entry = realloc(conn->plan_cache, sizeof(PlanCacheEntry) * alloc), NULL == entry)
+			return NULL;
+		conn->plan_cache = entry;
+		conn->plan_cache_alloc = alloc;
+	}
+	entry = conn->plan_cache + conn->num_plans;
+	memset(entry, 0, sizeof(PlanCacheEntry));
+	if (NULL == (entry->query = strdup(query)))
+		return NULL;
+	if (num_params > 0)
+	{
+		if (NULL == (entry->param_types = malloc(sizeof(OID) * num_params)))
+		{
+			free(entry->query);
+			return NULL;
+		}
+		memcpy(entry->param_types, param_types, sizeof(OID) * num_params);
+	}
+	entry->num_params = num_params;
+	entry->refcnt = 1;
+	entry->last_used = ++conn->plan_cache_clock;
+	SPRINTF_FIXED(entry->plan_name, "_PLAN_C%u", entry->last_used);
+	conn->num_plans++;
+	MYLOG(0, "added %s num_plans=%d\n", entry->plan_name, conn->num_plans);
+
+	return entry;
+}
+
+/*
+ * Remove an entry from the cache. The plan is not deallocated here.
+ */
+void
+CC_remove_plan(ConnectionClass *conn, PlanCacheEntry *entry)
+{
+	PlanCacheEntry	*last = conn->plan_cache + conn->num_plans - 1;
+
+	if (entry->query)
+		free(entry->query);
+	if (entry->param_types)
+		free(entry->param_types);
+	if (entry->desc)
+		PQclear(entry->desc);
+	if (entry != last)
+		*entry = *last;
+	conn->num_plans--;
+}
+
+/*
+ * A statement stops using a plan. Returns FALSE if the plan isn't in the
+ * cache.
+ */
+BOOL
+CC_release_plan(ConnectionClass *conn, const char *plan_name)
+{
+	PlanCacheEntry	*entry;
+	int	i;
+
+	if (NULL == plan_name)
+		return FALSE;
+	for (i = 0, entry = conn->plan_cache; i < conn->num_plans; i++, entry++)
+	{
+		if (strcmp(entry->plan_name, plan_name) == 0)
+		{
+			if (entry->refcnt > 0)
+				entry->refcnt--;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/*
+ * Forget all the plans when the connection is closed.
+ */
+void
+CC_clear_plan_cache(ConnectionClass *conn)
+{
+	while (conn->num_plans > 0)
+		CC_remove_plan(conn, conn->plan_cache);
+	if (conn->plan_cache)
+		free(conn->plan_cache);
+	conn->plan_cache = NULL;
+	conn->plan_cache_alloc = 0;
+}
+
+/*
+ *	The cache of processed statements.
+ *
+ *	Processing a statement for server-side prepare converts the ODBC
+ *	escapes, replaces the parameter markers with $n and splits it into
+ *	commands. The result only depends on the statement, the way it is
+ *	processed ('flags') and the types of its parameters, so statements
+ *	executed again copy the commands from here instead. The least recently
+ *	used entry is dropped when the cache is full.
+ */
+static void
+free_processed_chain(ProcessedStmt *pstmt)
+{
+	ProcessedStmt	*next;
+
+	for (; pstmt; pstmt = next)
+	{
+		next = pstmt->next;
+		free(pstmt->query);
+		free(pstmt);
+	}
+}
+
+static void
+remove_processed(ConnectionClass *conn, StmtCacheEntry *entry)
+{
+	StmtCacheEntry	*last = conn->stmt_cache + conn->num_cached_stmts - 1;
+
+	free(entry->statement);
+	if (entry->param_sig)
+		free(entry->param_sig);
+	free_processed_chain(entry->processed);
+	if (entry != last)
+		*entry = *last;
+	conn->num_cached_stmts--;
+}
+
+const StmtCacheEntry *
+CC_lookup_processed(ConnectionClass *conn, const char *statement, UInt4 flags, Int2 num_params, const Int4 *param_sig)
+{
+	StmtCacheEntry	*entry;
+	int	i;
+
+	for (i = 0, entry = conn->stmt_cache; i < conn->num_cached_stmts; i++, entry++)
+	{
+		if (entry->flags != flags ||
+			entry->num_params != num_params ||
+			strcmp(entry->statement, statement) != 0)
+			continue;
+		if (num_params > 0 &&
+			0 != memcmp(entry->param_sig, param_sig, sizeof(Int4) * num_params))
+			continue;
+		entry->last_used = ++conn->stmt_cache_clock;
+		return entry;
+	}
+
+	return NULL;
+}
+
+/*
+ * Look up the statement by its text only, for the statement type and the
+ * parameter counts of a statement processed before with any parameter
+ * types, so that it needn't be scanned again.
+ */
+BOOL
+CC_lookup_scanned(ConnectionClass *conn, const char *statement, Int2 *statement_type, Int2 *num_params, po_ind_t *multi_statement)
+{
+	StmtCacheEntry	*entry;
+	UInt4	flags;
+	BOOL	found = FALSE;
+	int	i;
+
+	if (conn->connInfo.stmt_cache_size <= 0)
+		return FALSE;
+	flags = (CC_get_escape(conn) ? STMT_CACHE_ESCAPE : 0) |
+			((UInt4) conn->ccsc << STMT_CACHE_CCSC_SHIFT);
+	/* not necessarily called in the connection's critical section */
+	ENTER_CONN_CS(conn);
+	for (i = 0, entry = conn->stmt_cache; i < conn->num_cached_stmts; i++, entry++)
+	{
+		if ((entry->flags & STMT_CACHE_SCAN_FLAGS) != flags ||
+			strcmp(entry->statement, statement) != 0)
+			continue;
+		entry->last_used = ++conn->stmt_cache_clock;
+		*statement_type = entry->statement_type;
+		*num_params = entry->num_params;
+		*multi_statement = entry->multi_statement;
+		found = TRUE;
+		break;
+	}
+	LEAVE_CONN_CS(conn);
+
+	return found;
+}
+
+/*
+ * Add the commands 'processed' from the statement to the cache, which
+ * takes the ownership of them.
+ */
+void
+CC_add_processed(ConnectionClass *conn, const char *statement, UInt4 flags, Int2 num_params, const Int4 *param_sig, Int2 statement_type, po_ind_t multi_statement, ProcessedStmt *processed)
+{
+	StmtCacheEntry	*entry, *victim;
+	int	i, cache_size = conn->connInfo.stmt_cache_size;
+
+	if (cache_size <= 0)
+		goto cleanup;
+	/* the size may have been reduced */
+	while (conn->num_cached_stmts >= cache_size)
+	{
+		victim = conn->stmt_cache;
+		for (i = 1, entry = conn->stmt_cache + 1; i < conn->num_cached_stmts; i++, entry++)
+		{
+			if (entry->last_used < victim->last_used)
+				victim = entry;
+		}
+		remove_processed(conn, victim);
+	}
+	if (conn->num_cached_stmts >= conn->stmt_cache_alloc)
+	{
+		int	alloc = conn->stmt_cache_alloc > 0 ? conn->stmt_cache_alloc * 2 : 16;
+
+		if (alloc > cache_size)
+			alloc = cache_size;
+		if (entry = realloc(conn->stmt_cache, sizeof(StmtCacheEntry) * alloc), NULL == entry)
+			goto cleanup;
+		conn->stmt_cache = entry;
+		conn->stmt_cache_alloc = alloc;
+	}
+	entry = conn->stmt_cache + conn->num_cached_stmts;
+	memset(entry, 0, sizeof(StmtCacheEntry));
+	if (NULL == (entry->statement = strdup(statement)))
+		goto cleanup;
+	if (num_params > 0)
+	{
+		if (NULL == (entry->param_sig = malloc(sizeof(Int4) * num_params)))
+		{
+			free(entry->statement);
+			goto cleanup;
+		}
+		memcpy(entry->param_sig, param_sig, sizeof(Int4) * num_params);
+	}
+	entry->flags = flags;
+	entry->num_params = num_params;
+	entry->statement_type = statement_type;
+	entry->multi_statement = multi_statement;
+	entry->processed = processed;
+	entry->last_used = ++conn->stmt_cache_clock;
+	conn->num_cached_stmts++;
+	MYLOG(0, "cached %d statements\n", conn->num_cached_stmts);
+	return;
+cleanup:
+	free_processed_chain(processed);
+}
+
+void
+CC_clear_stmt_cache(ConnectionClass *conn)
+{
+	while (conn->num_cached_stmts > 0)
+		remove_processed(conn, conn->stmt_cache);
+	if (conn->stmt_cache)
+		free(conn->stmt_cache);
+	conn->stmt_cache = NULL;
+	conn->stmt_cache_alloc = 0;
+}
+
 static void
 LIBPQ_update_transaction_status(ConnectionClass *self)
 {
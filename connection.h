@@ -258,6 +258,39 @@ enum {
 }
 #define col_info_initialize(coli) (memset(coli, 0, sizeof(COL_INFO)))
 
+/*	An entry of the cache of server-side prepared statements */
+typedef struct
+{
+	char		*query;		/* the query sent to the server */
+	Int2		num_params;
+	OID		*param_types;
+	char		plan_name[32];
+	PGresult	*desc;		/* the result of PQdescribePrepared() */
+	Int4		refcnt;		/* the number of statements using it */
+	UInt4		last_used;
+}	PlanCacheEntry;
+
+/*	An entry of the cache of statements processed for server-side prepare */
+typedef struct
+{
+	char		*statement;	/* the original statement */
+	UInt4		flags;		/* how it was processed */
+	Int2		num_params;
+	Int4		*param_sig;	/* the parameter types it was processed with */
+	struct ProcessedStmt *processed;	/* the commands and their parameter counts */
+	Int2		statement_type;
+	po_ind_t	multi_statement;
+	UInt4		last_used;
+}	StmtCacheEntry;
+
+/*	StmtCacheEntry.flags */
+#define	STMT_CACHE_PARAM_CAST		1L
+#define	STMT_CACHE_DISCARD_OUTPUT	(1L << 1)
+#define	STMT_CACHE_ESCAPE		(1L << 2)
+#define	STMT_CACHE_CCSC_SHIFT		8
+/*	the flags the scanning of the statement depends on */
+#define	STMT_CACHE_SCAN_FLAGS	(STMT_CACHE_ESCAPE | (~0U << STMT_CACHE_CCSC_SHIFT))
+
  /* Translation DLL entry points */
 #ifdef WIN32
 #define DLLHANDLE HINSTANCE
@@ -333,9 +366,25 @@ struct ConnectionClass_
 	SQLUINTEGER	server_isolation;	/* isolation at server initially unknown */
 	char		*current_schema;
 	StatementClass *unnamed_prepared_stmt;
+	QResultClass	*streaming_res;	/* the result whose rows are being read */
+	QResultClass	*prefetch_res;	/* the result whose next FETCH is in flight */
+	StatementClass	*async_stmt;	/* the statement executing asynchronously */
+	SQLULEN		result_memory;	/* the memory the results hold, see QR_account_memory() */
 	Int2		max_identifier_length;
 	Int2		num_discardp;
 	char		**discardp;
+	PlanCacheEntry	*plan_cache;
+	Int4		num_plans;
+	Int4		plan_cache_alloc;
+	UInt4		plan_cache_clock;	/* also names the plans */
+	UInt4		plan_cache_hits;
+	UInt4		plan_cache_misses;
+	StmtCacheEntry	*stmt_cache;
+	Int4		num_cached_stmts;
+	Int4		stmt_cache_alloc;
+	UInt4		stmt_cache_clock;
+	char		*rules_table;	/* the table CC_has_insert_rules() looked up last */
+	char		rules_table_has_rules;
 	int		num_descs;
 	SQLUINTEGER	default_isolation;	/* server's default isolation initially unkown */
 	DescriptorClass	**descs;
@@ -404,6 +453,7 @@ enum {
 ConnectionClass *CC_Constructor(void);
 char		CC_Destructor(ConnectionClass *self);
 int		CC_cursor_count(ConnectionClass *self);
+SQLULEN		CC_get_result_memory(ConnectionClass *self, const QResultClass *exclude);
 char		CC_cleanup(ConnectionClass *self, BOOL keepCommunication);
 char		CC_begin(ConnectionClass *self);
 char		CC_commit(ConnectionClass *self);
@@ -421,6 +471,8 @@ void		CC_set_errormsg(ConnectionClass *self, const char *message);
 char		CC_get_error(ConnectionClass *self, int *number, char **message);
 QResultHold CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UDWORD flag, StatementClass *stmt, const char *appendq);
 #define CC_send_query(self, query, qi, flag, stmt) CC_send_query_append(self, query, qi, flag, stmt, NULL).first
+void		CC_complete_async_execs(ConnectionClass *self);
+void		CC_finish_pending_rows(ConnectionClass *self);
 void		handle_pgres_error(ConnectionClass *self, const PGresult *pgres,
 				   const char *comment,
 				   QResultClass *res, BOOL error_not_a_notice);
@@ -435,8 +487,18 @@ void		CC_on_abort(ConnectionClass *conn, unsigned int opt);
 void		CC_on_abort_partial(ConnectionClass *conn);
 void		ProcessRollback(ConnectionClass *conn, BOOL undo, BOOL partial);
 const char	*CC_get_current_schema(ConnectionClass *conn);
+BOOL		CC_has_insert_rules(ConnectionClass *conn, const char *table, size_t tablelen);
 int             CC_mark_a_object_to_discard(ConnectionClass *conn, int type, const char *plan);
 int             CC_discard_marked_objects(ConnectionClass *conn);
+PlanCacheEntry	*CC_lookup_plan(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types);
+PlanCacheEntry	*CC_add_plan(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types);
+void		CC_remove_plan(ConnectionClass *conn, PlanCacheEntry *entry);
+BOOL		CC_release_plan(ConnectionClass *conn, const char *plan_name);
+void		CC_clear_plan_cache(ConnectionClass *conn);
+const StmtCacheEntry	*CC_lookup_processed(ConnectionClass *conn, const char *statement, UInt4 flags, Int2 num_params, const Int4 *param_sig);
+BOOL		CC_lookup_scanned(ConnectionClass *conn, const char *statement, Int2 *statement_type, Int2 *num_params, po_ind_t *multi_statement);
+void		CC_add_processed(ConnectionClass *conn, const char *statement, UInt4 flags, Int2 num_params, const Int4 *param_sig, Int2 statement_type, po_ind_t multi_statement, struct ProcessedStmt *processed);
+void		CC_clear_stmt_cache(ConnectionClass *conn);
 
 int		CC_get_max_idlen(ConnectionClass *self);
 char	CC_get_escape(const ConnectionClass *self);
@@ -478,6 +540,7 @@ enum {
 	,ROLLBACK_ON_ERROR	= (1L << 3) /* rollback the query when an error occurs */
 	,END_WITH_COMMIT	= (1L << 4) /* the query ends with COMMIT command */
 	,READ_ONLY_QUERY	= (1L << 5) /* the query is read-only */
+	,STREAM_ROWS		= (1L << 6) /* read the rows as they are fetched */
 };
 /* CC_on_abort options */
 #define	NO_TRANS		1L
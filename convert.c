@@ -21,7 +21,6 @@
 #include "unicode_support.h"
 #include "misc.h"
 #ifdef	WIN32
-#include <float.h>
 #define	HAVE_LOCALE_H
 #endif /* WIN32 */
 
@@ -36,6 +35,7 @@
 #include <locale.h>
 #endif
 #include <math.h>
+#include <float.h>
 #include <stdlib.h>
 #include <limits.h>
 #include "statement.h"
@@ -269,8 +269,188 @@ static unsigned ODBCINT64 ATOI64U(const char *val)
 #endif /* WIN32 */
 #endif /* ODBCINT64 */
 
+/*
+ * The mantissa of SQL_NUMERIC_STRUCT is a 128-bit integer; with a
+ * compiler which has the type, the conversions work on it directly
+ * instead of digit by digit over the bytes.
+ */
+#if defined(__SIZEOF_INT128__)
+#define	NUMERIC_UINT128
+typedef unsigned __int128	numeric_uint128;
+#endif /* __SIZEOF_INT128__ */
+
 static void ResolveNumericParam(const SQL_NUMERIC_STRUCT *ns, char *chrform);
 static void parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL *overflow);
+#ifdef	NUMERIC_UINT128
+static BOOL numeric_binary2struct(const char *value, SQL_NUMERIC_STRUCT *ns);
+#endif /* NUMERIC_UINT128 */
+
+/*
+ *	Hand-written parsers/formatters of the fixed formats the server
+ *	uses with DateStyle ISO. They handle the usual values only and
+ *	return FALSE (or -1) for the others, which are left to the general
+ *	sscanf()/snprintf() ones below.
+ */
+#define	IS_DIGIT(c)	((unsigned) ((c) - '0') < 10)
+#define	DIGITS2(p)	(((p)[0] - '0') * 10 + ((p)[1] - '0'))
+
+/* YYYY-MM-DD at the top of str, which sscanf("%4d-%2d-%2d") would read */
+static BOOL
+parse_iso_date(const char *str, SIMPLE_TIME *st)
+{
+	if (!IS_DIGIT(str[0]) || !IS_DIGIT(str[1]) ||
+	    !IS_DIGIT(str[2]) || !IS_DIGIT(str[3]) || '-' != str[4] ||
+	    !IS_DIGIT(str[5]) || !IS_DIGIT(str[6]) || '-' != str[7] ||
+	    !IS_DIGIT(str[8]) || !IS_DIGIT(str[9]))
+		return FALSE;
+	st->y = DIGITS2(str) * 100 + DIGITS2(str + 2);
+	st->m = DIGITS2(str + 5);
+	st->d = DIGITS2(str + 8);
+	return TRUE;
+}
+
+/*
+ *	YYYY-MM-DD
+ *	[YYYY-MM-DD ]HH:MM:SS[.fffffffff][{+|-}HH[:MM[:SS]]][ BC]
+ *
+ *	st is changed only when TRUE is returned.
+ */
+static BOOL
+parse_iso_datetime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
+{
+	const char	*p = str;
+	SIMPLE_TIME	dt;
+	int		hh, mm, ss, fr = 0, zh = 0, i;
+	BOOL		has_date = FALSE, has_zone = FALSE, bc = FALSE;
+
+	if (parse_iso_date(p, &dt))
+	{
+		p += 10;
+		if ('\0' == *p)		/* date */
+		{
+			st->y = dt.y;
+			st->m = dt.m;
+			st->d = dt.d;
+			st->hh = 0;
+			st->mm = 0;
+			st->ss = 0;
+			return TRUE;
+		}
+		if (' ' != *p++)
+			return FALSE;
+		has_date = TRUE;
+	}
+	if (!IS_DIGIT(p[0]) || !IS_DIGIT(p[1]) || ':' != p[2] ||
+	    !IS_DIGIT(p[3]) || !IS_DIGIT(p[4]) || ':' != p[5] ||
+	    !IS_DIGIT(p[6]) || !IS_DIGIT(p[7]))
+		return FALSE;
+	hh = DIGITS2(p);
+	mm = DIGITS2(p + 3);
+	ss = DIGITS2(p + 6);
+	p += 8;
+	if ('.' == *p)
+	{
+		for (p++, i = 0; IS_DIGIT(*p); p++, i++)
+		{
+			if (i >= 9)
+				return FALSE;
+			fr = fr * 10 + (*p - '0');
+		}
+		if (0 == i)
+			return FALSE;
+		for (; i < 9; i++)
+			fr *= 10;
+	}
+	if ('+' == *p || '-' == *p)
+	{
+		if (!IS_DIGIT(p[1]) || !IS_DIGIT(p[2]))
+			return FALSE;
+		zh = ('-' == *p ? -DIGITS2(p + 1) : DIGITS2(p + 1));
+		p += 3;
+		/* the minutes and seconds of the offset are ignored */
+		for (i = 0; i < 2 && ':' == *p; i++, p += 3)
+		{
+			if (!IS_DIGIT(p[1]) || !IS_DIGIT(p[2]))
+				return FALSE;
+		}
+		has_zone = TRUE;
+	}
+	if (has_date && ' ' == p[0] && 'B' == p[1] && 'C' == p[2])
+	{
+		bc = TRUE;
+		p += 3;
+	}
+	if ('\0' != *p)
+		return FALSE;
+
+	if (has_date)
+	{
+		st->y = bc ? -dt.y : dt.y;
+		st->m = dt.m;
+		st->d = dt.d;
+	}
+	st->hh = hh;
+	st->mm = mm;
+	st->ss = ss;
+	st->fr = fr;
+	*bZone = has_zone;
+	*zone = zh;
+	return TRUE;
+}
+
+/*
+ *	YYYY-MM-DD HH:MM:SS<precstr><zonestr>[ BC] as snprintf() with
+ *	"%.4d-%.2d-%.2d %.2d:%.2d:%.2d%s%s" would, or -1 if a field doesn't
+ *	fit in its width or the result doesn't fit in str.
+ */
+static int
+format_iso_datetime(char *str, size_t bufsize, const SIMPLE_TIME *st,
+		const char *precstr, const char *zonestr)
+{
+	char	buf[64], *p = buf;
+	int	y;
+	size_t	len;
+
+	if (st->y < -9999 || st->y > 9999 ||
+	    st->m < 0 || st->m > 99 || st->d < 0 || st->d > 99 ||
+	    st->hh < 0 || st->hh > 99 || st->mm < 0 || st->mm > 99 ||
+	    st->ss < 0 || st->ss > 99)
+		return -1;
+	y = st->y < 0 ? -st->y : st->y;
+	*p++ = '0' + y / 1000;
+	*p++ = '0' + y / 100 % 10;
+	*p++ = '0' + y / 10 % 10;
+	*p++ = '0' + y % 10;
+#define	PUT_DIGITS2(sep, v) \
+	do { \
+		*p++ = (sep); \
+		*p++ = '0' + (v) / 10; \
+		*p++ = '0' + (v) % 10; \
+	} while (0)
+	PUT_DIGITS2('-', st->m);
+	PUT_DIGITS2('-', st->d);
+	PUT_DIGITS2(' ', st->hh);
+	PUT_DIGITS2(':', st->mm);
+	PUT_DIGITS2(':', st->ss);
+#undef	PUT_DIGITS2
+	len = strlen(precstr);
+	memcpy(p, precstr, len);
+	p += len;
+	len = strlen(zonestr);
+	memcpy(p, zonestr, len);
+	p += len;
+	if (st->y < 0)
+	{
+		memcpy(p, " BC", 3);
+		p += 3;
+	}
+	len = p - buf;
+	if (len >= bufsize)
+		return -1;
+	memcpy(str, buf, len);
+	str[len] = '\0';
+	return (int) len;
+}
 
 /*
  *	TIMESTAMP <-----> SIMPLE_TIME
@@ -294,6 +474,8 @@ timestamp2stime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
 	*zone = 0;
 	st->fr = 0;
 	st->infinity = 0;
+	if (parse_iso_datetime(str, st, bZone, zone))
+		goto adjust_zone;
 	rest[0] = '\0';
 	bc[0] = '\0';
 	if ((scnt = sscanf(str, "%4d-%2d-%2d %2d:%2d:%2d%31s %15s", &y, &m, &d, &hh, &mm, &ss, rest, bc)) < 6)
@@ -374,6 +556,7 @@ timestamp2stime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
 	{
 		st->y *= -1;
 	}
+adjust_zone:
 	if (!withZone || !*bZone || st->y < 1970)
 		return TRUE;
 #ifdef	TIMEZONE_GLOBAL
@@ -445,7 +628,17 @@ stime2timestamp(const SIMPLE_TIME *st, char *str, size_t bufsize, BOOL bZone,
 	}
 	if (precision > 0 && st->fr)
 	{
-		SPRINTF_FIXED(precstr, ".%09d", st->fr);
+		if (st->fr > 0 && st->fr <= 999999999)
+		{
+			int	fr = st->fr;
+
+			precstr[0] = '.';
+			for (i = 9; i > 0; i--, fr /= 10)
+				precstr[i] = '0' + fr % 10;
+			precstr[10] = '\0';
+		}
+		else
+			SPRINTF_FIXED(precstr, ".%09d", st->fr);
 		if (precision < 9)
 			precstr[precision + 1] = '\0';
 		else if (precision > 9)
@@ -487,6 +680,8 @@ stime2timestamp(const SIMPLE_TIME *st, char *str, size_t bufsize, BOOL bZone,
 			SPRINTF_FIXED(zonestr, "+%02d", -(int) zoneint / 3600);
 	}
 #endif /* TIMEZONE_GLOBAL */
+	if ((i = format_iso_datetime(str, bufsize, st, precstr, zonestr)) >= 0)
+		return i;
 	if (st->y < 0)
 		return snprintf(str, bufsize, "%.4d-%.2d-%.2d %.2d:%.2d:%.2d%s%s BC", -st->y, st->m, st->d, st->hh, st->mm, st->ss, precstr, zonestr);
 	else
@@ -566,6 +761,173 @@ static int getPrecisionPart(int precision, const char * precPart)
 	return atoi(fraction);
 }
 
+/*
+ *	[-]digits as sscanf("%d") would read it. Up to 9 digits so that
+ *	the value doesn't overflow.
+ */
+static const char *
+scan_interval_int(const char *p, int *val)
+{
+	int	v = 0, i;
+	BOOL	minus = ('-' == *p);
+
+	if (minus)
+		p++;
+	for (i = 0; IS_DIGIT(*p); p++, i++)
+	{
+		if (i >= 9)
+			return NULL;
+		v = v * 10 + (*p - '0');
+	}
+	if (0 == i)
+		return NULL;
+	*val = minus ? -v : v;
+	return p;
+}
+
+/* a unit name as sscanf("%10s") would read it */
+static const char *
+scan_interval_unit(const char *p, char *unit)
+{
+	int	i;
+
+	for (i = 0; isalpha((UCHAR) *p); p++, i++)
+	{
+		if (i >= 10)
+			return NULL;
+		unit[i] = *p;
+	}
+	if (0 == i || (' ' != *p && '\0' != *p))
+		return NULL;
+	unit[i] = '\0';
+	return p;
+}
+
+/*
+ *	The usual forms of interval values
+ *
+ *		Y-M
+ *		D H:MM:SS[.fffffffff]
+ *		N unit
+ *		N unit N unit
+ *
+ *	parsed the way interval2istruct() does. Returns -1 for the others.
+ */
+static int
+parse_interval_fast(SQLINTERVAL itype, int precision, const char *str, SQL_INTERVAL_STRUCT *st)
+{
+	const char	*p;
+	char	unit1[11], unit2[11], frac[10];
+	int	n1, n2, hours, minutes, seconds, i;
+	BOOL	sign;
+
+	if (NULL == (p = scan_interval_int(str, &n1)))
+		return -1;
+	sign = n1 < 0 ? SQL_TRUE : SQL_FALSE;
+	if ('-' == *p)
+	{
+		if (!IS_DIGIT(p[1]) ||
+		    NULL == (p = scan_interval_int(p + 1, &n2)) ||
+		    '\0' != *p)
+			return -1;
+		if (SQL_IS_YEAR_TO_MONTH != itype)
+			return FALSE;
+		st->interval_type = itype;
+		st->interval_sign = sign;
+		st->intval.year_month.year = sign ? (-n1) : n1;
+		st->intval.year_month.month = n2;
+		return TRUE;
+	}
+	if (' ' != *p++)
+		return -1;
+	if (IS_DIGIT(p[0]) && (':' == p[1] || (IS_DIGIT(p[1]) && ':' == p[2])))
+	{
+		hours = *p++ - '0';
+		if (':' != *p)
+			hours = hours * 10 + (*p++ - '0');
+		if (!IS_DIGIT(p[1]) || !IS_DIGIT(p[2]) || ':' != p[3] ||
+		    !IS_DIGIT(p[4]) || !IS_DIGIT(p[5]))
+			return -1;
+		minutes = DIGITS2(p + 1);
+		seconds = DIGITS2(p + 4);
+		p += 6;
+		i = 0;
+		if ('.' == *p)
+		{
+			for (p++; IS_DIGIT(*p); p++, i++)
+			{
+				if (i >= 9)
+					return -1;
+				frac[i] = *p;
+			}
+			if (0 == i)
+				return -1;
+			frac[i] = '\0';
+		}
+		if ('\0' != *p)
+			return -1;
+		st->interval_type = itype;
+		st->interval_sign = sign;
+		st->intval.day_second.day = sign ? (-n1) : n1;
+		st->intval.day_second.hour = hours;
+		st->intval.day_second.minute = minutes;
+		st->intval.day_second.second = seconds;
+		if (i > 0)
+			st->intval.day_second.fraction = getPrecisionPart(precision, frac);
+		return TRUE;
+	}
+	if (NULL == (p = scan_interval_unit(p, unit1)))
+		return -1;
+	if ('\0' == *p)
+	{
+		if (SQL_IS_YEAR == itype &&
+		    (stricmp(unit1, "year") == 0 ||
+		     stricmp(unit1, "years") == 0))
+		{
+			st->interval_type = itype;
+			st->interval_sign = sign;
+			st->intval.year_month.year = sign ? (-n1) : n1;
+			return TRUE;
+		}
+		if (SQL_IS_MONTH == itype &&
+		    (stricmp(unit1, "mon") == 0 ||
+		     stricmp(unit1, "mons") == 0))
+		{
+			st->interval_type = itype;
+			st->interval_sign = sign;
+			st->intval.year_month.month = sign ? (-n1) : n1;
+			return TRUE;
+		}
+		if (SQL_IS_DAY == itype &&
+		    (stricmp(unit1, "day") == 0 ||
+		     stricmp(unit1, "days") == 0))
+		{
+			st->interval_type = itype;
+			st->interval_sign = sign;
+			st->intval.day_second.day = sign ? (-n1) : n1;
+			return TRUE;
+		}
+		return FALSE;
+	}
+	if (NULL == (p = scan_interval_int(p + 1, &n2)) ||
+	    ' ' != *p ||
+	    NULL == (p = scan_interval_unit(p + 1, unit2)) ||
+	    '\0' != *p)
+		return -1;
+	if (strnicmp(unit1, "year", 4) == 0 &&
+	    strnicmp(unit2, "mon", 2) == 0 &&
+	    (SQL_IS_MONTH == itype ||
+	     SQL_IS_YEAR_TO_MONTH == itype))
+	{
+		st->interval_type = itype;
+		st->interval_sign = sign;
+		st->intval.year_month.year = sign ? (-n1) : n1;
+		st->intval.year_month.month = sign ? (-n2) : n2;
+		return TRUE;
+	}
+	return FALSE;
+}
+
 static BOOL
 interval2istruct(SQLSMALLINT ctype, int precision, const char *str, SQL_INTERVAL_STRUCT *st)
 {
@@ -575,6 +937,8 @@ interval2istruct(SQLSMALLINT ctype, int precision, const char *str, SQL_INTERVAL
 	SQLINTERVAL	itype = interval2itype(ctype);
 
 	memset(st, 0, sizeof(SQL_INTERVAL_STRUCT));
+	if ((scnt = parse_interval_fast(itype, precision, str, st)) >= 0)
+		return scnt;
 	if ((scnt = sscanf(str, "%d-%d", &years, &mons)) >=2)
 	{
 		if (SQL_IS_YEAR_TO_MONTH == itype)
@@ -772,7 +1136,7 @@ static void set_client_decimal_point(char *num, BOOL) {}
 
 /*	This is called by SQLFetch() */
 int
-copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, int col)
+copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, int col, BOOL binary)
 {
 	ARDFields *opts = SC_get_ARDF(stmt);
 	BindInfoClass *bic;
@@ -782,7 +1146,7 @@ copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttyp
 		extend_column_bindings(opts, col + 1);
 	bic = &(opts->bindings[col]);
 	SC_set_current_col(stmt, -1);
-	return copy_and_convert_field(stmt, field_type, atttypmod, value,
+	return (binary ? copy_and_convert_binary_field : copy_and_convert_field)(stmt, field_type, atttypmod, value,
 		bic->returntype, bic->precision,
 		(PTR) (bic->buffer + offset), bic->buflen,
 		LENADDR_SHIFT(bic->used, offset), LENADDR_SHIFT(bic->indicator, offset));
@@ -1137,6 +1501,7 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 	GetDataClass *pgdc;
 	int	copy_len = 0, needbuflen = 0, i;
 	const char	*ptr;
+	BOOL	already_copied = FALSE;
 
 	MYLOG(0, "field_type=%u type=%d\n", field_type, fCType);
 
@@ -1158,7 +1523,20 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 		pgdc = &gdata->gdata[current_col];
 	if (pgdc->data_left < 0)
 	{
-		if (COPY_OK != (result = setup_getdataclass(&len, &ptr,
+		/*
+		 * A bytea value which fits in the buffer (with the terminator
+		 * convert_from_pgbinary() puts) is decoded into it directly.
+		 */
+		if (PG_TYPE_BYTEA == field_type && SQL_C_BINARY == fCType &&
+			cbValueMax > 0 &&
+			(len = convert_from_pgbinary(neut_str, NULL, 0)) < cbValueMax)
+		{
+			convert_from_pgbinary(neut_str, rgbValueBindRow, cbValueMax);
+			ptr = rgbValueBindRow;
+			needbuflen = len;
+			already_copied = TRUE;
+		}
+		else if (COPY_OK != (result = setup_getdataclass(&len, &ptr,
 				&needbuflen, pgdc, neut_str, field_type,
 				fCType, cbValueMax, conn)))
 			goto cleanup;
@@ -1185,7 +1563,6 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 
 	if (cbValueMax > 0)
 	{
-		BOOL	already_copied = FALSE;
 		int		terminatorlen;
 
 		terminatorlen = get_terminator_len(fCType);
@@ -1416,7 +1793,8 @@ MYLOG(0, "null_cvt_date_string=%d\n", conn->connInfo.cvt_null_date_string);
 			 * PG_TYPE_CHAR,VARCHAR $$$
 			 */
 		case PG_TYPE_DATE:
-			sscanf(value, "%4d-%2d-%2d", &std_time.y, &std_time.m, &std_time.d);
+			if (!parse_iso_date(value, &std_time))
+				sscanf(value, "%4d-%2d-%2d", &std_time.y, &std_time.m, &std_time.d);
 			break;
 
 		case PG_TYPE_TIME:
@@ -1934,67 +2312,1170 @@ MYLOG(DETAIL_LOG_LEVEL, "SQL_C_VARBOOKMARK value=%d\n", ival);
 				{
 					int rtn = char2guid(neut_str, &g);
 
-					if (COPY_OK != rtn)
-						return rtn;
-					if (pcbValue)
-						*pcbValueBindRow = sizeof(g);
-					if (cbValueMax >= sizeof(g))
-					{
-						memcpy(rgbValueBindRow, &g, sizeof(g));
-						return COPY_OK;
-					}
-					else
-						return COPY_RESULT_TRUNCATED;
-				}
-				else
-				{
-					MYLOG(0, "couldn't convert the type %d to SQL_C_BINARY\n", field_type);
-					return COPY_UNSUPPORTED_TYPE;
-				}
-				break;
-			case SQL_C_GUID:
+					if (COPY_OK != rtn)
+						return rtn;
+					if (pcbValue)
+						*pcbValueBindRow = sizeof(g);
+					if (cbValueMax >= sizeof(g))
+					{
+						memcpy(rgbValueBindRow, &g, sizeof(g));
+						return COPY_OK;
+					}
+					else
+						return COPY_RESULT_TRUNCATED;
+				}
+				else
+				{
+					MYLOG(0, "couldn't convert the type %d to SQL_C_BINARY\n", field_type);
+					return COPY_UNSUPPORTED_TYPE;
+				}
+				break;
+			case SQL_C_GUID:
+
+				result = char2guid(neut_str, &g);
+				if (COPY_OK != result)
+				{
+					MYLOG(0, "Could not convert to SQL_C_GUID\n");
+					return	COPY_UNSUPPORTED_TYPE;
+				}
+				len = sizeof(g);
+				if (bind_size > 0)
+					*((SQLGUID *) rgbValueBindRow) = g;
+				else
+					*((SQLGUID *) rgbValue + bind_row) = g;
+				break;
+			case SQL_C_INTERVAL_YEAR:
+			case SQL_C_INTERVAL_MONTH:
+			case SQL_C_INTERVAL_YEAR_TO_MONTH:
+			case SQL_C_INTERVAL_DAY:
+			case SQL_C_INTERVAL_HOUR:
+			case SQL_C_INTERVAL_DAY_TO_HOUR:
+			case SQL_C_INTERVAL_MINUTE:
+			case SQL_C_INTERVAL_HOUR_TO_MINUTE:
+			case SQL_C_INTERVAL_SECOND:
+			case SQL_C_INTERVAL_DAY_TO_SECOND:
+			case SQL_C_INTERVAL_HOUR_TO_SECOND:
+			case SQL_C_INTERVAL_MINUTE_TO_SECOND:
+				interval2istruct(fCType, precision, neut_str, bind_size > 0 ? (SQL_INTERVAL_STRUCT *) rgbValueBindRow : (SQL_INTERVAL_STRUCT *) rgbValue + bind_row);
+				break;
+
+			default:
+				MYLOG(0, "conversion to the type %d isn't supported\n", fCType);
+				return COPY_UNSUPPORTED_TYPE;
+		}
+	}
+
+	/* store the length of what was copied, if there's a place for it */
+	if (pcbValue)
+		*pcbValueBindRow = len;
+
+	if (result == COPY_OK && stmt->current_col >= 0)
+		gdata->gdata[stmt->current_col].data_left = 0;
+	return result;
+
+}
+
+/*
+ *	Values received in binary format.
+ *
+ *	The binary layouts are those of the send functions of the backend
+ *	(network byte order, integer datetimes).
+ */
+#ifndef	INT64CONST
+#define	INT64CONST(x)	(x##LL)
+#endif /* INT64CONST */
+#define	POSTGRES_EPOCH_JDATE	2451545	/* date2j(2000, 1, 1) */
+#define	USECS_PER_DAY	INT64CONST(86400000000)
+
+/*
+ * Does the driver handle the binary format of the type ?
+ */
+BOOL
+pg_binary_result_supported(OID field_type)
+{
+	switch (field_type)
+	{
+		case PG_TYPE_BOOL:
+		case PG_TYPE_INT2:
+		case PG_TYPE_INT4:
+		case PG_TYPE_INT8:
+		case PG_TYPE_OID:
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+		case PG_TYPE_NUMERIC:
+		case PG_TYPE_DATE:
+		case PG_TYPE_TIMESTAMP_NO_TMZONE:
+		case PG_TYPE_UUID:
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static UInt4
+get_binary_uint32(const char *value)
+{
+	const UCHAR	*p = (const UCHAR *) value;
+
+	return ((UInt4) p[0] << 24) | ((UInt4) p[1] << 16) | ((UInt4) p[2] << 8) | (UInt4) p[3];
+}
+
+static SQLBIGINT
+get_binary_int64(const char *value)
+{
+	return (SQLBIGINT) (((SQLUBIGINT) get_binary_uint32(value) << 32) | get_binary_uint32(value + 4));
+}
+
+static double
+get_binary_float8(const char *value)
+{
+	SQLBIGINT	ival = get_binary_int64(value);
+	double		dval;
+
+	memcpy(&dval, &ival, sizeof(dval));
+	return dval;
+}
+
+static float
+get_binary_float4(const char *value)
+{
+	UInt4	ival = get_binary_uint32(value);
+	float	fval;
+
+	memcpy(&fval, &ival, sizeof(fval));
+	return fval;
+}
+
+/* the reverse of date2j() of the backend */
+static void
+j2date(int jd, int *year, int *month, int *day)
+{
+	unsigned int julian, quad, extra;
+	int		y;
+
+	julian = jd;
+	julian += 32044;
+	quad = julian / 146097;
+	extra = (julian - quad * 146097) * 4 + 3;
+	julian += 60 + quad * 3 + extra / 146097;
+	quad = julian / 1461;
+	julian -= quad * 1461;
+	y = julian * 4 / 1461;
+	julian = ((y != 0) ? ((julian + 305) % 365) : ((julian + 306) % 366))
+		+ 123;
+	y += quad * 4;
+	*year = y - 4800;
+	quad = julian * 2141 / 65536;
+	*day = julian - 7834 * quad / 256;
+	*month = (quad + 10) % 12 + 1;
+}
+
+/*
+ * Convert a binary date or timestamp into SIMPLE_TIME.
+ * Returns FALSE for +-infinity.
+ */
+static BOOL
+binary_datetime2stime(OID field_type, const char *value, SIMPLE_TIME *st)
+{
+	SQLBIGINT	days, usecs;
+
+	memset(st, 0, sizeof(*st));
+	if (PG_TYPE_DATE == field_type)
+	{
+		Int4	date = (Int4) get_binary_uint32(value);
+
+		if (INT_MAX == date || INT_MIN == date)
+		{
+			st->infinity = (INT_MAX == date ? 1 : -1);
+			return FALSE;
+		}
+		j2date(date + POSTGRES_EPOCH_JDATE, &st->y, &st->m, &st->d);
+		return TRUE;
+	}
+	usecs = get_binary_int64(value);
+	if (usecs == (SQLBIGINT) ((~(SQLUBIGINT) 0) >> 1) || usecs == -(SQLBIGINT) ((~(SQLUBIGINT) 0) >> 1) - 1)
+	{
+		st->infinity = (usecs > 0 ? 1 : -1);
+		return FALSE;
+	}
+	days = usecs / USECS_PER_DAY;
+	usecs -= days * USECS_PER_DAY;
+	if (usecs < 0)
+	{
+		usecs += USECS_PER_DAY;
+		days--;
+	}
+	j2date((int) days + POSTGRES_EPOCH_JDATE, &st->y, &st->m, &st->d);
+	st->hh = (int) (usecs / INT64CONST(3600000000));
+	usecs -= st->hh * INT64CONST(3600000000);
+	st->mm = (int) (usecs / 60000000);
+	usecs -= st->mm * INT64CONST(60000000);
+	st->ss = (int) (usecs / 1000000);
+	st->fr = (int) (usecs % 1000000) * 1000;
+	return TRUE;
+}
+
+/*
+ * Print a float the way the backend does, i.e. with the shortest
+ * precision which reads back to the same value.
+ */
+static void
+binary_float2text(double dval, int min_digits, int max_digits, BOOL is_float4, char *buf, size_t bufsize)
+{
+	int	digits;
+
+	if (isnan(dval))
+	{
+		strncpy_null(buf, NAN_STRING, bufsize);
+		return;
+	}
+	if (isinf(dval))
+	{
+		strncpy_null(buf, dval > 0 ? INFINITY_STRING : MINFINITY_STRING, bufsize);
+		return;
+	}
+	for (digits = min_digits; digits < max_digits; digits++)
+	{
+		snprintf(buf, bufsize, "%.*g", digits, dval);
+		if (is_float4 ? (strtof(buf, NULL) == (float) dval) : (strtod(buf, NULL) == dval))
+			return;
+	}
+	snprintf(buf, bufsize, "%.*g", max_digits, dval);
+}
+
+/*
+ * The size of the buffer numeric_binary2text() needs for a binary numeric.
+ */
+static size_t
+numeric_binary_textlen(const char *value)
+{
+	const UCHAR	*p = (const UCHAR *) value;
+	int		weight = (Int2) ((p[2] << 8) | p[3]);
+	int		dscale = (p[6] << 8) | p[7];
+
+	/* sign, integer part, dot, fraction part and the terminator */
+	return 1 + (weight >= 0 ? 4 * (weight + 1) : 1) + 1 + dscale + 1;
+}
+
+/*
+ * Print a binary numeric the way numeric_out() of the backend does.
+ */
+static void
+numeric_binary2text(const char *value, char *buf)
+{
+	const UCHAR	*p = (const UCHAR *) value;
+	int		ndigits = (Int2) ((p[0] << 8) | p[1]);
+	int		weight = (Int2) ((p[2] << 8) | p[3]);
+	UInt2	sign = (p[4] << 8) | p[5];
+	int		dscale = (p[6] << 8) | p[7];
+	int		i, j, d, pos = 0;
+
+	switch (sign)
+	{
+		case 0xC000:
+			strcpy(buf, NAN_STRING);
+			return;
+		case 0xD000:
+			strcpy(buf, INFINITY_STRING);
+			return;
+		case 0xF000:
+			strcpy(buf, MINFINITY_STRING);
+			return;
+	}
+	if (0x4000 == sign)
+		buf[pos++] = '-';
+	if (weight < 0)
+		buf[pos++] = '0';
+	for (i = 0; i <= weight; i++)
+	{
+		d = (i < ndigits) ? (p[8 + 2 * i] << 8) | p[8 + 2 * i + 1] : 0;
+		for (j = 1000; j > 0; j /= 10)
+		{
+			/* no leading zeros in the first group */
+			if (0 == i && d < j && j > 1)
+				continue;
+			buf[pos++] = '0' + (d / j) % 10;
+		}
+	}
+	if (dscale > 0)
+	{
+		buf[pos++] = '.';
+		for (i = weight + 1, j = 0; j < dscale; i++)
+		{
+			int	k;
+
+			d = (i >= 0 && i < ndigits) ? (p[8 + 2 * i] << 8) | p[8 + 2 * i + 1] : 0;
+			for (k = 1000; k > 0 && j < dscale; k /= 10, j++)
+				buf[pos++] = '0' + (d / k) % 10;
+		}
+	}
+	buf[pos] = '\0';
+}
+
+/*
+ * Convert a binary value into the text representation of the backend.
+ */
+static BOOL
+binary2text(OID field_type, const char *value, char *buf, size_t bufsize)
+{
+	SIMPLE_TIME	st;
+	const UCHAR	*u;
+
+	switch (field_type)
+	{
+		case PG_TYPE_BOOL:
+			strncpy_null(buf, value[0] ? "t" : "f", bufsize);
+			break;
+		case PG_TYPE_INT2:
+			snprintf(buf, bufsize, "%d", (Int2) (((UCHAR) value[0] << 8) | (UCHAR) value[1]));
+			break;
+		case PG_TYPE_INT4:
+			snprintf(buf, bufsize, "%d", (Int4) get_binary_uint32(value));
+			break;
+		case PG_TYPE_OID:
+			snprintf(buf, bufsize, "%u", get_binary_uint32(value));
+			break;
+		case PG_TYPE_INT8:
+			snprintf(buf, bufsize, FORMATI64, get_binary_int64(value));
+			break;
+		case PG_TYPE_FLOAT4:
+			binary_float2text(get_binary_float4(value), FLT_DIG, FLT_DIG + 3, TRUE, buf, bufsize);
+			break;
+		case PG_TYPE_FLOAT8:
+			binary_float2text(get_binary_float8(value), DBL_DIG, DBL_DIG + 2, FALSE, buf, bufsize);
+			break;
+		case PG_TYPE_DATE:
+		case PG_TYPE_TIMESTAMP_NO_TMZONE:
+			if (!binary_datetime2stime(field_type, value, &st))
+				strncpy_null(buf, st.infinity > 0 ? "infinity" : "-infinity", bufsize);
+			else
+			{
+				BOOL	bc = (st.y <= 0);
+				int	y = bc ? 1 - st.y : st.y;
+				size_t	pos;
+
+				pos = snprintf(buf, bufsize, "%04d-%02d-%02d", y, st.m, st.d);
+				if (PG_TYPE_TIMESTAMP_NO_TMZONE == field_type && pos < bufsize)
+				{
+					pos += snprintf(buf + pos, bufsize - pos, " %02d:%02d:%02d", st.hh, st.mm, st.ss);
+					if (st.fr && pos < bufsize)
+					{
+						int	i;
+
+						pos += snprintf(buf + pos, bufsize - pos, ".%06d", st.fr / 1000);
+						/* trailing zeros are omitted */
+						pos = strlen(buf);
+						for (i = (int) pos - 1; '0' == buf[i]; i--)
+							buf[i] = '\0';
+						pos = i + 1;
+					}
+				}
+				if (bc && pos < bufsize)
+					snprintf(buf + pos, bufsize - pos, " BC");
+			}
+			break;
+		case PG_TYPE_NUMERIC:
+			if (bufsize < numeric_binary_textlen(value))
+				return FALSE;
+			numeric_binary2text(value, buf);
+			break;
+		case PG_TYPE_UUID:
+			u = (const UCHAR *) value;
+			snprintf(buf, bufsize, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+					 u[0], u[1], u[2], u[3], u[4], u[5], u[6], u[7],
+					 u[8], u[9], u[10], u[11], u[12], u[13], u[14], u[15]);
+			break;
+		default:
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+ *	This is called instead of copy_and_convert_field() for the values
+ *	received in binary format. The values of SQLFetch() whose C types
+ *	match the binary layouts are stored directly, others are converted
+ *	through the text representation.
+ */
+int
+copy_and_convert_binary_field(StatementClass *stmt,
+		OID field_type, int atttypmod,
+		void *valuei,
+		SQLSMALLINT fCType, int precision,
+		PTR rgbValue, SQLLEN cbValueMax,
+		SQLLEN *pcbValue, SQLLEN *pIndicator)
+{
+	const char *value = valuei;
+	char		textbuf[64], *text = textbuf;
+	size_t		textlen = sizeof(textbuf);
+	int			result;
+
+	if (NULL == value)
+		return copy_and_convert_field(stmt, field_type, atttypmod, NULL,
+				fCType, precision, rgbValue, cbValueMax, pcbValue, pIndicator);
+	if (stmt->current_col < 0 &&
+		NULL == stmt->hdbc->DataSourceToDriver)
+	{
+		ARDFields	*opts = SC_get_ARDF(stmt);
+		SQLSETPOSIROW	bind_row = stmt->bind_row;
+		int		bind_size = opts->bind_size;
+		SQLLEN		pcbValueOffset, rgbValueOffset;
+		char		*rgbValueBindRow;
+		SQLLEN		len = 0;
+		SQLBIGINT	ival = 0;
+		SIMPLE_TIME	st;
+
+		if (bind_size > 0)
+			pcbValueOffset = rgbValueOffset = (bind_size * bind_row);
+		else
+		{
+			pcbValueOffset = bind_row * sizeof(SQLLEN);
+			rgbValueOffset = bind_row * cbValueMax;
+		}
+		rgbValueBindRow = (char *) rgbValue + rgbValueOffset;
+		switch (field_type)
+		{
+			case PG_TYPE_INT2:
+				ival = (Int2) (((UCHAR) value[0] << 8) | (UCHAR) value[1]);
+				break;
+			case PG_TYPE_INT4:
+				ival = (Int4) get_binary_uint32(value);
+				break;
+			case PG_TYPE_INT8:
+				ival = get_binary_int64(value);
+				break;
+		}
+#define	BINARY_STORE(type, val) \
+	do { \
+		len = sizeof(type); \
+		if (bind_size > 0) \
+			*((type *) rgbValueBindRow) = (val); \
+		else \
+			*((type *) rgbValue + bind_row) = (val); \
+	} while (0)
+		switch (field_type)
+		{
+			case PG_TYPE_INT2:
+				if (SQL_C_SSHORT == fCType || SQL_C_SHORT == fCType)
+					BINARY_STORE(SQLSMALLINT, (SQLSMALLINT) ival);
+				/* fall through */
+			case PG_TYPE_INT4:
+				if (SQL_C_SLONG == fCType || SQL_C_LONG == fCType)
+					BINARY_STORE(SQLINTEGER, (SQLINTEGER) ival);
+				/* fall through */
+			case PG_TYPE_INT8:
+#ifdef	ODBCINT64
+				if (SQL_C_SBIGINT == fCType)
+					BINARY_STORE(SQLBIGINT, ival);
+#endif /* ODBCINT64 */
+				if (SQL_C_DOUBLE == fCType)
+					BINARY_STORE(SDOUBLE, (SDOUBLE) ival);
+				break;
+			case PG_TYPE_FLOAT4:
+				if (SQL_C_FLOAT == fCType)
+					BINARY_STORE(SFLOAT, get_binary_float4(value));
+				else if (SQL_C_DOUBLE == fCType)
+					BINARY_STORE(SDOUBLE, get_binary_float4(value));
+				break;
+			case PG_TYPE_FLOAT8:
+				if (SQL_C_DOUBLE == fCType)
+					BINARY_STORE(SDOUBLE, get_binary_float8(value));
+				break;
+			case PG_TYPE_BOOL:
+				if (SQL_C_BIT == fCType)
+					BINARY_STORE(UCHAR, value[0] ? 1 : 0);
+				break;
+#ifdef	NUMERIC_UINT128
+			case PG_TYPE_NUMERIC:
+				if (SQL_C_NUMERIC == fCType)
+				{
+					SQL_NUMERIC_STRUCT	ns;
+
+					if (numeric_binary2struct(value, &ns))
+						BINARY_STORE(SQL_NUMERIC_STRUCT, ns);
+				}
+				break;
+#endif /* NUMERIC_UINT128 */
+			case PG_TYPE_DATE:
+				if ((SQL_C_DATE == fCType || SQL_C_TYPE_DATE == fCType) &&
+					binary_datetime2stime(field_type, value, &st))
+				{
+					DATE_STRUCT	ds;
+
+					ds.year = st.y;
+					ds.month = st.m;
+					ds.day = st.d;
+					BINARY_STORE(DATE_STRUCT, ds);
+				}
+				break;
+			case PG_TYPE_TIMESTAMP_NO_TMZONE:
+				if ((SQL_C_TIMESTAMP == fCType || SQL_C_TYPE_TIMESTAMP == fCType) &&
+					binary_datetime2stime(field_type, value, &st))
+				{
+					TIMESTAMP_STRUCT	ts;
+
+					ts.year = st.y;
+					ts.month = st.m;
+					ts.day = st.d;
+					ts.hour = st.hh;
+					ts.minute = st.mm;
+					ts.second = st.ss;
+					ts.fraction = st.fr;
+					BINARY_STORE(TIMESTAMP_STRUCT, ts);
+				}
+				break;
+			case PG_TYPE_UUID:
+				if (SQL_C_GUID == fCType)
+				{
+					const UCHAR	*u = (const UCHAR *) value;
+					SQLGUID		g;
+
+					g.Data1 = get_binary_uint32(value);
+					g.Data2 = (u[4] << 8) | u[5];
+					g.Data3 = (u[6] << 8) | u[7];
+					memcpy(g.Data4, u + 8, sizeof(g.Data4));
+					BINARY_STORE(SQLGUID, g);
+				}
+				break;
+		}
+#undef	BINARY_STORE
+		if (len > 0)
+		{
+			if (pIndicator)
+				*LENADDR_SHIFT(pIndicator, pcbValueOffset) = 0;
+			if (pcbValue)
+				*LENADDR_SHIFT(pcbValue, pcbValueOffset) = len;
+			return COPY_OK;
+		}
+	}
+
+	/* the other conversions are done through the text representation */
+	if (PG_TYPE_NUMERIC == field_type &&
+		(textlen = numeric_binary_textlen(value)) > sizeof(textbuf))
+	{
+		if (NULL == (text = malloc(textlen)))
+			return COPY_GENERAL_ERROR;
+	}
+	if (!binary2text(field_type, value, text, textlen))
+	{
+		MYLOG(0, "couldn't convert the binary value of type %d\n", field_type);
+		result = COPY_UNSUPPORTED_TYPE;
+	}
+	else
+		result = copy_and_convert_field(stmt, field_type, atttypmod, text,
+				fCType, precision, rgbValue, cbValueMax, pcbValue, pIndicator);
+	if (text != textbuf)
+		free(text);
+	return result;
+}
+
+/*
+ *	The converters of the fetch plan.
+ *
+ *	They store the value of the pair of the column type and the C type
+ *	they are chosen for and return the length to report, or -1 to leave
+ *	the value to the general conversion.
+ */
+static SQLLEN
+text_to_sshort(char *value, char *target, SQLLEN buflen)
+{
+	*((SQLSMALLINT *) target) = atoi(value);
+	return 2;
+}
+
+static SQLLEN
+text_to_slong(char *value, char *target, SQLLEN buflen)
+{
+	*((SQLINTEGER *) target) = atol(value);
+	return 4;
+}
+
+#ifdef	ODBCINT64
+static SQLLEN
+text_to_sbigint(char *value, char *target, SQLLEN buflen)
+{
+	*((SQLBIGINT *) target) = ATOI64(value);
+	return 8;
+}
+#endif /* ODBCINT64 */
+
+static SQLLEN
+text_to_float(char *value, char *target, SQLLEN buflen)
+{
+	set_client_decimal_point(value);
+	*((SFLOAT *) target) = (float) get_double_value(value);
+	return 4;
+}
+
+static SQLLEN
+text_to_double(char *value, char *target, SQLLEN buflen)
+{
+	set_client_decimal_point(value);
+	*((SDOUBLE *) target) = get_double_value(value);
+	return 8;
+}
+
+static SQLLEN
+text_to_char(char *value, char *target, SQLLEN buflen)
+{
+	size_t	len = strlen(value);
+
+	if ((SQLLEN) len >= buflen)	/* truncation is reported by the general one */
+		return -1;
+	memcpy(target, value, len + 1);
+	return len;
+}
+
+static SQLLEN
+binary_int2_to_sshort(char *value, char *target, SQLLEN buflen)
+{
+	*((SQLSMALLINT *) target) = (Int2) (((UCHAR) value[0] << 8) | (UCHAR) value[1]);
+	return 2;
+}
+
+static SQLLEN
+binary_int4_to_slong(char *value, char *target, SQLLEN buflen)
+{
+	*((SQLINTEGER *) target) = (Int4) get_binary_uint32(value);
+	return 4;
+}
+
+#ifdef	ODBCINT64
+static SQLLEN
+binary_int8_to_sbigint(char *value, char *target, SQLLEN buflen)
+{
+	*((SQLBIGINT *) target) = get_binary_int64(value);
+	return 8;
+}
+#endif /* ODBCINT64 */
+
+static SQLLEN
+binary_float4_to_float(char *value, char *target, SQLLEN buflen)
+{
+	*((SFLOAT *) target) = get_binary_float4(value);
+	return 4;
+}
+
+static SQLLEN
+binary_float8_to_double(char *value, char *target, SQLLEN buflen)
+{
+	*((SDOUBLE *) target) = get_binary_float8(value);
+	return 8;
+}
+
+/*
+ *	Choose the converter of a bound column. The pairs not listed here
+ *	are converted by copy_and_convert_field() or
+ *	copy_and_convert_binary_field() as before.
+ */
+static FetchConverter
+choose_fetch_converter(const ConnectionClass *conn, OID field_type, int atttypmod, BOOL binary, SQLSMALLINT fCType, SQLLEN *size)
+{
+	if (SQL_C_DEFAULT == fCType)
+	{
+		fCType = pgtype_attr_to_ctype(conn, field_type, atttypmod);
+#ifdef	UNICODE_SUPPORT
+		if (fCType == SQL_C_WCHAR
+		    && CC_default_is_c(conn))
+			fCType = SQL_C_CHAR;
+#endif /* UNICODE_SUPPORT */
+	}
+	*size = 0;
+	if (binary)
+	{
+		switch (field_type)
+		{
+			case PG_TYPE_INT2:
+				if (SQL_C_SSHORT == fCType || SQL_C_SHORT == fCType)
+					return (*size = sizeof(SQLSMALLINT), binary_int2_to_sshort);
+				break;
+			case PG_TYPE_INT4:
+				if (SQL_C_SLONG == fCType || SQL_C_LONG == fCType)
+					return (*size = sizeof(SQLINTEGER), binary_int4_to_slong);
+				break;
+#ifdef	ODBCINT64
+			case PG_TYPE_INT8:
+				if (SQL_C_SBIGINT == fCType)
+					return (*size = sizeof(SQLBIGINT), binary_int8_to_sbigint);
+				break;
+#endif /* ODBCINT64 */
+			case PG_TYPE_FLOAT4:
+				if (SQL_C_FLOAT == fCType)
+					return (*size = sizeof(SFLOAT), binary_float4_to_float);
+				break;
+			case PG_TYPE_FLOAT8:
+				if (SQL_C_DOUBLE == fCType)
+					return (*size = sizeof(SDOUBLE), binary_float8_to_double);
+				break;
+		}
+		return NULL;
+	}
+	switch (field_type)
+	{
+		case PG_TYPE_INT2:
+		case PG_TYPE_INT4:
+		case PG_TYPE_INT8:
+			switch (fCType)
+			{
+				case SQL_C_SSHORT:
+				case SQL_C_SHORT:
+					return (*size = sizeof(SQLSMALLINT), text_to_sshort);
+				case SQL_C_SLONG:
+				case SQL_C_LONG:
+					return (*size = sizeof(SQLINTEGER), text_to_slong);
+#ifdef	ODBCINT64
+				case SQL_C_SBIGINT:
+					return (*size = sizeof(SQLBIGINT), text_to_sbigint);
+#endif /* ODBCINT64 */
+			}
+			/* fall through */
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+		case PG_TYPE_NUMERIC:
+			if (SQL_C_FLOAT == fCType)
+				return (*size = sizeof(SFLOAT), text_to_float);
+			if (SQL_C_DOUBLE == fCType)
+				return (*size = sizeof(SDOUBLE), text_to_double);
+			break;
+		case PG_TYPE_UNKNOWN:
+		case PG_TYPE_BPCHAR:
+		case PG_TYPE_VARCHAR:
+		case PG_TYPE_TEXT:
+			if (SQL_C_CHAR != fCType || conn->connInfo.lf_conversion)
+				break;
+#ifdef	UNICODE_SUPPORT
+			/* see setup_getdataclass() */
+			if (get_convtype() > 0 &&
+			    (conn->ccsc != pg_CS_code(conn->locale_encoding) ||
+			     conn->connInfo.wcs_debug))
+				break;
+#endif /* UNICODE_SUPPORT */
+			return text_to_char;
+	}
+	return NULL;
+}
+
+/*
+ *	The batch converters of the fetch plan.
+ *
+ *	They convert the leading values of a column which are stored
+ *	exactly as the converters above would store them and return the
+ *	number of them. The value they stop at is left to the one by one
+ *	conversion.
+ */
+#ifdef	ODBCINT64
+/*
+ *	[-]digits whose value is within [minval, maxval], which atoi(),
+ *	atol() or ATOI64() read exactly on any platform.
+ */
+static BOOL
+parse_int_exact(const char *str, SQLBIGINT minval, SQLBIGINT maxval, SQLBIGINT *val)
+{
+	const char	*p = str;
+	SQLBIGINT	v = 0;
+	BOOL		minus = ('-' == *p);
+	int		i;
+
+	if (minus)
+		p++;
+	for (i = 0; IS_DIGIT(p[i]); i++)
+	{
+		if (i >= 18)
+			return FALSE;
+		v = v * 10 + (p[i] - '0');
+	}
+	if (0 == i || '\0' != p[i])
+		return FALSE;
+	if (minus)
+		v = -v;
+	if (v < minval || v > maxval)
+		return FALSE;
+	*val = v;
+	return TRUE;
+}
+
+#define	INT4_MIN_VALUE	(-INT64CONST(2147483647) - 1)
+#define	INT4_MAX_VALUE	INT64CONST(2147483647)
+#define	INT8_EXACT_VALUE	INT64CONST(999999999999999999)
+
+static SQLLEN
+batch_text_to_sshort(char **values, SQLLEN n, char *target, SQLLEN stride)
+{
+	SQLBIGINT	v;
+	SQLLEN		i;
+
+	for (i = 0; i < n; i++, target += stride)
+	{
+		if (NULL == values[i] ||
+		    !parse_int_exact(values[i], INT4_MIN_VALUE, INT4_MAX_VALUE, &v))
+			break;
+		*((SQLSMALLINT *) target) = (int) v;
+	}
+	return i;
+}
+
+static SQLLEN
+batch_text_to_slong(char **values, SQLLEN n, char *target, SQLLEN stride)
+{
+	SQLBIGINT	v;
+	SQLLEN		i;
+
+	for (i = 0; i < n; i++, target += stride)
+	{
+		if (NULL == values[i] ||
+		    !parse_int_exact(values[i], INT4_MIN_VALUE, INT4_MAX_VALUE, &v))
+			break;
+		*((SQLINTEGER *) target) = (SQLINTEGER) v;
+	}
+	return i;
+}
+
+static SQLLEN
+batch_text_to_sbigint(char **values, SQLLEN n, char *target, SQLLEN stride)
+{
+	SQLBIGINT	v;
+	SQLLEN		i;
+
+	for (i = 0; i < n; i++, target += stride)
+	{
+		if (NULL == values[i] ||
+		    !parse_int_exact(values[i], -INT8_EXACT_VALUE, INT8_EXACT_VALUE, &v))
+			break;
+		*((SQLBIGINT *) target) = v;
+	}
+	return i;
+}
+#endif /* ODBCINT64 */
+
+/*
+ *	Doubles whose digits fit in the 53 bits mantissa and whose decimal
+ *	exponent is within +-22 are exactly the product or the quotient of
+ *	two exact doubles, so a single correctly rounded operation gives the
+ *	same value as strtod() (Clinger's fast path). This doesn't hold when
+ *	the intermediate results are kept in a wider precision.
+ */
+#if	defined(ODBCINT64) && defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define	EXACT_DOUBLE_PARSE
+static const double	exact_pow10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+	1e21, 1e22
+};
+#define	MAX_EXACT_MANTISSA	(((SQLUBIGINT) 1) << 53)
+
+static BOOL
+parse_double_exact(const char *str, double *val)
+{
+	const char	*p = str;
+	SQLUBIGINT	w = 0;
+	BOOL		minus = ('-' == *p);
+	int		ndigits = 0, e10 = 0, expo = 0;
+	double		d;
+
+	if (minus)
+		p++;
+	for (; IS_DIGIT(*p); p++, ndigits++)
+	{
+		if ((w = w * 10 + (*p - '0')) > MAX_EXACT_MANTISSA)
+			return FALSE;
+	}
+	if ('.' == *p)
+	{
+		for (p++; IS_DIGIT(*p); p++, ndigits++, e10--)
+		{
+			if ((w = w * 10 + (*p - '0')) > MAX_EXACT_MANTISSA)
+				return FALSE;
+		}
+	}
+	if (0 == ndigits)
+		return FALSE;
+	if ('e' == *p || 'E' == *p)
+	{
+		BOOL	eminus;
+		int	i;
+
+		p++;
+		if ((eminus = ('-' == *p)) || '+' == *p)
+			p++;
+		for (i = 0; IS_DIGIT(*p); p++, i++)
+		{
+			if (i >= 3)
+				return FALSE;
+			expo = expo * 10 + (*p - '0');
+		}
+		if (0 == i)
+			return FALSE;
+		e10 += eminus ? -expo : expo;
+	}
+	if ('\0' != *p)
+		return FALSE;
+	d = (double) w;
+	if (0 != w)
+	{
+		if (e10 < -22 || e10 > 22)
+			return FALSE;
+		if (e10 < 0)
+			d /= exact_pow10[-e10];
+		else
+			d *= exact_pow10[e10];
+	}
+	*val = minus ? -d : d;
+	return TRUE;
+}
+
+static SQLLEN
+batch_text_to_float(char **values, SQLLEN n, char *target, SQLLEN stride)
+{
+	double	d;
+	SQLLEN	i;
+
+#ifdef	HAVE_LOCALE_H
+	/* set_client_decimal_point() would change the values */
+	if ('.' != get_current_decimal_point())
+		return 0;
+#endif /* HAVE_LOCALE_H */
+	for (i = 0; i < n; i++, target += stride)
+	{
+		if (NULL == values[i] || !parse_double_exact(values[i], &d))
+			break;
+		*((SFLOAT *) target) = (float) d;
+	}
+	return i;
+}
+
+static SQLLEN
+batch_text_to_double(char **values, SQLLEN n, char *target, SQLLEN stride)
+{
+	double	d;
+	SQLLEN	i;
+
+#ifdef	HAVE_LOCALE_H
+	if ('.' != get_current_decimal_point())
+		return 0;
+#endif /* HAVE_LOCALE_H */
+	for (i = 0; i < n; i++, target += stride)
+	{
+		if (NULL == values[i] || !parse_double_exact(values[i], &d))
+			break;
+		*((SDOUBLE *) target) = d;
+	}
+	return i;
+}
+#endif /* EXACT_DOUBLE_PARSE */
+
+static FetchBatchConverter
+choose_batch_converter(FetchConverter convert)
+{
+#ifdef	ODBCINT64
+	if (text_to_sshort == convert)
+		return batch_text_to_sshort;
+	if (text_to_slong == convert)
+		return batch_text_to_slong;
+	if (text_to_sbigint == convert)
+		return batch_text_to_sbigint;
+#endif /* ODBCINT64 */
+#ifdef	EXACT_DOUBLE_PARSE
+	if (text_to_float == convert)
+		return batch_text_to_float;
+	if (text_to_double == convert)
+		return batch_text_to_double;
+#endif /* EXACT_DOUBLE_PARSE */
+	return NULL;
+}
+
+/*
+ *	Is the plan compiled from the current bindings and columns ?
+ */
+static BOOL
+fetch_plan_is_valid(const FetchPlan *plan, const ARDFields *opts,
+		const ColumnInfoClass *coli, int num_cols)
+{
+	const BindInfoClass	*bic;
+	const FetchPlanCol	*pc;
+	int	lf, i = 0;
+
+	if (NULL == plan ||
+	    plan->bind_size != opts->bind_size ||
+	    plan->num_result_cols != num_cols)
+		return FALSE;
+	for (lf = 0; lf < num_cols; lf++)
+	{
+		bic = &opts->bindings[lf];
+		if (NULL == bic->buffer)
+			continue;
+		if (i >= plan->num_cols)
+			return FALSE;
+		pc = &plan->cols[i++];
+		if (pc->col != lf ||
+		    pc->buffer != bic->buffer ||
+		    pc->buflen != bic->buflen ||
+		    pc->used != bic->used ||
+		    pc->indicator != bic->indicator ||
+		    pc->returntype != bic->returntype ||
+		    pc->precision != bic->precision ||
+		    pc->field_type != CI_get_oid(coli, lf) ||
+		    pc->atttypmod != CI_get_atttypmod(coli, lf) ||
+		    pc->binary != CI_is_binary(coli, lf))
+			return FALSE;
+	}
+	return i == plan->num_cols;
+}
 
-				result = char2guid(neut_str, &g);
-				if (COPY_OK != result)
-				{
-					MYLOG(0, "Could not convert to SQL_C_GUID\n");
-					return	COPY_UNSUPPORTED_TYPE;
-				}
-				len = sizeof(g);
-				if (bind_size > 0)
-					*((SQLGUID *) rgbValueBindRow) = g;
-				else
-					*((SQLGUID *) rgbValue + bind_row) = g;
-				break;
-			case SQL_C_INTERVAL_YEAR:
-			case SQL_C_INTERVAL_MONTH:
-			case SQL_C_INTERVAL_YEAR_TO_MONTH:
-			case SQL_C_INTERVAL_DAY:
-			case SQL_C_INTERVAL_HOUR:
-			case SQL_C_INTERVAL_DAY_TO_HOUR:
-			case SQL_C_INTERVAL_MINUTE:
-			case SQL_C_INTERVAL_HOUR_TO_MINUTE:
-			case SQL_C_INTERVAL_SECOND:
-			case SQL_C_INTERVAL_DAY_TO_SECOND:
-			case SQL_C_INTERVAL_HOUR_TO_SECOND:
-			case SQL_C_INTERVAL_MINUTE_TO_SECOND:
-				interval2istruct(fCType, precision, neut_str, bind_size > 0 ? (SQL_INTERVAL_STRUCT *) rgbValueBindRow : (SQL_INTERVAL_STRUCT *) rgbValue + bind_row);
-				break;
+void
+free_fetch_plan(FetchPlan *plan)
+{
+	if (NULL == plan)
+		return;
+	if (plan->cols)
+		free(plan->cols);
+	free(plan);
+}
 
-			default:
-				MYLOG(0, "conversion to the type %d isn't supported\n", fCType);
-				return COPY_UNSUPPORTED_TYPE;
+/*
+ *	Get the fetch plan of the bound columns ready for a call of
+ *	SQLFetch() or SQLExtendedFetch(), compiling it again only when the
+ *	bindings or the result columns have changed since the last call.
+ *	Returns FALSE when the columns should be converted one by one.
+ */
+BOOL
+prepare_fetch_plan(StatementClass *stmt)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	GetDataInfo	*gdata = SC_get_GDTI(stmt);
+	QResultClass	*res = SC_get_Curres(stmt);
+	ColumnInfoClass	*coli;
+	FetchPlan	*plan = stmt->fetch_plan;
+	FetchPlanCol	*pc;
+	BindInfoClass	*bic;
+	int		num_cols, lf, nbound;
+	SQLLEN		size;
+
+	if (NULL == res || NULL == (coli = QR_get_fields(res)))
+		return FALSE;
+	/* the translation dll may rewrite any value */
+	if (NULL != conn->DataSourceToDriver)
+		return FALSE;
+	num_cols = QR_NumPublicResultCols(res);
+	if (opts->allocated < num_cols)
+		extend_column_bindings(opts, num_cols);
+	if (NULL == opts->bindings)
+		return FALSE;
+	if (gdata->allocated != opts->allocated)
+		extend_getdata_info(gdata, opts->allocated, TRUE);
+
+	if (!fetch_plan_is_valid(plan, opts, coli, num_cols))
+	{
+		MYLOG(0, "compiling the fetch plan of %d columns\n", num_cols);
+		free_fetch_plan(plan);
+		stmt->fetch_plan = plan = NULL;
+		for (lf = 0, nbound = 0; lf < num_cols; lf++)
+		{
+			if (NULL != opts->bindings[lf].buffer)
+				nbound++;
+		}
+		if (NULL == (plan = (FetchPlan *) malloc(sizeof(FetchPlan))))
+			return FALSE;
+		plan->cols = NULL;
+		if (nbound > 0 &&
+		    NULL == (plan->cols = (FetchPlanCol *) malloc(sizeof(FetchPlanCol) * nbound)))
+		{
+			free(plan);
+			return FALSE;
+		}
+		plan->bind_size = opts->bind_size;
+		plan->num_result_cols = num_cols;
+		plan->num_cols = nbound;
+		for (lf = 0, pc = plan->cols; lf < num_cols; lf++)
+		{
+			bic = &opts->bindings[lf];
+			if (NULL == bic->buffer)
+				continue;
+			pc->col = lf;
+			pc->field_type = CI_get_oid(coli, lf);
+			pc->atttypmod = CI_get_atttypmod(coli, lf);
+			pc->binary = CI_is_binary(coli, lf);
+			pc->buffer = bic->buffer;
+			pc->buflen = bic->buflen;
+			pc->used = bic->used;
+			pc->indicator = bic->indicator;
+			pc->returntype = bic->returntype;
+			pc->precision = bic->precision;
+			pc->convert = choose_fetch_converter(conn, pc->field_type, pc->atttypmod, pc->binary, pc->returntype, &size);
+			pc->convert_batch = choose_batch_converter(pc->convert);
+			pc->size = size;
+			/* see copy_and_convert_field() about the offsets */
+			if (opts->bind_size > 0)
+				pc->stride = pc->len_stride = opts->bind_size;
+			else
+			{
+				pc->stride = size > 0 ? size : bic->buflen;
+				pc->len_stride = sizeof(SQLLEN);
+			}
+			pc++;
 		}
+		stmt->fetch_plan = plan;
 	}
+	plan->offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	/* reset for SQLGetData */
+	for (lf = 0; lf < num_cols; lf++)
+		GETDATA_RESET(gdata->gdata[lf]);
+	SC_set_current_col(stmt, -1);
 
-	/* store the length of what was copied, if there's a place for it */
-	if (pcbValue)
-		*pcbValueBindRow = len;
+	return TRUE;
+}
 
-	if (result == COPY_OK && stmt->current_col >= 0)
-		gdata->gdata[stmt->current_col].data_left = 0;
-	return result;
+/*
+ *	Store the value of a bound column of the row stmt->bind_row
+ *	following the fetch plan.
+ */
+int
+copy_and_convert_field_planned(StatementClass *stmt, const FetchPlanCol *pc, void *value)
+{
+	SQLULEN	offset = stmt->fetch_plan->offset;
+	SQLSETPOSIROW	bind_row = stmt->bind_row;
+	SQLLEN	len, len_offset;
+
+	if (NULL != value && NULL != pc->convert &&
+	    (len = pc->convert(value, pc->buffer + offset + pc->stride * bind_row, pc->buflen)) >= 0)
+	{
+		len_offset = offset + pc->len_stride * bind_row;
+		if (pc->indicator)
+			*LENADDR_SHIFT(pc->indicator, len_offset) = 0;
+		if (pc->used)
+			*LENADDR_SHIFT(pc->used, len_offset) = len;
+		return COPY_OK;
+	}
+	return (pc->binary ? copy_and_convert_binary_field : copy_and_convert_field)(stmt, pc->field_type, pc->atttypmod, value,
+		pc->returntype, pc->precision,
+		(PTR) (pc->buffer + offset), pc->buflen,
+		LENADDR_SHIFT(pc->used, offset), LENADDR_SHIFT(pc->indicator, offset));
+}
+
+/*
+ *	Store the values of a bound column of the rows first_row,
+ *	first_row + 1, ... at once following the fetch plan. Returns the
+ *	number of the leading values stored, the caller converts the next
+ *	one with copy_and_convert_field_planned().
+ */
+SQLLEN
+copy_and_convert_column_planned(StatementClass *stmt, const FetchPlanCol *pc, char **values, SQLSETPOSIROW first_row, SQLLEN num_rows)
+{
+	SQLULEN	offset = stmt->fetch_plan->offset;
+	SQLLEN	n, i, len_offset;
 
+	if (NULL == pc->convert_batch)
+		return 0;
+	n = pc->convert_batch(values, num_rows, pc->buffer + offset + pc->stride * first_row, pc->stride);
+	len_offset = offset + pc->len_stride * first_row;
+	for (i = 0; i < n; i++, len_offset += pc->len_stride)
+	{
+		if (pc->indicator)
+			*LENADDR_SHIFT(pc->indicator, len_offset) = 0;
+		if (pc->used)
+			*LENADDR_SHIFT(pc->used, len_offset) = pc->size;
+	}
+	return n;
 }
 
 
@@ -2105,6 +3586,9 @@ typedef enum
 #define	FLGB_LITERAL_EXTENSION	(1L << 10)
 #define	FLGB_HEX_BIN_FORMAT	(1L << 11)
 #define	FLGB_PARAM_CAST		(1L << 12)
+#define	FLGB_VALUE_BY_REF	(1L << 13)
+#define	FLGB_COPY_DATA		(1L << 14)
+#define	FLGB_UNCACHEABLE	(1L << 15)
 typedef struct _QueryBuild {
 	char   *query_statement;
 	size_t	str_alsize;
@@ -2131,6 +3615,13 @@ typedef struct _QueryBuild {
 
 	ConnectionClass	*conn; /* mainly needed for LO handling */
 	StatementClass	*stmt; /* needed to set error info in ENLARGE_.. */
+
+	/*
+	 * With FLGB_VALUE_BY_REF, a bind value which is already in the form
+	 * to send is referred to here instead of being copied.
+	 */
+	const char	*byref_value;
+	size_t	byref_len;
 }	QueryBuild;
 
 #define INIT_MIN_ALLOC	4096
@@ -2141,6 +3632,8 @@ QB_initialize(QueryBuild *qb, size_t size, StatementClass *stmt, ResolveParamMod
 
 	qb->param_mode = param_mode;
 	qb->flags = 0;
+	qb->byref_value = NULL;
+	qb->byref_len = 0;
 	qb->load_stmt_len = 0;
 	qb->load_from_pos = 0;
 	qb->stmt = stmt;
@@ -2701,6 +4194,96 @@ buildProcessedStmt(const char *srvquery, ssize_t endp, int num_params)
 	return pstmt;
 }
 
+/*
+ * Is the statement prepared as a named plan ? Statements executed once
+ * are too when the plan cache may share their plans with the other
+ * statements of the connection.
+ */
+static BOOL
+use_named_plan(const StatementClass *stmt)
+{
+	switch (SC_get_prepare_method(stmt))
+	{
+		case NAMED_PARSE_REQUEST:
+			return TRUE;
+		case PARSE_TO_EXEC_ONCE:
+			return (SC_get_conn(stmt)->connInfo.plan_cache_size > 0 &&
+					0 == stmt->multi_statement);
+	}
+	return FALSE;
+}
+
+/*
+ * The key of the statement in the cache of processed statements. Returns
+ * FALSE if the statement can't be cached.
+ */
+static BOOL
+processed_cache_key(StatementClass *stmt, BOOL param_cast, UInt4 *flags, Int4 **param_sig)
+{
+	ConnectionClass *conn = SC_get_conn(stmt);
+	IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	ParameterImplClass *ipara;
+	Int4		*sig = NULL;
+	int		i;
+
+	*param_sig = NULL;
+	if (conn->connInfo.stmt_cache_size <= 0 ||
+		stmt->num_params < 0 ||
+		stmt->multi_statement < 0 ||
+		0 != stmt->proc_return ||
+		STMT_TYPE_PROCCALL == stmt->statement_type)
+		return FALSE;
+	*flags = (param_cast ? STMT_CACHE_PARAM_CAST : 0) |
+			 (stmt->discard_output_params ? STMT_CACHE_DISCARD_OUTPUT : 0) |
+			 (CC_get_escape(conn) ? STMT_CACHE_ESCAPE : 0) |
+			 ((UInt4) conn->ccsc << STMT_CACHE_CCSC_SHIFT);
+	if (stmt->num_params > 0)
+	{
+		if (NULL == (sig = malloc(sizeof(Int4) * stmt->num_params)))
+			return FALSE;
+		for (i = 0; i < stmt->num_params; i++)
+		{
+			if (i >= ipdopts->allocated)
+			{
+				sig[i] = -1;
+				continue;
+			}
+			ipara = ipdopts->parameters + i;
+			sig[i] = ((Int4) ipara->paramType << 16) |
+					 (param_cast ? (UInt2) ipara->SQLType : 0);
+		}
+	}
+	*param_sig = sig;
+	return TRUE;
+}
+
+static ProcessedStmt *
+copyProcessedStmts(const ProcessedStmt *src)
+{
+	ProcessedStmt	*top = NULL, *last = NULL, *pstmt;
+
+	for (; src; src = src->next)
+	{
+		if (NULL == (pstmt = buildProcessedStmt(src->query, SQL_NTS, src->num_params)))
+		{
+			for (; top; top = pstmt)
+			{
+				pstmt = top->next;
+				free(top->query);
+				free(top);
+			}
+			return NULL;
+		}
+		if (last)
+			last->next = pstmt;
+		else
+			top = pstmt;
+		last = pstmt;
+	}
+
+	return top;
+}
+
 /*
  * Process the original SQL query for execution using server-side prepared
  * statements.
@@ -2713,6 +4296,9 @@ buildProcessedStmt(const char *srvquery, ssize_t endp, int num_params)
  * fake parameter values instead. This is used when a query's result columns
  * have to be described (SQLPrepare+SQLDescribeCol) before executing the
  * query, in UseServerSidePrepare=0 mode.
+ *
+ * Otherwise the result is kept in the cache of processed statements of the
+ * connection, and the same statement is processed again by copying it.
  */
 RETCODE
 prepareParametersNoDesc(StatementClass *stmt, BOOL fake_params, BOOL param_cast)
@@ -2729,8 +4315,30 @@ prepareParametersNoDesc(StatementClass *stmt, BOOL fake_params, BOOL param_cast)
 	ProcessedStmt *last_pstmt;
 	QueryParse	query_org, *qp;
 	QueryBuild	query_crt, *qb;
+	BOOL		cacheable = FALSE;
+	UInt4		cache_flags = 0;
+	Int4		*param_sig = NULL;
+	const StmtCacheEntry *cached;
 
 MYLOG(DETAIL_LOG_LEVEL, "entering\n");
+	if (!fake_params)
+		cacheable = processed_cache_key(stmt, param_cast, &cache_flags, &param_sig);
+	if (cacheable &&
+		NULL != (cached = CC_lookup_processed(conn, stmt->statement, cache_flags, stmt->num_params, param_sig)) &&
+		NULL != (pstmt = copyProcessedStmts(cached->processed)))
+	{
+		MYLOG(0, "found in the cache of processed statements\n");
+		if (param_sig)
+			free(param_sig);
+		stmt->processed_statements = pstmt;
+		if (use_named_plan(stmt))
+			SPRINTF_FIXED(plan_name, "_PLAN%p", stmt);
+		else
+			plan_name[0] = '\0';
+		SC_set_planname(stmt, plan_name);
+		SC_set_prepared(stmt, plan_name[0] ? PREPARING_PERMANENTLY : PREPARING_TEMPORARILY);
+		return SQL_SUCCESS;
+	}
 	qp = &query_org;
 	QP_initialize(qp, stmt);
 	qb = &query_crt;
@@ -2738,6 +4346,8 @@ MYLOG(DETAIL_LOG_LEVEL, "entering\n");
 					  fake_params ? RPM_FAKE_PARAMS : RPM_BUILDING_PREPARE_STATEMENT) < 0)
 	{
 		SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
+		if (param_sig)
+			free(param_sig);
 		return SQL_ERROR;
 	}
 	if (param_cast)
@@ -2750,6 +4360,8 @@ MYLOG(DETAIL_LOG_LEVEL, "entering\n");
 		{
 			QB_replace_SC_error(stmt, qb, func);
 			QB_Destructor(qb);
+			if (param_sig)
+				free(param_sig);
 			return retval;
 		}
 	}
@@ -2757,7 +4369,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering\n");
 
 	retval = SQL_ERROR;
 #define	return	DONT_CALL_RETURN_FROM_HERE???
-	if (NAMED_PARSE_REQUEST == SC_get_prepare_method(stmt))
+	if (use_named_plan(stmt))
 		SPRINTF_FIXED(plan_name, "_PLAN%p", stmt);
 	else
 		plan_name[0] = '\0';
@@ -2801,12 +4413,20 @@ MYLOG(DETAIL_LOG_LEVEL, "entering\n");
 
 	SC_set_planname(stmt, plan_name);
 	SC_set_prepared(stmt, plan_name[0] ? PREPARING_PERMANENTLY : PREPARING_TEMPORARILY);
+	if (cacheable &&
+		0 == (qb->flags & FLGB_UNCACHEABLE) &&
+		0 == stmt->proc_return &&
+		NULL != (pstmt = copyProcessedStmts(stmt->processed_statements)))
+		CC_add_processed(conn, stmt->statement, cache_flags, stmt->num_params, param_sig,
+						 statement_type(stmt->statement), stmt->multi_statement, pstmt);
 
 	retval = SQL_SUCCESS;
 cleanup:
 #undef	return
 	stmt->current_exec_param = -1;
 	QB_Destructor(qb);
+	if (param_sig)
+		free(param_sig);
 	return retval;
 }
 
@@ -3016,7 +4636,7 @@ MYLOG(DETAIL_LOG_LEVEL, "type=" FORMAT_UINTEGER " concur=" FORMAT_UINTEGER "\n",
 	{
 		/* Nothing to do here. It will be prepared before execution. */
 		char		plan_name[32];
-		if (NAMED_PARSE_REQUEST == SC_get_prepare_method(stmt))
+		if (use_named_plan(stmt))
 			SPRINTF_FIXED(plan_name, "_PLAN%p", stmt);
 		else
 			plan_name[0] = '\0';
@@ -3709,6 +5329,9 @@ inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 		BOOL		converted = FALSE;
 		COL_INFO	*coli;
 
+		/* depends on the last insert of the connection */
+		qb->flags |= FLGB_UNCACHEABLE;
+
 #ifdef	NOT_USED  /* lastval() isn't always appropriate */
 		if (PG_VERSION_GE(conn, 8.1))
 		{
@@ -4004,10 +5627,15 @@ cleanup:
 }
 
 #define	MIN_ALC_SIZE	128
+#define	BIND_BUF_KEEP_SIZE	(1024 * 1024)
 
 /*
  * Build an array of parameters to pass to libpq's PQexecPrepared
  * function.
+ *
+ * The arrays belong to the statement and are valid until the next call.
+ * The values point into the statement's bind_buf, or directly into the
+ * application's buffers when they are already in the form to send.
  */
 BOOL
 build_libpq_bind_params(StatementClass *stmt,
@@ -4056,22 +5684,26 @@ build_libpq_bind_params(StatementClass *stmt,
 
 	if (num_params > 0)
 	{
-		*paramTypes = malloc(sizeof(OID) * num_params);
-		if (*paramTypes == NULL)
-			goto cleanup;
-		*paramValues = malloc(sizeof(char *) * num_params);
-		if (*paramValues == NULL)
+		if (!SC_reserve_bind_params(stmt, num_params))
 			goto cleanup;
+		*paramTypes = stmt->bind_types;
+		*paramValues = stmt->bind_values;
 		memset(*paramValues, 0, sizeof(char *) * num_params);
-		*paramLengths = malloc(sizeof(int) * num_params);
-		if (*paramLengths == NULL)
-			goto cleanup;
-		*paramFormats = malloc(sizeof(int) * num_params);
-		if (*paramFormats == NULL)
-			goto cleanup;
-	}
+		*paramLengths = stmt->bind_lengths;
+		*paramFormats = stmt->bind_formats;
+	}
+	/* don't keep the memory of an exceptionally big execution */
+	if (!PQExpBufferDataBroken(stmt->bind_buf) &&
+		stmt->bind_buf.maxlen > BIND_BUF_KEEP_SIZE)
+		termPQExpBuffer(&stmt->bind_buf);
+	if (PQExpBufferDataBroken(stmt->bind_buf))
+		initPQExpBuffer(&stmt->bind_buf);
+	else
+		resetPQExpBuffer(&stmt->bind_buf);
+	if (PQExpBufferDataBroken(stmt->bind_buf))
+		goto cleanup;
 
-	qb.flags |= FLGB_BINARY_AS_POSSIBLE;
+	qb.flags |= FLGB_BINARY_AS_POSSIBLE | FLGB_VALUE_BY_REF;
 
 	MYLOG(DETAIL_LOG_LEVEL, "num_params=%d proc_return=%d\n", num_params, stmt->proc_return);
 	num_p = num_params - qb.num_discard_params;
@@ -4085,7 +5717,7 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 
 		BOOL	isnull;
 		BOOL	isbinary;
-		char	*val_copy;
+		size_t	val_len;
 		OID	pgType;
 
 		/*
@@ -4094,6 +5726,7 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 		for (i = 0, pno = 0; i < stmt->num_params; i++)
 		{
 			qb.npos = 0;
+			qb.byref_value = NULL;
 			retval = ResolveOneParam(&qb, NULL, &isnull, &isbinary, &pgType);
 			if (SQL_ERROR == retval)
 			{
@@ -4114,22 +5747,31 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 				(*paramValues)[pno] = NULL;
 				(*paramLengths)[pno] = 0;
 				(*paramFormats)[pno] = 0;
+				stmt->bind_value_pos[pno] = -1;
 				pno++;
 				continue;
 			}
+			stmt->bind_value_pos[pno] = -1;
 			if (!isnull)
 			{
-				val_copy = malloc(qb.npos + 1);
-				if (!val_copy)
-					goto cleanup;
-				memcpy(val_copy, qb.query_statement, qb.npos);
-				val_copy[qb.npos] = '\0';
+				if (NULL != qb.byref_value)
+				{
+					(*paramValues)[pno] = (char *) qb.byref_value;
+					val_len = qb.byref_len;
+				}
+				else
+				{
+					/* terminated for the text format */
+					stmt->bind_value_pos[pno] = stmt->bind_buf.len;
+					appendBinaryPQExpBuffer(&stmt->bind_buf, qb.query_statement, qb.npos);
+					appendPQExpBufferChar(&stmt->bind_buf, '\0');
+					val_len = qb.npos;
+				}
 
 				(*paramTypes)[pno] = pgType;
-				(*paramValues)[pno] = val_copy;
-				if (qb.npos > INT_MAX)
+				if (val_len > INT_MAX)
 					goto cleanup;
-				(*paramLengths)[pno] = (int) qb.npos;
+				(*paramLengths)[pno] = (int) val_len;
 			}
 			else
 			{
@@ -4137,19 +5779,210 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 				(*paramValues)[pno] = NULL;
 				(*paramLengths)[pno] = 0;
 			}
-			if (isbinary)
-				MYLOG(0, "%dth parameter is of binary format\n", pno);
-			(*paramFormats)[pno] = isbinary ? 1 : 0;
-
-			pno++;
+			if (isbinary)
+				MYLOG(0, "%dth parameter is of binary format\n", pno);
+			(*paramFormats)[pno] = isbinary ? 1 : 0;
+
+			pno++;
+		}
+		*nParams = pno;
+
+		/* bind_buf may have moved while growing */
+		if (PQExpBufferDataBroken(stmt->bind_buf))
+			goto cleanup;
+		for (i = 0; i < pno; i++)
+		{
+			if (stmt->bind_value_pos[i] >= 0)
+				(*paramValues)[i] = stmt->bind_buf.data + stmt->bind_value_pos[i];
+		}
+	}
+
+	/* result format is text */
+	*resultFormat = 0;
+
+	ret = TRUE;
+
+cleanup:
+	QB_Destructor(&qb);
+
+	return ret;
+}
+
+
+/*
+ * If the statement is a plain
+ *	INSERT INTO table [(columns)] VALUES (?, ..., ?)
+ * with num_params parameter markers, return the equivalent
+ *	COPY table [(columns)] FROM STDIN
+ * (malloc'ed), otherwise NULL. The table as written in the statement
+ * is returned in table and tablelen unless they are NULL.
+ */
+char *
+insert_to_copy_statement(const StatementClass *stmt, int num_params, const char **table_, size_t *tablelen_)
+{
+	const char	*p = stmt->statement, *table, *columns = NULL;
+	size_t		tablelen, columnslen = 0, copylen;
+	int			len, nmarkers = 0;
+	char		*copy;
+
+	if (NULL == p)
+		return NULL;
+	while (isspace((UCHAR) *p)) p++;
+	if (strnicmp(p, "insert", 6) || !isspace((UCHAR) p[6]))
+		return NULL;
+	for (p += 6; isspace((UCHAR) *p); p++)
+		;
+	if (strnicmp(p, "into", 4) || !isspace((UCHAR) p[4]))
+		return NULL;
+	for (p += 4; isspace((UCHAR) *p); p++)
+		;
+	table = p;
+	if ((len = eatTableIdentifiers((const UCHAR *) p, SC_get_conn(stmt)->ccsc, NULL, NULL)) <= 0)
+		return NULL;
+	tablelen = len;
+	for (p += len; isspace((UCHAR) *p); p++)
+		;
+	if ('(' == *p)
+	{
+		BOOL	in_quote = FALSE;
+
+		columns = p;
+		for (p++; *p; p++)
+		{
+			if (IDENTIFIER_QUOTE == *p)
+				in_quote = !in_quote;
+			else if (in_quote)
+				;
+			else if (')' == *p)
+				break;
+			else if ('(' == *p || LITERAL_QUOTE == *p)
+				return NULL;
+		}
+		if (')' != *p)
+			return NULL;
+		columnslen = ++p - columns;
+		while (isspace((UCHAR) *p)) p++;
+	}
+	if (strnicmp(p, "values", 6))
+		return NULL;
+	for (p += 6; isspace((UCHAR) *p); p++)
+		;
+	if ('(' != *p++)
+		return NULL;
+	for (;;)
+	{
+		while (isspace((UCHAR) *p)) p++;
+		if ('?' != *p)
+			return NULL;
+		nmarkers++;
+		for (p++; isspace((UCHAR) *p); p++)
+			;
+		if (',' == *p)
+			p++;
+		else if (')' == *p)
+			break;
+		else
+			return NULL;
+	}
+	for (p++; isspace((UCHAR) *p); p++)
+		;
+	if (';' == *p)
+		for (p++; isspace((UCHAR) *p); p++)
+			;
+	if (*p || nmarkers != num_params)
+		return NULL;
+
+	copylen = tablelen + columnslen + 20;
+	if (NULL == (copy = malloc(copylen)))
+		return NULL;
+	snprintf(copy, copylen, "COPY %.*s %.*s FROM STDIN",
+			 (int) tablelen, table, (int) columnslen, columns ? columns : "");
+	MYLOG(0, "%s\n", copy);
+	if (table_)
+		*table_ = table;
+	if (tablelen_)
+		*tablelen_ = tablelen;
+
+	return copy;
+}
+
+/*
+ * Append the parameters of the current row (exec_current_row) to buf,
+ * as a line of the text format of COPY.
+ */
+BOOL
+build_copy_row(StatementClass *stmt, PQExpBuffer buf)
+{
+	CSTR func = "build_copy_row";
+	QueryBuild	qb;
+	BOOL		ret = FALSE, isnull, isbinary;
+	OID			pgType;
+	int			i;
+
+	if (QB_initialize(&qb, MIN_ALC_SIZE, stmt, RPM_BUILDING_BIND_REQUEST) < 0)
+		return FALSE;
+	/* only bytea values come in binary */
+	qb.flags |= FLGB_BINARY_AS_POSSIBLE | FLGB_COPY_DATA;
+
+	for (i = 0; i < stmt->num_params; i++)
+	{
+		encoded_str	encstr;
+		UCHAR		tchar;
+		size_t		j;
+
+		qb.npos = 0;
+		if (SQL_ERROR == ResolveOneParam(&qb, NULL, &isnull, &isbinary, &pgType))
+		{
+			QB_replace_SC_error(stmt, &qb, func);
+			goto cleanup;
+		}
+		if (i > 0)
+			appendPQExpBufferChar(buf, '\t');
+		if (isnull)
+		{
+			appendPQExpBufferStr(buf, "\\N");
+			continue;
+		}
+		if (isbinary)
+		{
+			appendPQExpBufferStr(buf, "\\\\x");
+			if (!enlargePQExpBuffer(buf, 2 * qb.npos + 1))
+				goto cleanup;
+			buf->len += pg_bin2hex(qb.query_statement, buf->data + buf->len, qb.npos);
+			continue;
+		}
+		/* a trailing byte of a multibyte character isn't an escape */
+		encoded_str_constr(&encstr, qb.ccsc, qb.query_statement);
+		for (j = 0; j < qb.npos; j++)
+		{
+			tchar = encoded_nextchar(&encstr);
+			if (MBCS_NON_ASCII(encstr))
+			{
+				appendPQExpBufferChar(buf, tchar);
+				continue;
+			}
+			switch (tchar)
+			{
+				case '\\':
+					appendPQExpBufferStr(buf, "\\\\");
+					break;
+				case '\n':
+					appendPQExpBufferStr(buf, "\\n");
+					break;
+				case '\r':
+					appendPQExpBufferStr(buf, "\\r");
+					break;
+				case '\t':
+					appendPQExpBufferStr(buf, "\\t");
+					break;
+				default:
+					appendPQExpBufferChar(buf, tchar);
+					break;
+			}
 		}
-		*nParams = pno;
 	}
-
-	/* result format is text */
-	*resultFormat = 0;
-
-	ret = TRUE;
+	appendPQExpBufferChar(buf, '\n');
+	ret = !PQExpBufferDataBroken(*buf);
 
 cleanup:
 	QB_Destructor(&qb);
@@ -4164,16 +5997,37 @@ cleanup:
  */
 #define MAX_NUMERIC_DIGITS 39
 
+#ifdef	NUMERIC_UINT128
+#define	NUMERIC_POW10_19	((SQLUBIGINT) INT64CONST(1000000000000000000) * 10)
+
+static numeric_uint128
+numeric_struct_get_val(const SQL_NUMERIC_STRUCT *ns)
+{
+	numeric_uint128	v = 0;
+	int		i;
+
+	for (i = SQL_MAX_NUMERIC_LEN - 1; i >= 0; i--)
+		v = (v << 8) | ns->val[i];
+	return v;
+}
+
+static void
+numeric_struct_set_val(SQL_NUMERIC_STRUCT *ns, numeric_uint128 v)
+{
+	int		i;
+
+	for (i = 0; i < SQL_MAX_NUMERIC_LEN; i++, v >>= 8)
+		ns->val[i] = (UCHAR) v;
+}
+#endif /* NUMERIC_UINT128 */
+
 /*
  * Convert a SQL_NUMERIC_STRUCT into string representation.
  */
 static void
 ResolveNumericParam(const SQL_NUMERIC_STRUCT *ns, char *chrform)
 {
-	Int4		i, vlen, len, newlen;
-	const UCHAR	*val = (const UCHAR *) ns->val;
-	UCHAR		vals[SQL_MAX_NUMERIC_LEN];
-	int			lastnonzero;
+	Int4		i, len, newlen;
 	UCHAR		calv[MAX_NUMERIC_DIGITS];
 	int			precision;
 
@@ -4190,43 +6044,82 @@ MYLOG(DETAIL_LOG_LEVEL, "C_NUMERIC [prec=%d scale=%d]", ns->precision, ns->scale
 	if (precision > MAX_NUMERIC_DIGITS)
 		precision = MAX_NUMERIC_DIGITS;
 
-	/*
-	 * The representation in SQL_NUMERIC_STRUCT is 16 bytes with most
-	 * significant byte first. Make a working copy.
-	 */
-	memcpy(vals, val, SQL_MAX_NUMERIC_LEN);
+#ifdef	NUMERIC_UINT128
+	{
+		numeric_uint128	v = numeric_struct_get_val(ns);
+		SQLUBIGINT	lo;
+
+		/*
+		 * Output the digits, least significant first, 19 at a time while
+		 * the value doesn't fit in 64 bits.
+		 */
+		len = 0;
+		while ((v >> 64) != 0)
+		{
+			numeric_uint128	q = v / NUMERIC_POW10_19;
+
+			lo = (SQLUBIGINT) (v - q * NUMERIC_POW10_19);
+			for (i = 0; i < 19; i++, lo /= 10)
+				calv[len++] = (UCHAR) (lo % 10);
+			v = q;
+		}
+		lo = (SQLUBIGINT) v;
+		do
+		{
+			calv[len++] = (UCHAR) (lo % 10);
+			lo /= 10;
+		} while (lo != 0);
 
-	vlen = SQL_MAX_NUMERIC_LEN;
-	len = 0;
-	do
+		/* only the lowest 'precision' digits are used */
+		if (len > precision)
+			len = precision;
+	}
+#else
 	{
-		UInt2		d, r;
+		Int4		vlen;
+		UCHAR		vals[SQL_MAX_NUMERIC_LEN];
+		int			lastnonzero;
 
 		/*
-		 * Divide the number by 10, and output the reminder as the next digit.
-		 *
-		 * Begin from the most-significant byte (last in the array), and at
-		 * each step, carry the remainder to the prev byte.
+		 * The representation in SQL_NUMERIC_STRUCT is 16 bytes with most
+		 * significant byte first. Make a working copy.
 		 */
-		r = 0;
-		lastnonzero = -1;
-		for (i = vlen - 1; i >= 0; i--)
+		memcpy(vals, ns->val, SQL_MAX_NUMERIC_LEN);
+
+		vlen = SQL_MAX_NUMERIC_LEN;
+		len = 0;
+		do
 		{
-			UInt2	v;
+			UInt2		d, r;
+
+			/*
+			 * Divide the number by 10, and output the reminder as the next
+			 * digit.
+			 *
+			 * Begin from the most-significant byte (last in the array), and
+			 * at each step, carry the remainder to the prev byte.
+			 */
+			r = 0;
+			lastnonzero = -1;
+			for (i = vlen - 1; i >= 0; i--)
+			{
+				UInt2	v;
 
-			v = ((UInt2) vals[i]) + (r << 8);
-			d = v / 10; r = v % 10;
-			vals[i] = (UCHAR) d;
+				v = ((UInt2) vals[i]) + (r << 8);
+				d = v / 10; r = v % 10;
+				vals[i] = (UCHAR) d;
 
-			if (d != 0 && lastnonzero == -1)
-				lastnonzero = i;
-		}
+				if (d != 0 && lastnonzero == -1)
+					lastnonzero = i;
+			}
 
-		/* output the remainder */
-		calv[len++] = (UCHAR) r;
+			/* output the remainder */
+			calv[len++] = (UCHAR) r;
 
-		vlen = lastnonzero + 1;
-	} while(lastnonzero >= 0 && len < precision);
+			vlen = lastnonzero + 1;
+		} while(lastnonzero >= 0 && len < precision);
+	}
+#endif /* NUMERIC_UINT128 */
 
 	/*
 	 * calv now contains the digits in reverse order, i.e. least significant
@@ -4331,6 +6224,27 @@ parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL *overflow)
 	ns->precision = nlen;
 
 	/* Convert the decimal digits to binary */
+#ifdef	NUMERIC_UINT128
+	{
+		numeric_uint128	v = 0;
+
+		/* 19 digits at a time, which fit in 64 bits */
+		for (dig = 0; dig < nlen;)
+		{
+			SQLUBIGINT	chunk = 0, mult = 1;
+
+			for (i = 0; i < 19 && dig < nlen; i++, dig++)
+			{
+				chunk = chunk * 10 + (calv[dig] - '0');
+				mult *= 10;
+			}
+			if (v != 0 && v > (~(numeric_uint128) 0 - chunk) / mult)
+				*overflow = TRUE;
+			v = v * mult + chunk;
+		}
+		numeric_struct_set_val(ns, v);
+	}
+#else
 	memset(ns->val, 0, sizeof(ns->val));
 	for (dig = 0; dig < nlen; dig++)
 	{
@@ -4350,7 +6264,79 @@ parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL *overflow)
 		if (carry != 0)
 			*overflow = TRUE;
 	}
+#endif /* NUMERIC_UINT128 */
+}
+
+#ifdef	NUMERIC_UINT128
+/*
+ * Convert a numeric in the binary format (base 10000 digits) into
+ * SQL_NUMERIC_STRUCT, giving what parse_to_numeric_struct() does for its
+ * text representation. Returns FALSE for NaN, infinity, and the values of
+ * more than 38 digits, which are left to the text representation.
+ */
+static BOOL
+numeric_binary2struct(const char *value, SQL_NUMERIC_STRUCT *ns)
+{
+	const UCHAR	*p = (const UCHAR *) value;
+	int		ndigits = (Int2) ((p[0] << 8) | p[1]);
+	int		weight = (Int2) ((p[2] << 8) | p[3]);
+	UInt2	sign = (p[4] << 8) | p[5];
+	int		dscale = (p[6] << 8) | p[7];
+	int		intlen, fracgroups, e, i;
+	numeric_uint128	v;
+
+	if ((0x0000 != sign && 0x4000 != sign) || ndigits < 0)
+		return FALSE;
+	for (i = 0; i < ndigits; i++)
+	{
+		if (((p[8 + 2 * i] << 8) | p[8 + 2 * i + 1]) > 9999)
+			return FALSE;
+	}
+
+	/* the number of the digits of the integer part, without leading zeros */
+	intlen = 0;
+	if (ndigits > 0 && weight >= 0)
+	{
+		int	first = (p[8] << 8) | p[9];
+
+		if (0 == first)
+			return FALSE;
+		intlen = 4 * weight + (first >= 1000 ? 4 : first >= 100 ? 3 : first >= 10 ? 2 : 1);
+	}
+	if (intlen + dscale > MAX_NUMERIC_DIGITS - 1)
+		return FALSE;
+
+	/*
+	 * Accumulate the digit groups from the highest one of the integer part
+	 * down to the one with the last digit of the display scale.
+	 */
+	fracgroups = (dscale + 3) / 4;
+	v = 0;
+	for (e = (weight >= 0 ? weight : -1); e >= -fracgroups; e--)
+	{
+		int	d = 0;
+
+		i = weight - e;
+		if (i >= 0 && i < ndigits)
+			d = (p[8 + 2 * i] << 8) | p[8 + 2 * i + 1];
+		if (e == -fracgroups)
+		{
+			int	r = dscale - 4 * (fracgroups - 1);	/* 1..4 digits used */
+			static const int	pow10[] = {1, 10, 100, 1000, 10000};
+
+			v = v * pow10[r] + d / pow10[4 - r];
+		}
+		else
+			v = v * 10000 + d;
+	}
+
+	ns->sign = (0x4000 == sign ? 0 : 1);
+	ns->precision = intlen + dscale;
+	ns->scale = dscale;
+	numeric_struct_set_val(ns, v);
+	return TRUE;
 }
+#endif /* NUMERIC_UINT128 */
 
 static BOOL
 parameter_is_with_cast(const QueryParse *qp)
@@ -4431,6 +6417,351 @@ handle_lu_onvert_error(QueryBuild *qb, int flag, char *buffer, SQLLEN paralen)
 }
 #endif /* UNICODE_SUPPORT */
 
+/*
+ *	Parameters sent in binary format.
+ *
+ *	The layouts are those of the receive functions of the backend
+ *	(network byte order, integer datetimes).
+ */
+#define	NUMERIC_MAX_BINARY_DIGITS	64	/* base 10000 digits */
+#define	BINARY_PARAM_MAX_LEN	(8 + 2 * NUMERIC_MAX_BINARY_DIGITS)
+
+static void
+put_binary_uint16(char *buf, UInt2 value)
+{
+	UCHAR	*p = (UCHAR *) buf;
+
+	p[0] = (UCHAR) (value >> 8);
+	p[1] = (UCHAR) value;
+}
+
+static void
+put_binary_uint32(char *buf, UInt4 value)
+{
+	put_binary_uint16(buf, (UInt2) (value >> 16));
+	put_binary_uint16(buf + 2, (UInt2) value);
+}
+
+static void
+put_binary_int64(char *buf, SQLBIGINT value)
+{
+	put_binary_uint32(buf, (UInt4) ((SQLUBIGINT) value >> 32));
+	put_binary_uint32(buf + 4, (UInt4) value);
+}
+
+/* date2j() of the backend */
+static int
+date2j(int y, int m, int d)
+{
+	int		julian;
+	int		century;
+
+	if (m > 2)
+	{
+		m += 1;
+		y += 4800;
+	}
+	else
+	{
+		m += 13;
+		y += 4799;
+	}
+
+	century = y / 100;
+	julian = y * 365 - 32167;
+	julian += y / 4 - century + century / 4;
+	julian += 7834 * m / 256 + d;
+
+	return julian;
+}
+
+/*
+ * Convert a decimal string like "-123.4500" into the binary numeric
+ * format. Returns the length, or -1 if the string isn't of that form.
+ */
+static int
+numeric_str2binary(const char *str, char *buf)
+{
+	const char	*p = str;
+	BOOL	negative = FALSE;
+	UInt2	digits[NUMERIC_MAX_BINARY_DIGITS];
+	int		intlen, fraclen, lead, ngroups, weight, first, last, i, j;
+
+	if ('-' == *p)
+	{
+		negative = TRUE;
+		p++;
+	}
+	for (intlen = 0; isdigit((UCHAR) p[intlen]); intlen++)
+		;
+	fraclen = 0;
+	if ('.' == p[intlen])
+	{
+		for (; isdigit((UCHAR) p[intlen + 1 + fraclen]); fraclen++)
+			;
+		if ('\0' != p[intlen + 1 + fraclen])
+			return -1;
+	}
+	else if ('\0' != p[intlen])
+		return -1;
+	if (0 == intlen + fraclen)
+		return -1;
+
+	/* group the digits by 4 on both sides of the decimal point */
+	lead = (4 - intlen % 4) % 4;
+	ngroups = (lead + intlen + fraclen + 3) / 4;
+	if (ngroups > NUMERIC_MAX_BINARY_DIGITS)
+		return -1;
+	weight = (lead + intlen) / 4 - 1;
+	for (i = 0; i < ngroups; i++)
+	{
+		UInt2	d = 0;
+
+		for (j = 0; j < 4; j++)
+		{
+			int	pos = i * 4 + j - lead;
+
+			d *= 10;
+			if (pos >= 0 && pos < intlen)
+				d += p[pos] - '0';
+			else if (pos >= intlen && pos < intlen + fraclen)
+				d += p[pos + 1] - '0';
+		}
+		digits[i] = d;
+	}
+	for (first = 0; first < ngroups && 0 == digits[first]; first++)
+		weight--;
+	for (last = ngroups; last > first && 0 == digits[last - 1]; last--)
+		;
+	if (first == last)	/* zero */
+	{
+		weight = 0;
+		negative = FALSE;
+	}
+
+	put_binary_uint16(buf, (UInt2) (last - first));
+	put_binary_uint16(buf + 2, (UInt2) weight);
+	put_binary_uint16(buf + 4, negative ? 0x4000 : 0x0000);
+	put_binary_uint16(buf + 6, (UInt2) fraclen);
+	for (i = first; i < last; i++)
+		put_binary_uint16(buf + 8 + 2 * (i - first), digits[i]);
+
+	return 8 + 2 * (last - first);
+}
+
+/*
+ * Put the value of a parameter of C type ctype into buf in the binary
+ * format of pgtype, the type the server takes the parameter as.
+ *
+ * Returns the length, or -1 if the value should be sent as text (the
+ * conversion isn't a plain one or the value is out of range).
+ */
+static int
+ResolveBinaryParam(OID pgtype, SQLSMALLINT ctype, const char *buffer, char *buf)
+{
+	SQLBIGINT	ival = 0;
+	BOOL		is_int = TRUE;
+	SIMPLE_TIME	st;
+	BOOL		has_time = FALSE;
+
+	memset(&st, 0, sizeof(st));
+	switch (ctype)
+	{
+		case SQL_C_SLONG:
+		case SQL_C_LONG:
+			ival = *((SQLINTEGER *) buffer);
+			break;
+		case SQL_C_ULONG:
+			ival = *((SQLUINTEGER *) buffer);
+			break;
+#ifdef ODBCINT64
+		case SQL_C_SBIGINT:
+			ival = *((SQLBIGINT *) buffer);
+			break;
+		case SQL_C_UBIGINT:
+			ival = (SQLBIGINT) *((SQLUBIGINT *) buffer);
+			if (ival < 0)
+				return -1;
+			break;
+#endif /* ODBCINT64 */
+		case SQL_C_SSHORT:
+		case SQL_C_SHORT:
+			ival = *((SQLSMALLINT *) buffer);
+			break;
+		case SQL_C_USHORT:
+			ival = *((SQLUSMALLINT *) buffer);
+			break;
+		case SQL_C_STINYINT:
+		case SQL_C_TINYINT:
+			ival = *((SCHAR *) buffer);
+			break;
+		case SQL_C_UTINYINT:
+			ival = *((UCHAR *) buffer);
+			break;
+		default:
+			is_int = FALSE;
+			break;
+	}
+
+	switch (pgtype)
+	{
+		case PG_TYPE_INT2:
+			if (!is_int || ival < SHRT_MIN || ival > SHRT_MAX)
+				return -1;
+			put_binary_uint16(buf, (UInt2) ival);
+			return 2;
+		case PG_TYPE_INT4:
+			if (!is_int || ival < INT_MIN || ival > INT_MAX)
+				return -1;
+			put_binary_uint32(buf, (UInt4) ival);
+			return 4;
+		case PG_TYPE_INT8:
+			if (!is_int)
+				return -1;
+			put_binary_int64(buf, ival);
+			return 8;
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+		{
+			double	dval;
+
+			if (is_int)
+				dval = (double) ival;
+			else if (SQL_C_DOUBLE == ctype)
+				dval = *((SDOUBLE *) buffer);
+			else if (SQL_C_FLOAT == ctype)
+			{
+				/*
+				 * The text path sends a float with PG_REAL_DIGITS, which
+				 * float8 stores as the shortest decimal of the float (0.1f
+				 * as 0.100000001). Widening it to float8 bits would store
+				 * 0.10000000149011612 instead.
+				 */
+				if (PG_TYPE_FLOAT8 == pgtype)
+					return -1;
+				dval = *((SFLOAT *) buffer);
+			}
+			else
+				return -1;
+			if (PG_TYPE_FLOAT4 == pgtype)
+			{
+				float	fval = (float) dval;
+				UInt4	bits;
+
+				memcpy(&bits, &fval, sizeof(bits));
+				put_binary_uint32(buf, bits);
+				return 4;
+			}
+			else
+			{
+				SQLBIGINT	bits;
+
+				memcpy(&bits, &dval, sizeof(bits));
+				put_binary_int64(buf, bits);
+				return 8;
+			}
+		}
+		case PG_TYPE_NUMERIC:
+		{
+			char	numstr[150];
+
+			if (is_int)
+				SPRINTF_FIXED(numstr, FORMATI64, ival);
+			else if (SQL_C_NUMERIC == ctype)
+			{
+				if (((SQL_NUMERIC_STRUCT *) buffer)->scale < 0)
+					return -1;
+				ResolveNumericParam((SQL_NUMERIC_STRUCT *) buffer, numstr);
+			}
+			else
+				return -1;
+			return numeric_str2binary(numstr, buf);
+		}
+		case PG_TYPE_UUID:
+		{
+			const SQLGUID	*g = (const SQLGUID *) buffer;
+
+			if (SQL_C_GUID != ctype)
+				return -1;
+			put_binary_uint32(buf, (UInt4) g->Data1);
+			put_binary_uint16(buf + 4, g->Data2);
+			put_binary_uint16(buf + 6, g->Data3);
+			memcpy(buf + 8, g->Data4, sizeof(g->Data4));
+			return 16;
+		}
+		case PG_TYPE_DATE:
+		case PG_TYPE_TIMESTAMP_NO_TMZONE:
+			break;
+		default:
+			return -1;
+	}
+
+	/* date and timestamp */
+	switch (ctype)
+	{
+		case SQL_C_DATE:
+		case SQL_C_TYPE_DATE:
+		{
+			const DATE_STRUCT	*ds = (const DATE_STRUCT *) buffer;
+
+			st.y = ds->year;
+			st.m = ds->month;
+			st.d = ds->day;
+			break;
+		}
+		case SQL_C_TIMESTAMP:
+		case SQL_C_TYPE_TIMESTAMP:
+		{
+			const TIMESTAMP_STRUCT	*tss = (const TIMESTAMP_STRUCT *) buffer;
+
+			/* a date is sent as text to let the server drop the time */
+			if (PG_TYPE_DATE == pgtype)
+				return -1;
+			st.y = tss->year;
+			st.m = tss->month;
+			st.d = tss->day;
+			st.hh = tss->hour;
+			st.mm = tss->minute;
+			st.ss = tss->second;
+			st.fr = tss->fraction;
+			has_time = TRUE;
+			break;
+		}
+		default:
+			return -1;
+	}
+	/* leave BC dates and anything the server would reject to the text path */
+	if (st.y <= 0 || st.y > 9999 ||
+	    st.m < 1 || st.m > 12 ||
+	    st.d < 1 || st.d > 31)
+		return -1;
+	if (has_time &&
+	    (st.hh < 0 || st.hh > 23 ||
+	     st.mm < 0 || st.mm > 59 ||
+	     st.ss < 0 || st.ss > 59 ||
+	     st.fr < 0 || st.fr >= 1000000000))
+		return -1;
+	{
+		int		year, month, day, days;
+
+		days = date2j(st.y, st.m, st.d);
+		j2date(days, &year, &month, &day);
+		if (year != st.y || month != st.m || day != st.d)
+			return -1;	/* e.g. February 30th */
+		days -= POSTGRES_EPOCH_JDATE;
+		if (PG_TYPE_DATE == pgtype)
+		{
+			put_binary_uint32(buf, (UInt4) days);
+			return 4;
+		}
+		/* the text path truncates the fraction to microseconds too */
+		put_binary_int64(buf, days * USECS_PER_DAY +
+			((st.hh * 60 + st.mm) * 60 + st.ss) * INT64CONST(1000000) +
+			st.fr / 1000);
+		return 8;
+	}
+}
+
 /*
  * Resolve one parameter.
  *
@@ -4478,6 +6809,7 @@ ResolveOneParam(QueryBuild *qb, QueryParse *qp, BOOL *isnull, BOOL *isbinary,
 	SQL_INTERVAL_STRUCT	*ivstruct;
 	const char *ivsign;
 	BOOL		final_binary_convert = FALSE;
+	BOOL		terminated = FALSE;
 	RETCODE		retval = SQL_ERROR;
 
 	*isnull = FALSE;
@@ -4722,6 +7054,32 @@ MYLOG(DETAIL_LOG_LEVEL, "ipara=%p paramName=%s paramType=%d %d proc_return=%d\n"
 	cbuf[0] = '\0';
 	memset(&st, 0, sizeof(st));
 
+	/*
+	 * Send the value in binary format if the server has told the type
+	 * of the parameter and the C value converts to it plainly.
+	 */
+	if (req_bind &&
+	    0 != (qb->flags & FLGB_BINARY_AS_POSSIBLE) &&
+	    0 == (qb->flags & FLGB_COPY_DATA) &&
+	    conn->connInfo.binary_parameters &&
+	    !handling_large_object &&
+	    0 != PIC_get_pgtype(*ipara))
+	{
+		char	binbuf[BINARY_PARAM_MAX_LEN];
+		int		binlen;
+
+		binlen = ResolveBinaryParam(PIC_get_pgtype(*ipara), param_ctype, buffer, binbuf);
+		if (binlen >= 0)
+		{
+			MYLOG(DETAIL_LOG_LEVEL, "sending binary parameter type=%u leng=%d\n", PIC_get_pgtype(*ipara), binlen);
+			CVT_APPEND_DATA(qb, binbuf, binlen);
+			*isbinary = TRUE;
+			*pgType = PIC_get_pgtype(*ipara);
+			retval = SQL_SUCCESS;
+			goto cleanup;
+		}
+	}
+
 	ivstruct = (SQL_INTERVAL_STRUCT *) buffer;
 	/* Convert input C type to a neutral format */
 #ifdef	UNICODE_SUPPORT
@@ -5342,7 +7700,10 @@ MYLOG(0, "cvt_null_date_string=%d pgtype=%d send_buf=%p\n", conn->connInfo.cvt_n
 		goto cleanup;
 	}
 	if (used == SQL_NTS)
+	{
 		used = strlen(send_buf);
+		terminated = TRUE;
+	}
 
 	/*
 	 * Ok, we now have the final string representation in 'send_buf', length 'used'.
@@ -5352,7 +7713,25 @@ MYLOG(0, "cvt_null_date_string=%d pgtype=%d send_buf=%p\n", conn->connInfo.cvt_n
 	 * In bind-mode, we don't need to do any quoting.
 	 */
 	if (req_bind)
-		CVT_APPEND_DATA(qb, send_buf, used);
+	{
+		/*
+		 * The application's (or SQLPutData's) buffer itself can be passed
+		 * to libpq, if it's binary data or null-terminated text (libpq
+		 * takes the length of text values from the terminator).
+		 */
+		if (0 != (qb->flags & FLGB_VALUE_BY_REF) &&
+			send_buf == buffer &&
+			(*isbinary ||
+			 terminated ||
+			 apara->data_at_exec ||
+			 (used < apara->buflen && '\0' == send_buf[used])))
+		{
+			qb->byref_value = send_buf;
+			qb->byref_len = used;
+		}
+		else
+			CVT_APPEND_DATA(qb, send_buf, used);
+	}
 	else
 	{
 		if (add_parens)
@@ -6307,16 +8686,25 @@ convert_to_pgbinary(const char *in, char *out, size_t len, QueryBuild *qb)
 }
 
 
-static const char *hextbl = "0123456789ABCDEF";
+/* the two hex digits of each byte value */
+static const char hexpairs[] =
+	"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+	"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+	"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+	"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+	"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+	"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+	"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+	"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
 
 #define	def_bin2hex(type) \
 	(const char *src, type *dst, SQLLEN length) \
 { \
-	const char	*src_wk; \
-	UCHAR		chr; \
+	const UCHAR	*src_wk; \
+	const char	*pair; \
 	type		*dst_wk; \
 	BOOL		backwards; \
-	int		i; \
+	SQLLEN		i; \
  \
 	backwards = FALSE; \
 	if ((char *) dst < src) \
@@ -6328,20 +8716,20 @@ static const char *hextbl = "0123456789ABCDEF";
 		backwards = TRUE; \
 	if (backwards) \
 	{ \
-		for (i = 0, src_wk = src + length - 1, dst_wk = dst + 2 * length - 1; i < length; i++, src_wk--) \
+		for (i = 0, src_wk = (const UCHAR *) src + length - 1, dst_wk = dst + 2 * length - 2; i < length; i++, src_wk--, dst_wk -= 2) \
 		{ \
-			chr = *src_wk; \
-			*dst_wk-- = hextbl[chr % 16]; \
-			*dst_wk-- = hextbl[chr >> 4]; \
+			pair = hexpairs + 2 * *src_wk; \
+			dst_wk[1] = pair[1]; \
+			dst_wk[0] = pair[0]; \
 		} \
 	} \
 	else \
 	{ \
-		for (i = 0, src_wk = src, dst_wk = dst; i < length; i++, src_wk++) \
+		for (i = 0, src_wk = (const UCHAR *) src, dst_wk = dst; i < length; i++, src_wk++, dst_wk += 2) \
 		{ \
-			chr = *src_wk; \
-			*dst_wk++ = hextbl[chr >> 4]; \
-			*dst_wk++ = hextbl[chr % 16]; \
+			pair = hexpairs + 2 * *src_wk; \
+			dst_wk[0] = pair[0]; \
+			dst_wk[1] = pair[1]; \
 		} \
 	} \
 	dst[2 * length] = '\0'; \
@@ -6355,35 +8743,42 @@ pg_bin2whex def_bin2hex(SQLWCHAR)
 static SQLLEN
 pg_bin2hex def_bin2hex(char)
 
+/*
+ * The value of each hex digit. The other characters have their value
+ * minus '0' (modulo 256), which is what they always contributed.
+ */
+static const UCHAR hexvals[256] = {
+	0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf,
+	0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef,
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+	0x30, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+	0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f,
+	0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
+	0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+	0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f,
+	0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+	0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f,
+	0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf,
+	0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf,
+	0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf
+};
+
 SQLLEN
 pg_hex2bin(const char *src, char *dst, SQLLEN length)
 {
-	UCHAR		chr;
-	const char *src_wk;
+	const UCHAR *src_wk;
 	char	   *dst_wk;
 	SQLLEN		i;
-	int		val;
-	BOOL		HByte = TRUE;
 
-	for (i = 0, src_wk = src, dst_wk = dst; i < length; i++, src_wk++)
+	/* two digits a byte, up to the end or a null character */
+	for (i = 0, src_wk = (const UCHAR *) src, dst_wk = dst; i + 1 < length; i += 2, src_wk += 2)
 	{
-		chr = *src_wk;
-		if (!chr)
+		if (!src_wk[0] || !src_wk[1])
 			break;
-		if (chr >= 'a' && chr <= 'f')
-			val = chr - 'a' + 10;
-		else if (chr >= 'A' && chr <= 'F')
-			val = chr - 'A' + 10;
-		else
-			val = chr - '0';
-		if (HByte)
-			*dst_wk = (val << 4);
-		else
-		{
-			*dst_wk += val;
-			dst_wk++;
-		}
-		HByte = !HByte;
+		*dst_wk++ = (char) ((hexvals[src_wk[0]] << 4) + hexvals[src_wk[1]]);
 	}
 	*dst_wk = '\0';
 	return length;
@@ -10,6 +10,7 @@
 #define __CONVERT_H__
 
 #include "psqlodbc.h"
+#include "pqexpbuffer.h"
 
 #ifdef	__cplusplus
 extern "C" {
@@ -23,12 +24,58 @@ extern "C" {
 #define COPY_NO_DATA_FOUND						5
 #define COPY_INVALID_STRING_CONVERSION				6
 
-int	copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, int col);
+int	copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, int col, BOOL binary);
 int	copy_and_convert_field(StatementClass *stmt,
 			OID field_type, int atttypmod,
 			void *value,
 			SQLSMALLINT fCType, int precision,
 			PTR rgbValue, SQLLEN cbValueMax, SQLLEN *pcbValue, SQLLEN *pIndicator);
+int	copy_and_convert_binary_field(StatementClass *stmt,
+			OID field_type, int atttypmod,
+			void *value,
+			SQLSMALLINT fCType, int precision,
+			PTR rgbValue, SQLLEN cbValueMax, SQLLEN *pcbValue, SQLLEN *pIndicator);
+BOOL	pg_binary_result_supported(OID field_type);
+
+/*
+ *	The conversion plan of the bound columns used by SQLFetch() and
+ *	SQLExtendedFetch(). It is compiled from the column bindings and the
+ *	result's column types and reused until either of them changes.
+ */
+typedef SQLLEN (*FetchConverter)(char *value, char *target, SQLLEN buflen);
+typedef SQLLEN (*FetchBatchConverter)(char **values, SQLLEN n, char *target, SQLLEN stride);
+typedef struct
+{
+	int		col;		/* the column number */
+	FetchConverter	convert;	/* NULL for the general conversion */
+	FetchBatchConverter	convert_batch;	/* for column-wise rowsets */
+	SQLLEN		size;		/* the length convert stores */
+	SQLLEN		stride;		/* distance of the values of adjacent rows */
+	SQLLEN		len_stride;	/* distance of the lengths of adjacent rows */
+	/* the inputs the plan was compiled from */
+	OID		field_type;
+	int		atttypmod;
+	BOOL		binary;
+	char		*buffer;
+	SQLLEN		buflen;
+	SQLLEN		*used;
+	SQLLEN		*indicator;
+	SQLSMALLINT	returntype;
+	SQLSMALLINT	precision;
+} FetchPlanCol;
+typedef struct FetchPlan
+{
+	SQLUINTEGER	bind_size;
+	int		num_result_cols;
+	int		num_cols;	/* the number of the bound columns */
+	SQLULEN		offset;		/* SQL_ATTR_ROW_BIND_OFFSET_PTR of the call */
+	FetchPlanCol	*cols;
+} FetchPlan;
+
+BOOL	prepare_fetch_plan(StatementClass *stmt);
+void	free_fetch_plan(FetchPlan *plan);
+int	copy_and_convert_field_planned(StatementClass *stmt, const FetchPlanCol *pc, void *value);
+SQLLEN	copy_and_convert_column_planned(StatementClass *stmt, const FetchPlanCol *pc, char **values, SQLSETPOSIROW first_row, SQLLEN num_rows);
 
 int		copy_statement_with_parameters(StatementClass *stmt, BOOL);
 SQLLEN		pg_hex2bin(const char *in, char *out, SQLLEN len);
@@ -40,6 +87,8 @@ BOOL build_libpq_bind_params(StatementClass *stmt,
 						int **paramLengths,
 						int **paramFormats,
 						int *resultFormat);
+char	*insert_to_copy_statement(const StatementClass *stmt, int num_params, const char **table, size_t *tablelen);
+BOOL	build_copy_row(StatementClass *stmt, PQExpBuffer buf);
 #ifdef	__cplusplus
 }
 #endif
@@ -699,6 +699,30 @@ copyConnAttributes(ConnInfo *ci, const char *attribute, const char *value)
 		ci->keepalive_interval = atoi(value);
 	else if (stricmp(attribute, INI_BATCHSIZE) == 0 || stricmp(attribute, ABBR_BATCHSIZE) == 0)
 		ci->batch_size = atoi(value);
+	else if (stricmp(attribute, INI_FETCHCHUNKSIZE) == 0 || stricmp(attribute, ABBR_FETCHCHUNKSIZE) == 0)
+		ci->fetch_chunk_size = atoi(value);
+	else if (stricmp(attribute, INI_PREFETCHWATERMARK) == 0 || stricmp(attribute, ABBR_PREFETCHWATERMARK) == 0)
+		ci->prefetch_watermark = atoi(value);
+	else if (stricmp(attribute, INI_FETCHTARGETBYTES) == 0 || stricmp(attribute, ABBR_FETCHTARGETBYTES) == 0)
+		ci->fetch_target_bytes = atoi(value);
+	else if (stricmp(attribute, INI_FETCHMAXBYTES) == 0 || stricmp(attribute, ABBR_FETCHMAXBYTES) == 0)
+		ci->fetch_max_bytes = atoi(value);
+	else if (stricmp(attribute, INI_SPILLTHRESHOLD) == 0 || stricmp(attribute, ABBR_SPILLTHRESHOLD) == 0)
+		ci->spill_threshold = atoi(value);
+	else if (stricmp(attribute, INI_RESULTMEMORYLIMIT) == 0 || stricmp(attribute, ABBR_RESULTMEMORYLIMIT) == 0)
+		ci->result_memory_limit = atoi(value);
+	else if (stricmp(attribute, INI_BINARYRESULTS) == 0 || stricmp(attribute, ABBR_BINARYRESULTS) == 0)
+		ci->binary_results = atoi(value);
+	else if (stricmp(attribute, INI_BINARYPARAMETERS) == 0 || stricmp(attribute, ABBR_BINARYPARAMETERS) == 0)
+		ci->binary_parameters = atoi(value);
+	else if (stricmp(attribute, INI_COPYINSERTTHRESHOLD) == 0 || stricmp(attribute, ABBR_COPYINSERTTHRESHOLD) == 0)
+		ci->copy_insert_threshold = atoi(value);
+	else if (stricmp(attribute, INI_PLANCACHESIZE) == 0 || stricmp(attribute, ABBR_PLANCACHESIZE) == 0)
+		ci->plan_cache_size = atoi(value);
+	else if (stricmp(attribute, INI_STMTCACHESIZE) == 0 || stricmp(attribute, ABBR_STMTCACHESIZE) == 0)
+		ci->stmt_cache_size = atoi(value);
+	else if (stricmp(attribute, INI_STREAMRESULTS) == 0 || stricmp(attribute, ABBR_STREAMRESULTS) == 0)
+		ci->stream_results = atoi(value);
 	else if (stricmp(attribute, INI_OPTIONAL_ERRORS) == 0 || stricmp(attribute, ABBR_OPTIONAL_ERRORS) == 0)
 		ci->optional_errors = atoi(value);
 	else if (stricmp(attribute, INI_IGNORETIMEOUT) == 0 || stricmp(attribute, ABBR_IGNORETIMEOUT) == 0)
@@ -1084,6 +1108,30 @@ MYLOG(0, "drivername=%s\n", drivername);
 	if (SQLGetPrivateProfileString(DSN, INI_BATCHSIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		if (0 == (ci->batch_size = atoi(temp)))
 			ci->batch_size = DEFAULT_BATCH_SIZE;
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHCHUNKSIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_chunk_size = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_PREFETCHWATERMARK, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->prefetch_watermark = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHTARGETBYTES, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_target_bytes = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHMAXBYTES, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_max_bytes = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_SPILLTHRESHOLD, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->spill_threshold = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_RESULTMEMORYLIMIT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->result_memory_limit = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_BINARYRESULTS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->binary_results = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_BINARYPARAMETERS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->binary_parameters = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_COPYINSERTTHRESHOLD, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->copy_insert_threshold = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_PLANCACHESIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->plan_cache_size = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_STMTCACHESIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->stmt_cache_size = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_STREAMRESULTS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->stream_results = atoi(temp);
 	if (SQLGetPrivateProfileString(DSN, INI_IGNORETIMEOUT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		ci->ignore_timeout = atoi(temp);
 
@@ -1380,6 +1428,66 @@ writeDSNinfo(const ConnInfo *ci)
 								 INI_BATCHSIZE,
 								 temp,
 								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_chunk_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHCHUNKSIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->prefetch_watermark);
+	SQLWritePrivateProfileString(DSN,
+								 INI_PREFETCHWATERMARK,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_target_bytes);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHTARGETBYTES,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_max_bytes);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHMAXBYTES,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->spill_threshold);
+	SQLWritePrivateProfileString(DSN,
+								 INI_SPILLTHRESHOLD,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->result_memory_limit);
+	SQLWritePrivateProfileString(DSN,
+								 INI_RESULTMEMORYLIMIT,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->binary_results);
+	SQLWritePrivateProfileString(DSN,
+								 INI_BINARYRESULTS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->binary_parameters);
+	SQLWritePrivateProfileString(DSN,
+								 INI_BINARYPARAMETERS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->copy_insert_threshold);
+	SQLWritePrivateProfileString(DSN,
+								 INI_COPYINSERTTHRESHOLD,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->plan_cache_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_PLANCACHESIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->stmt_cache_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_STMTCACHESIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->stream_results);
+	SQLWritePrivateProfileString(DSN,
+								 INI_STREAMRESULTS,
+								 temp,
+								 ODBC_INI);
 	ITOA_FIXED(temp, ci->ignore_timeout);
 	SQLWritePrivateProfileString(DSN,
 								 INI_IGNORETIMEOUT,
@@ -1803,6 +1911,18 @@ CC_conninfo_init(ConnInfo *conninfo, UInt4 option)
 	conninfo->keepalive_interval = -1;
 	conninfo->disable_convert_func = -1;
 	conninfo->batch_size = DEFAULT_BATCH_SIZE;
+	conninfo->fetch_chunk_size = DEFAULT_FETCH_CHUNK_SIZE;
+	conninfo->prefetch_watermark = DEFAULT_PREFETCH_WATERMARK;
+	conninfo->fetch_target_bytes = DEFAULT_FETCH_TARGET_BYTES;
+	conninfo->fetch_max_bytes = DEFAULT_FETCH_MAX_BYTES;
+	conninfo->spill_threshold = DEFAULT_SPILL_THRESHOLD;
+	conninfo->result_memory_limit = DEFAULT_RESULT_MEMORY_LIMIT;
+	conninfo->binary_results = DEFAULT_BINARYRESULTS;
+	conninfo->binary_parameters = DEFAULT_BINARYPARAMETERS;
+	conninfo->copy_insert_threshold = DEFAULT_COPY_INSERT_THRESHOLD;
+	conninfo->plan_cache_size = DEFAULT_PLAN_CACHE_SIZE;
+	conninfo->stmt_cache_size = DEFAULT_STMT_CACHE_SIZE;
+	conninfo->stream_results = DEFAULT_STREAMRESULTS;
 	conninfo->ignore_timeout = DEFAULT_IGNORETIMEOUT;
 	conninfo->wcs_debug = -1;
 	conninfo->fetch_refcursors = -1;
@@ -1906,6 +2026,18 @@ CC_copy_conninfo(ConnInfo *ci, const ConnInfo *sci)
 	CORR_VALCPY(keepalive_idle);
 	CORR_VALCPY(keepalive_interval);
 	CORR_VALCPY(batch_size);
+	CORR_VALCPY(fetch_chunk_size);
+	CORR_VALCPY(prefetch_watermark);
+	CORR_VALCPY(fetch_target_bytes);
+	CORR_VALCPY(fetch_max_bytes);
+	CORR_VALCPY(spill_threshold);
+	CORR_VALCPY(result_memory_limit);
+	CORR_VALCPY(binary_results);
+	CORR_VALCPY(binary_parameters);
+	CORR_VALCPY(copy_insert_threshold);
+	CORR_VALCPY(plan_cache_size);
+	CORR_VALCPY(stmt_cache_size);
+	CORR_VALCPY(stream_results);
 	CORR_VALCPY(ignore_timeout);
 	CORR_VALCPY(fetch_refcursors);
 #ifdef	_HANDLE_ENLIST_IN_DTC_
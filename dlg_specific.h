@@ -175,6 +175,30 @@ extern "C" {
 #define INI_DTCLOG			"Dtclog"
 #define INI_FETCHREFCURSORS		"FetchRefcursors"
 #define ABBR_FETCHREFCURSORS		"DA"
+#define INI_FETCHCHUNKSIZE		"FetchChunkSize"
+#define ABBR_FETCHCHUNKSIZE		"DB"
+#define INI_BINARYRESULTS		"BinaryResults"
+#define ABBR_BINARYRESULTS		"DC"
+#define INI_STREAMRESULTS		"StreamResults"
+#define ABBR_STREAMRESULTS		"DD"
+#define INI_PREFETCHWATERMARK		"PrefetchWatermark"
+#define ABBR_PREFETCHWATERMARK		"DE"
+#define INI_FETCHTARGETBYTES		"FetchTargetBytes"
+#define ABBR_FETCHTARGETBYTES		"DF"
+#define INI_FETCHMAXBYTES		"FetchMaxBytes"
+#define ABBR_FETCHMAXBYTES		"DG"
+#define INI_SPILLTHRESHOLD		"SpillThreshold"
+#define ABBR_SPILLTHRESHOLD		"DH"
+#define INI_RESULTMEMORYLIMIT		"ResultMemoryLimit"
+#define ABBR_RESULTMEMORYLIMIT		"DI"
+#define INI_BINARYPARAMETERS		"BinaryParameters"
+#define ABBR_BINARYPARAMETERS		"DJ"
+#define INI_COPYINSERTTHRESHOLD		"CopyInsertThreshold"
+#define ABBR_COPYINSERTTHRESHOLD	"DK"
+#define INI_PLANCACHESIZE		"PlanCacheSize"
+#define ABBR_PLANCACHESIZE		"DL"
+#define INI_STMTCACHESIZE		"StatementCacheSize"
+#define ABBR_STMTCACHESIZE		"DM"
 /* "PreferLibpq", abbreviated "D4", used to mean whether to prefer libpq.
  * libpq is now required
 #define INI_PREFERLIBPQ			"PreferLibpq"
@@ -278,6 +302,18 @@ extern "C" {
 #define DEFAULT_BATCH_SIZE		100
 #define DEFAULT_IGNORETIMEOUT		0
 #define DEFAULT_FETCHREFCURSORS		0
+#define DEFAULT_FETCH_CHUNK_SIZE	1000
+#define DEFAULT_BINARYRESULTS		0
+#define DEFAULT_STREAMRESULTS		0
+#define DEFAULT_PREFETCH_WATERMARK	0
+#define DEFAULT_FETCH_TARGET_BYTES	0
+#define DEFAULT_FETCH_MAX_BYTES		(64 * 1024 * 1024)
+#define DEFAULT_SPILL_THRESHOLD		0
+#define DEFAULT_RESULT_MEMORY_LIMIT	0
+#define DEFAULT_BINARYPARAMETERS	1
+#define DEFAULT_COPY_INSERT_THRESHOLD	1000
+#define DEFAULT_PLAN_CACHE_SIZE		0
+#define DEFAULT_STMT_CACHE_SIZE		100
 
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 #define DEFAULT_XAOPT			1
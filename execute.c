@@ -116,7 +116,7 @@ PGAPI_Prepare(HSTMT hstmt,
 	}
 
 	self->prepare = PREPARE_STATEMENT;
-	self->statement_type = statement_type(self->statement);
+	SC_set_statement_type(self);
 
 	/* Check if connection is onlyread (only selects are allowed) */
 	if (CC_is_onlyread(SC_get_conn(self)) && STMT_UPDATE(self))
@@ -147,6 +147,9 @@ PGAPI_ExecDirect(HSTMT hstmt,
 
 	MYLOG(0, "entering...%x\n", flag);
 
+	/* called again while the statement is executing asynchronously */
+	if (SC_async_executing(stmt))
+		return PGAPI_Execute(hstmt, flag);
 	if (result = SC_initialize_and_recycle(stmt), SQL_SUCCESS != result)
 		return result;
 
@@ -177,7 +180,7 @@ MYLOG(DETAIL_LOG_LEVEL, "a2\n");
 	if (stmt->status == STMT_DESCRIBED)
 		stmt->status = STMT_FINISHED;
 
-	stmt->statement_type = statement_type(stmt->statement);
+	SC_set_statement_type(stmt);
 
 	/* Check if connection is onlyread (only selects are allowed) */
 	if (CC_is_onlyread(conn) && STMT_UPDATE(stmt))
@@ -424,6 +427,83 @@ void param_status_batch_update(IPDFields *ipdopts, RETCODE retval, SQLLEN target
 	}
 }
 
+#ifdef	LIBPQ_HAS_PIPELINING
+/*
+ * Can the rows of the parameter arrays be executed in libpq pipeline
+ * mode ? Only single INSERT, UPDATE or DELETE statements prepared at the
+ * server are, and only when no row has output or data-at-execution
+ * parameters.
+ */
+static BOOL
+pipeline_is_possible(const StatementClass *stmt, SQLLEN start_row, SQLLEN end_row, SQLSMALLINT num_params)
+{
+	const APDFields	*apdopts = SC_get_APDF(stmt);
+	const IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	SQLULEN		offset = apdopts->param_offset_ptr ? *apdopts->param_offset_ptr : 0;
+	SQLINTEGER	bind_size = apdopts->param_bind_type;
+	SQLLEN		row;
+	int			i;
+
+	if (!stmt->use_server_side_prepare)
+		return FALSE;
+	switch (stmt->statement_type)
+	{
+		case STMT_TYPE_INSERT:
+		case STMT_TYPE_UPDATE:
+		case STMT_TYPE_DELETE:
+			break;
+		default:
+			return FALSE;
+	}
+	if (0 != stmt->multi_statement || 0 != stmt->proc_return)
+		return FALSE;
+	if (num_params <= 0 ||
+		num_params > apdopts->allocated ||
+		num_params > ipdopts->allocated)
+		return FALSE;
+	for (i = 0; i < num_params; i++)
+	{
+		SQLLEN	   *pcVal = apdopts->parameters[i].used;
+
+		if (SQL_PARAM_OUTPUT == ipdopts->parameters[i].paramType ||
+			SQL_PARAM_INPUT_OUTPUT == ipdopts->parameters[i].paramType)
+			return FALSE;
+		if (!pcVal)
+			continue;
+		for (row = start_row; row <= end_row; row++)
+		{
+			SQLLEN	   *used;
+
+			if (bind_size > 0)
+				used = LENADDR_SHIFT(pcVal, offset + bind_size * row);
+			else
+				used = LENADDR_SHIFT(pcVal, offset) + row;
+			if (*used == SQL_DATA_AT_EXEC || *used <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+				return FALSE;
+		}
+	}
+	return TRUE;
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
+/*
+ * Can the rows of the parameter arrays of an INSERT be loaded by COPY
+ * FROM STDIN ? COPY doesn't apply the rules of the table, so a table
+ * with INSERT rules is left to the pipeline.
+ */
+static BOOL
+copy_insert_is_possible(const StatementClass *stmt, SQLSMALLINT num_params)
+{
+	const char	*table;
+	size_t		tablelen;
+	char		*copycmd;
+
+	if (NULL == (copycmd = insert_to_copy_statement(stmt, num_params, &table, &tablelen)))
+		return FALSE;
+	free(copycmd);
+	return !CC_has_insert_rules(SC_get_conn(stmt), table, tablelen);
+}
+
 static
 RETCODE	Exec_with_parameters_resolved(StatementClass *stmt, EXEC_TYPE exec_type, BOOL *exec_end)
 {
@@ -439,6 +519,7 @@ RETCODE	Exec_with_parameters_resolved(StatementClass *stmt, EXEC_TYPE exec_type,
 	char *stmt_with_params;
 	SQLLEN		status_row = stmt->exec_current_row;
 	int		count_of_deffered;
+	BOOL		pipelined = FALSE;
 
 	*exec_end = FALSE;
 	conn = SC_get_conn(stmt);
@@ -450,6 +531,23 @@ RETCODE	Exec_with_parameters_resolved(StatementClass *stmt, EXEC_TYPE exec_type,
 	/* save the cursor's info before the execution */
 	cursor_type = stmt->options.cursor_type;
 	scroll_concurrency = stmt->options.scroll_concurrency;
+	ipdopts = SC_get_IPDF(stmt);
+	apdopts = SC_get_APDF(stmt);
+	if (start_row = stmt->exec_start_row, start_row < 0)
+		start_row = 0;
+	if (end_row = stmt->exec_end_row, end_row < 0)
+	{
+		end_row = (SQLINTEGER) apdopts->paramset_size - 1;
+		if (end_row < 0)
+			end_row = 0;
+	}
+	if (SC_async_executing(stmt))
+	{
+		/* poll the execution of the only row */
+		count_of_deffered = 0;
+		retval = SC_execute(stmt);
+		goto executed;
+	}
 	/* Prepare the statement if possible at backend side */
 	if (HowToPrepareBeforeExec(stmt, FALSE) >= allowParse)
 		prepare_before_exec = TRUE;
@@ -480,7 +578,13 @@ MYLOG(DETAIL_LOG_LEVEL, "prepare_before_exec=%d srv=%d\n", prepare_before_exec,
 		}
 		stmt_with_params = stmt->stmt_with_params;
 		if (!stmt_with_params) // Extended Protocol
+		{
+			/* SC_execute() executes all the remaining rows */
+			pipelined = (PIPELINE_EXEC == exec_type || COPY_EXEC == exec_type);
 			exec_type = DIRECT_EXEC;
+		}
+		else if (PIPELINE_EXEC == exec_type || COPY_EXEC == exec_type)
+			exec_type = stmt->exec_type = DIRECT_EXEC;
 	}
 
 	MYLOG(0, "   stmt_with_params = '%s'\n", stmt->stmt_with_params);
@@ -489,16 +593,6 @@ MYLOG(DETAIL_LOG_LEVEL, "prepare_before_exec=%d srv=%d\n", prepare_before_exec,
 	 *	The real execution.
 	 */
 MYLOG(0, "about to begin SC_execute exec_type=%d\n", exec_type);
-	ipdopts = SC_get_IPDF(stmt);
-	apdopts = SC_get_APDF(stmt);
-	if (start_row = stmt->exec_start_row, start_row < 0)
-		start_row = 0;
-	if (end_row = stmt->exec_end_row, end_row < 0)
-	{
-		end_row = (SQLINTEGER) apdopts->paramset_size - 1;
-		if (end_row < 0)
-			end_row = 0;
-	}
 	if (LAST_EXEC == exec_type &&
 	    NULL != ipdopts->param_status_ptr)
 	{
@@ -516,6 +610,8 @@ MYLOG(0, "about to begin SC_execute exec_type=%d\n", exec_type);
 	if (DIRECT_EXEC == exec_type)
 	{
 		retval = SC_execute(stmt);
+		/* libpq_pipeline_exec() may have fallen back to one row */
+		pipelined = (PIPELINE_EXEC == stmt->exec_type || COPY_EXEC == stmt->exec_type);
 		stmt->count_of_deffered = 0;
 	}
 	else if (DEFFERED_EXEC == exec_type &&
@@ -559,6 +655,9 @@ MYLOG(0, "about to begin SC_execute exec_type=%d\n", exec_type);
 		if (VALID_EXPBUFFER)
 			resetPQExpBuffer(&stmt->stmt_deffered);
 	}
+executed:
+	if (retval == SQL_STILL_EXECUTING)
+		RETURN(retval)
 	if (retval == SQL_ERROR)
 	{
 MYLOG(0, "count_of_deffered=%d\n", count_of_deffered);
@@ -585,7 +684,8 @@ MYLOG(0, "count_of_deffered=%d\n", count_of_deffered);
 		}
 	}
 	ipdopts = SC_get_IPDF(stmt);
-	if (ipdopts->param_status_ptr)
+	/* the pipeline has set the status of each row */
+	if (ipdopts->param_status_ptr && !pipelined)
 	{
 		switch (retval)
 		{
@@ -804,6 +904,7 @@ CC_is_in_trans(conn), SC_is_rb_stmt(stmt), SC_is_tc_stmt(stmt));
 	switch (ret)
 	{
 		case SQL_NEED_DATA:
+		case SQL_STILL_EXECUTING:
 			break;
 		case SQL_ERROR:
 			start_stmt = TRUE;
@@ -936,6 +1037,17 @@ PGAPI_Execute(HSTMT hstmt, UWORD flag)
 
 	MYLOG(0, "entering...%x %p status=%d\n", flag, stmt, stmt->status);
 
+	if (SC_async_executing(stmt))
+	{
+		/*
+		 * Called again while the statement is executing asynchronously,
+		 * which only a single row does.
+		 */
+		retval = Exec_with_parameters_resolved(stmt, DIRECT_EXEC, &exec_end);
+		if (SQL_STILL_EXECUTING == retval)
+			return retval;
+		goto executed;
+	}
 	stmt->has_notice = 0;
 	conn = SC_get_conn(stmt);
 	apdopts = SC_get_APDF(stmt);
@@ -1025,17 +1137,22 @@ PGAPI_Execute(HSTMT hstmt, UWORD flag)
 		   parameters even in case of non-prepared statements.
 		 */
 		int	nCallParse = doNothing;
-		BOOL	maybeBatch = FALSE;
+		BOOL	maybeBatch = FALSE, maybePipeline = FALSE;
 
 		if (end_row > start_row &&
 		    SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type &&
 		    SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency &&
 		    stmt->batch_size > 1)
 			maybeBatch = TRUE;
+#ifdef	LIBPQ_HAS_PIPELINING
+		if (maybeBatch &&
+		    pipeline_is_possible(stmt, start_row, end_row, num_params))
+			maybePipeline = TRUE;
+#endif /* LIBPQ_HAS_PIPELINING */
 MYLOG(0, "prepare=%d prepared=%d  batch_size=%d start_row=" FORMAT_LEN "end_row=" FORMAT_LEN " => maybeBatch=%d\n", stmt->prepare, stmt->prepared, stmt->batch_size, start_row, end_row, maybeBatch);
 		if (NOT_YET_PREPARED == stmt->prepared)
 		{
-			if (maybeBatch)
+			if (maybeBatch && !maybePipeline)
 				stmt->use_server_side_prepare = 0;
 			switch (nCallParse = HowToPrepareBeforeExec(stmt, TRUE))
 			{
@@ -1055,10 +1172,18 @@ MYLOG(0, "prepareParameters was %s called, prepare state:%d\n", shouldParse == n
 		if (0 != (PREPARE_BY_THE_DRIVER & stmt->prepare) &&
 		    maybeBatch)
 			stmt->exec_type = DEFFERED_EXEC;
+		else if (maybePipeline &&
+				 STMT_TYPE_INSERT == stmt->statement_type &&
+				 conn->connInfo.copy_insert_threshold > 0 &&
+				 end_row - start_row + 1 >= conn->connInfo.copy_insert_threshold &&
+				 copy_insert_is_possible(stmt, num_params))
+			stmt->exec_type = COPY_EXEC;
+		else if (maybePipeline)
+			stmt->exec_type = PIPELINE_EXEC;
 		else
 			stmt->exec_type = DIRECT_EXEC;
 
-MYLOG(0, "prepare=%d maybeBatch=%d exec_type=%d\n", stmt->prepare, maybeBatch, stmt->exec_type);
+MYLOG(0, "prepare=%d maybeBatch=%d maybePipeline=%d exec_type=%d\n", stmt->prepare, maybeBatch, maybePipeline, stmt->exec_type);
 		if (ipdopts->param_processed_ptr)
 			*ipdopts->param_processed_ptr = 0;
 		/*
@@ -1179,15 +1304,29 @@ next_param_row:
 
 	if (0 != (flag & PODBC_WITH_HOLD))
 		SC_set_with_hold(stmt);
+	/*
+	 * The statement can be executed asynchronously if it's executed once
+	 * and doesn't need SQLParamData() calls.
+	 */
+	if (0 != (flag & PODBC_ASYNC_EXEC) &&
+		DIRECT_EXEC == stmt->exec_type &&
+		start_row == end_row)
+		SC_set_async_call(stmt);
 	retval = Exec_with_parameters_resolved(stmt, stmt->exec_type, &exec_end);
+	SC_no_async_call(stmt);
+	if (SQL_STILL_EXECUTING == retval)
+		goto cleanup;
 	if (!exec_end)
 	{
 		goto next_param_row;
 	}
 cleanup:
 MYLOG(0, "leaving %p retval=%d status=%d\n", stmt, retval, stmt->status);
-	SC_setInsertedTable(stmt, retval);
 #undef	return
+	if (SQL_STILL_EXECUTING == retval)
+		return retval;
+executed:
+	SC_setInsertedTable(stmt, retval);
 	if (SQL_SUCCESS == retval &&
 	    STMT_OK > SC_get_errornumber(stmt))
 		retval = SQL_SUCCESS_WITH_INFO;
@@ -1289,8 +1428,9 @@ PGAPI_Cancel(HSTMT hstmt)		/* Statement to cancel. */
 	 * 1. In the middle of SQLParamData / SQLPutData
 	 *    -> cancel the statement
 	 *
-	 * 2. Running a query asynchronously. (asynchronous mode is not supported
-	 *    by psqlODBC)
+	 * 2. Running a query asynchronously.
+	 *    -> Send a query cancel request to the server, then wait for
+	 *       the (error) result of the query and discard it
 	 *
 	 * 3. Busy running a function in another thread.
 	 *    -> Send a query cancel request to the server
@@ -1330,8 +1470,14 @@ PGAPI_Cancel(HSTMT hstmt)		/* Statement to cancel. */
 		 */
 		if (!CC_send_cancel_request(conn))
 			return SQL_ERROR;
-		else
-			return SQL_SUCCESS;
+		if (SC_async_executing(estmt))
+		{
+			/* the result of the cancelled execution is discarded */
+			ENTER_STMT_CS(estmt);
+			SC_complete_async_exec(estmt);
+			LEAVE_STMT_CS(estmt);
+		}
+		return SQL_SUCCESS;
 	}
 	else
 	{
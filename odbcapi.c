@@ -314,7 +314,9 @@ SQLExecDirect(HSTMT StatementHandle,
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= PODBC_WITH_HOLD;
-	if (SC_opencheck(stmt, func))
+	if (SQL_ASYNC_ENABLE_ON == stmt->options.async_enable)
+		flag |= PODBC_ASYNC_EXEC;
+	if (!SC_async_executing(stmt) && SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
 	{
@@ -342,7 +344,15 @@ SQLExecute(HSTMT StatementHandle)
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= (PODBC_RECYCLE_STATEMENT | PODBC_WITH_HOLD);
-	if (SC_opencheck(stmt, func))
+	if (SQL_ASYNC_ENABLE_ON == stmt->options.async_enable)
+		flag |= PODBC_ASYNC_EXEC;
+	if (SC_async_executing(stmt))
+	{
+		/* poll the execution started by the previous call */
+		ret = PGAPI_Execute(StatementHandle, flag);
+		ret = DiscardStatementSvp(stmt, ret, FALSE);
+	}
+	else if (SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
 	{
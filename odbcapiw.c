@@ -336,8 +336,10 @@ SQLExecDirectW(HSTMT StatementHandle,
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= PODBC_WITH_HOLD;
+	if (SQL_ASYNC_ENABLE_ON == stmt->options.async_enable)
+		flag |= PODBC_ASYNC_EXEC;
 	StartRollbackState(stmt);
-	if (SC_opencheck(stmt, func))
+	if (!SC_async_executing(stmt) && SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
 		ret = PGAPI_ExecDirect(StatementHandle,
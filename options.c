@@ -41,7 +41,16 @@ set_statement_option(ConnectionClass *conn,
 		ci = &(SC_get_conn(stmt)->connInfo);
 	switch (fOption)
 	{
-		case SQL_ASYNC_ENABLE:	/* ignored */
+		case SQL_ASYNC_ENABLE:
+			/* SQLExecute() and SQLExecDirect() may return SQL_STILL_EXECUTING */
+			MYLOG(0, "SQL_ASYNC_ENABLE, vParam = " FORMAT_LEN "\n", vParam);
+			setval = (SQL_ASYNC_ENABLE_OFF == vParam) ? SQL_ASYNC_ENABLE_OFF : SQL_ASYNC_ENABLE_ON;
+			if (conn)
+				conn->stmtOptions.async_enable = (SQLUINTEGER) setval;
+			if (stmt)
+				stmt->options.async_enable = (SQLUINTEGER) setval;
+			if (setval != vParam)
+				changed = TRUE;
 			break;
 
 		case SQL_BIND_TYPE:
@@ -704,8 +713,8 @@ PGAPI_GetStmtOption(HSTMT hstmt,
 
 			break;
 
-		case SQL_ASYNC_ENABLE:	/* NOT SUPPORTED */
-			*((SQLINTEGER *) pvParam) = SQL_ASYNC_ENABLE_OFF;
+		case SQL_ASYNC_ENABLE:
+			*((SQLINTEGER *) pvParam) = stmt->options.async_enable;
 			break;
 
 		case SQL_BIND_TYPE:
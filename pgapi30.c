@@ -412,7 +412,7 @@ PGAPI_GetConnectAttr(HDBC ConnectionHandle,
 	switch (Attribute)
 	{
 		case SQL_ATTR_ASYNC_ENABLE:
-			*((SQLINTEGER *) Value) = SQL_ASYNC_ENABLE_OFF;
+			*((SQLINTEGER *) Value) = conn->stmtOptions.async_enable;
 			break;
 		case SQL_ATTR_AUTO_IPD:
 			*((SQLINTEGER *) Value) = SQL_FALSE;
@@ -471,6 +471,26 @@ PGAPI_GetConnectAttr(HDBC ConnectionHandle,
 		case SQL_ATTR_PGOPT_IGNORETIMEOUT:
 			*((SQLINTEGER *) Value) = conn->connInfo.ignore_timeout;
 			break;
+		case SQL_ATTR_PGOPT_RESULT_MEMORY:
+			*((SQLULEN *) Value) = CC_get_result_memory(conn, NULL);
+			len = sizeof(SQLULEN);
+			break;
+		case SQL_ATTR_PGOPT_RESULT_MEMORY_LIMIT:
+			*((SQLINTEGER *) Value) = conn->connInfo.result_memory_limit;
+			break;
+		case SQL_ATTR_PGOPT_PLAN_CACHE_SIZE:
+			*((SQLINTEGER *) Value) = conn->connInfo.plan_cache_size;
+			break;
+		case SQL_ATTR_PGOPT_PLAN_CACHE_HITS:
+			*((SQLUINTEGER *) Value) = conn->plan_cache_hits;
+			break;
+		case SQL_ATTR_PGOPT_PLAN_CACHE_MISSES:
+			*((SQLUINTEGER *) Value) = conn->plan_cache_misses;
+			break;
+		case SQL_ATTR_PGOPT_SOCKET:
+			/* to wait for the result of an asynchronous execution */
+			*((SQLINTEGER *) Value) = conn->pqconn ? PQsocket(conn->pqconn) : -1;
+			break;
 		default:
 			ret = PGAPI_GetConnectOption(ConnectionHandle, (UWORD) Attribute, Value, &len, BufferLength);
 	}
@@ -1644,6 +1664,10 @@ PGAPI_GetStmtAttr(HSTMT StatementHandle,
 		case SQL_ATTR_ENABLE_AUTO_IPD:	/* 15 */
 			*((SQLUINTEGER *) Value) = SQL_FALSE;
 			break;
+		case SQL_ATTR_PGOPT_RESULT_MEMORY:
+			*((SQLULEN *) Value) = SC_get_result_memory(stmt, NULL);
+			len = sizeof(SQLULEN);
+			break;
 		case SQL_ATTR_AUTO_IPD:	/* 10001 */
 			/* case SQL_ATTR_ROW_BIND_TYPE: ** == SQL_BIND_TYPE(ODBC2.0) */
 			SC_set_error(stmt, DESC_INVALID_OPTION_IDENTIFIER, "Unsupported statement option (Get)", func);
@@ -1710,7 +1734,6 @@ PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			if (SQL_FALSE != Value)
 				unsupported = TRUE;
 			break;
-		case SQL_ATTR_ASYNC_ENABLE:
 		case SQL_ATTR_CONNECTION_DEAD:
 		case SQL_ATTR_CONNECTION_TIMEOUT:
 			unsupported = TRUE;
@@ -1806,6 +1829,14 @@ PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			conn->connInfo.ignore_timeout = CAST_PTR(SQLINTEGER, Value);
 			MYLOG(0, "ignore_timeout => %d\n", conn->connInfo.ignore_timeout);
 			break;
+		case SQL_ATTR_PGOPT_RESULT_MEMORY_LIMIT:
+			conn->connInfo.result_memory_limit = CAST_PTR(SQLINTEGER, Value);
+			MYLOG(0, "result_memory_limit => %d\n", conn->connInfo.result_memory_limit);
+			break;
+		case SQL_ATTR_PGOPT_PLAN_CACHE_SIZE:
+			conn->connInfo.plan_cache_size = CAST_PTR(SQLINTEGER, Value);
+			MYLOG(0, "plan_cache_size => %d\n", conn->connInfo.plan_cache_size);
+			break;
 		default:
 			if (Attribute < 65536)
 				ret = PGAPI_SetConnectOption(ConnectionHandle, (SQLUSMALLINT) Attribute, (SQLLEN) Value);
@@ -2057,6 +2088,19 @@ RETCODE	bulk_ope_callback(RETCODE retcode, void *para)
 	}
 	s->need_data_callback = FALSE;
 	res = SC_get_Curres(s->stmt);
+	/* try to add the whole rowset at once, falling back to one row at a time */
+	if (SQL_ADD == s->operation && 0 == s->idx)
+	{
+		SQLSETPOSIROW	added;
+		RETCODE		bret = SC_pos_add_rowset(s->stmt, s->opts->size_of_rowset, &added);
+
+		s->processed = s->idx = (int) added;
+		if (SQL_NO_DATA_FOUND != bret)
+		{
+			ret = bret;
+			s->idx = (int) s->opts->size_of_rowset;
+		}
+	}
 	for (; SQL_ERROR != ret && s->idx < s->opts->size_of_rowset; s->idx++)
 	{
 		if (SQL_ADD != s->operation)
@@ -26,6 +26,7 @@ extern "C" {
 #define	PODBC_WITH_HOLD			1L
 #define	PODBC_RDONLY			(1L << 1)
 #define	PODBC_RECYCLE_STATEMENT		(1L << 2)
+#define	PODBC_ASYNC_EXEC		(1L << 3)
 /*	Flags for the error handling */
 #define	PODBC_ALLOW_PARTIAL_EXTRACT	1L
 /* #define	PODBC_ERROR_CLEAR		(1L << 1) 	no longer used */
@@ -317,6 +318,12 @@ enum {
 	,SQL_ATTR_PGOPT_MSJET = 65549
 	,SQL_ATTR_PGOPT_BATCHSIZE = 65550
 	,SQL_ATTR_PGOPT_IGNORETIMEOUT = 65551
+	,SQL_ATTR_PGOPT_RESULT_MEMORY = 65552	/* read only, SQLGetStmtAttr() too */
+	,SQL_ATTR_PGOPT_RESULT_MEMORY_LIMIT = 65553
+	,SQL_ATTR_PGOPT_PLAN_CACHE_SIZE = 65554
+	,SQL_ATTR_PGOPT_PLAN_CACHE_HITS = 65555	/* read only */
+	,SQL_ATTR_PGOPT_PLAN_CACHE_MISSES = 65556	/* read only */
+	,SQL_ATTR_PGOPT_SOCKET = 65557	/* read only */
 };
 RETCODE SQL_API PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			SQLINTEGER Attribute, PTR Value,
@@ -540,6 +540,7 @@ typedef struct StatementOptions_
 	void			*bookmark_ptr;
 	SQLUINTEGER		metadata_id;
 	SQLULEN			stmt_timeout;
+	SQLUINTEGER		async_enable;
 } StatementOptions;
 
 /*	Used to pass extra query info to send_query */
@@ -646,10 +647,22 @@ typedef struct
 	signed char	optional_errors;
 	signed char	ignore_timeout;
 	signed char	fetch_refcursors;
+	signed char	binary_results;
+	signed char	stream_results;
+	signed char	binary_parameters;
 	UInt4		extra_opts;
 	Int4		keepalive_idle;
 	Int4		keepalive_interval;
 	Int4		batch_size;
+	Int4		fetch_chunk_size;
+	Int4		prefetch_watermark;
+	Int4		fetch_target_bytes;
+	Int4		fetch_max_bytes;
+	Int4		spill_threshold;	/* in megabytes */
+	Int4		result_memory_limit;	/* in megabytes */
+	Int4		copy_insert_threshold;
+	Int4		plan_cache_size;
+	Int4		stmt_cache_size;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	signed char	xa_opt;
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -25,9 +25,21 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#ifndef	WIN32
+#include <sys/time.h>
+#endif /* WIN32 */
 
 static BOOL QR_prepare_for_tupledata(QResultClass *self);
-static BOOL QR_read_tuples_from_pgres(QResultClass *, PGresult **pgres);
+static BOOL QR_read_tuples_from_pgres(QResultClass *, PGresult **pgres, BOOL hold_pgres);
+static BOOL QR_hold_pgres(QResultClass *, PGresult *pgres);
+static void QR_release_held_pgres(QResultClass *);
+static BOOL QR_check_memory_limit(QResultClass *, const PGresult *pgres);
+static void QR_sub_malloced_size(QResultClass *self, const TupleField *tuple, SQLLEN count);
+static SQLULEN values_size(const TupleField *tuple, SQLLEN count);
+static void QR_prefetch_next_block(QResultClass *self, StatementClass *stmt, Int4 fetch_size);
+static BOOL QR_read_prefetched(QResultClass *self, StatementClass *stmt, Int4 fetch_size);
+static void QR_adapt_fetch_size(QResultClass *self, SQLLEN start, SQLLEN num_rows, double msec);
+static double current_msec(void);
 
 /*
  *	Used for building a Manual Result only
@@ -211,6 +223,18 @@ QR_Constructor(void)
 		rv->num_fields = 0;
 		rv->num_key_fields = PG_NUM_NORMAL_KEYS; /* CTID + OID */
 		rv->tupleField = NULL;
+		TA_init(&rv->value_arena);
+		rv->held_pgres = NULL;
+		rv->num_held_pgres = 0;
+		rv->count_held_pgres_allocated = 0;
+		rv->held_pgres_size = 0;
+		rv->malloced_size = 0;
+		rv->accounted_size = 0;
+		rv->prefetched = NULL;
+		rv->prefetch_size = 0;
+		rv->adaptive_fetch_size = 0;
+		rv->fetched_bytes = 0;
+		rv->fetched_rows = 0;
 		rv->cursor_name = NULL;
 		rv->aborted = FALSE;
 
@@ -269,6 +293,7 @@ QR_close_result(QResultClass *self, BOOL destroy)
 				}
 			}
 		}
+		QR_discard_streaming_rows(self);
 
 		QR_free_memory(self);		/* safe to call anyway */
 
@@ -480,13 +505,34 @@ QR_free_memory(QResultClass *self)
 
 	if (self->backend_tuples)
 	{
-		ClearCachedRows(self->backend_tuples, num_fields, num_backend_rows);
+		if (!QR_values_in_arena(self))
+			ClearCachedRows(self->backend_tuples, num_fields, num_backend_rows);
 		free(self->backend_tuples);
 		self->count_backend_allocated = 0;
 		self->backend_tuples = NULL;
 		self->dataFilled = FALSE;
 		self->tupleField = NULL;
 	}
+	TA_free(&self->value_arena);
+	QR_release_held_pgres(self);
+	if (self->held_pgres)
+	{
+		free(self->held_pgres);
+		self->held_pgres = NULL;
+		self->count_held_pgres_allocated = 0;
+	}
+	/* The rows fetched in advance are no longer needed */
+	if (self->prefetch_size > 0)
+	{
+		ConnectionClass	*conn = QR_get_conn(self);
+
+		if (NULL != conn && conn->prefetch_res == self)
+			CC_finish_pending_rows(conn);
+		if (self->prefetched)
+			PQclear(self->prefetched);
+		self->prefetched = NULL;
+		self->prefetch_size = 0;
+	}
 	if (self->keyset)
 	{
 		ConnectionClass	*conn = QR_get_conn(self);
@@ -569,10 +615,15 @@ QR_free_memory(QResultClass *self)
 	self->up_count = 0;
 
 	self->num_total_read = 0;
+	self->adaptive_fetch_size = 0;
+	self->fetched_bytes = 0;
+	self->fetched_rows = 0;
 	self->num_cached_rows = 0;
 	self->num_cached_keys = 0;
 	self->cursTuple = -1;
 	self->pstatus = 0;
+	self->malloced_size = 0;
+	QR_account_memory(self);
 
 	MYLOG(0, "leaving\n");
 }
@@ -594,6 +645,7 @@ QR_from_PGresult(QResultClass *self, StatementClass *stmt, ConnectionClass *conn
 	Int2		dummy1, dummy2;
 	int			cidx;
 	BOOL		reached_eof_now = FALSE;
+	BOOL		hold_pgres = FALSE;
 
 	if (NULL != conn)
 		/* First, get column information */
@@ -635,6 +687,7 @@ QR_from_PGresult(QResultClass *self, StatementClass *stmt, ConnectionClass *conn
 		QLOG(0, "\tfieldname='%s', adtid=%d, adtsize=%d, atttypmod=%d (rel,att)=(%d,%d)\n", new_field_name, new_adtid, new_adtsize, new_atttypmod, new_relid, new_attid);
 
 		CI_set_field_info(QR_get_fields(self), lf, new_field_name, new_adtid, new_adtsize, new_atttypmod, new_relid, new_attid);
+		CI_get_format(QR_get_fields(self), lf) = (Int2) PQfformat(*pgres, lf);
 
 		QR_set_rstatus(self, PORES_FIELDS_OK);
 		self->num_fields = CI_get_num_fields(QR_get_fields(self));
@@ -668,7 +721,29 @@ MYLOG(DETAIL_LOG_LEVEL, "[%d].PGType %u->%u\n", i, PIC_get_pgtype(ipdopts->param
 
 	/* Then, get the data itself */
 	num_cached_rows = self->num_cached_rows;
-	if (!QR_read_tuples_from_pgres(self, pgres))
+	/* The values are kept in the tuple arena unless the cache has other ones */
+	if (0 == num_cached_rows)
+	{
+		QR_set_values_in_arena(self);
+		/*
+		 * The rows of a non-updatable forward-only result are never
+		 * replaced, so the cache can refer to the values in the PGresult
+		 * instead of copying them.
+		 */
+		if (NULL == cursor && !QR_haskeyset(self) &&
+			(NULL == stmt ||
+			 (SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type &&
+			  SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency)))
+			hold_pgres = TRUE;
+		/*
+		 * Scrollable results keep all the rows, so let the values spill
+		 * to a temporary file when they get too big.
+		 */
+		else if (NULL != QR_get_conn(self) &&
+				 QR_get_conn(self)->connInfo.spill_threshold > 0)
+			TA_set_spill(&self->value_arena, (size_t) QR_get_conn(self)->connInfo.spill_threshold * 1024 * 1024);
+	}
+	if (!QR_read_tuples_from_pgres(self, pgres, hold_pgres))
 		return FALSE;
 
 MYLOG(DETAIL_LOG_LEVEL, "!!%p->cursTup=" FORMAT_LEN " total_read=" FORMAT_ULEN "\n", self, self->cursTuple, self->num_total_read);
@@ -694,15 +769,121 @@ MYLOG(DETAIL_LOG_LEVEL, "!!%p->cursTup=" FORMAT_LEN " total_read=" FORMAT_ULEN "
 
 	/*
 	 * Also fill in command tag. (Typically, it's SELECT, but can also be
-	 * a FETCH.)
+	 * a FETCH.) The PGresult held by self has set it already.
 	 */
-	QR_set_command(self, PQcmdStatus(*pgres));
+	if (NULL != *pgres)
+		QR_set_command(self, PQcmdStatus(*pgres));
 	QR_set_cursor(self, cursor);
-	if (NULL == cursor)
+	if (NULL == cursor && !QR_stream_pending(self))
 		QR_set_reached_eof(self);
 	return TRUE;
 }
 
+/*
+ * Read the next num_rows rows of a streaming result into the tuple cache,
+ * or all the rest of them if num_rows is 0.
+ *
+ * All the rest of the rows are read when the connection is needed for
+ * another command. They are copied into the tuple arena then, which
+ * spills to a temporary file past SpillThreshold (or
+ * STREAM_SPILL_THRESHOLD megabytes if it's 0), instead of holding all the
+ * PGresults in memory.
+ */
+#define	STREAM_SPILL_THRESHOLD	64
+BOOL
+QR_read_streaming_rows(QResultClass *self, SQLLEN num_rows)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	PGresult	*pgres;
+	BOOL		ret = TRUE, hold_pgres = TRUE;
+	int		func_cs_count = 0;
+
+	if (NULL == conn)
+		return TRUE;
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	if (!QR_stream_pending(self))
+		goto cleanup;
+	conn->streaming_res = NULL;
+	if (NULL == conn->pqconn)
+	{
+		QR_set_reached_eof(self);
+		goto cleanup;
+	}
+	MYLOG(0, "reading " FORMAT_LEN " rows of %p\n", num_rows, self);
+	if (0 == num_rows)
+	{
+		size_t	spill_threshold = conn->connInfo.spill_threshold > 0 ? conn->connInfo.spill_threshold : STREAM_SPILL_THRESHOLD;
+
+		hold_pgres = FALSE;
+		if (QR_values_in_arena(self))
+			TA_set_spill(&self->value_arena, spill_threshold * 1024 * 1024);
+	}
+	self->cache_size = (num_rows > 0 ? self->num_cached_rows + num_rows : 0);
+	if (NULL != (pgres = PQgetResult(conn->pqconn)))
+		ret = QR_read_tuples_from_pgres(self, &pgres, hold_pgres);
+	if (!QR_stream_pending(self))
+	{
+		/* reached the end of the rows or an error occurred */
+		if (NULL != pgres)
+		{
+			if (ret && PGRES_TUPLES_OK == PQresultStatus(pgres))
+				QR_set_command(self, PQcmdStatus(pgres));
+			PQclear(pgres);
+		}
+		while (NULL != (pgres = PQgetResult(conn->pqconn)))
+			PQclear(pgres);
+		QR_set_reached_eof(self);
+	}
+
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+	return ret;
+}
+
+/*
+ * Throw away the rows of a streaming result which haven't been read yet.
+ */
+void
+QR_discard_streaming_rows(QResultClass *self)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	PGresult	*pgres;
+	int		func_cs_count = 0;
+
+	if (NULL == conn)
+		return;
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	if (!QR_stream_pending(self))
+		goto cleanup;
+	conn->streaming_res = NULL;
+	QR_set_reached_eof(self);
+	if (NULL == conn->pqconn)
+		goto cleanup;
+	MYLOG(0, "discarding the rest of the rows of %p\n", self);
+	/*
+	 * Cancelling the query would abort the transaction, so it's only
+	 * done outside of a transaction block.
+	 */
+	if (!CC_is_in_trans(conn))
+	{
+		PGcancel	*cancel;
+		char		dummy[8];
+
+		if (NULL != (cancel = PQgetCancel(conn->pqconn)))
+		{
+			PQcancel(cancel, dummy, sizeof(dummy));
+			PQfreeCancel(cancel);
+		}
+	}
+	while (NULL != (pgres = PQgetResult(conn->pqconn)))
+		PQclear(pgres);
+
+cleanup:
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+}
+
 
 /*
  *	Procedure needed when closing cursors.
@@ -806,6 +987,9 @@ QR_prepare_for_tupledata(QResultClass *self)
 	SQLULEN num_total_rows = QR_get_num_total_tuples(self);
 
 MYLOG(DETAIL_LOG_LEVEL, "entering %p->num_fields=%d\n", self, self->num_fields);
+	/* A streaming result only keeps the rows read in the cache */
+	if (QR_is_streaming(self))
+		num_total_rows = self->num_cached_rows;
 	if (!QR_get_cursor(self))
 	{
 
@@ -954,6 +1138,8 @@ QR_next_tuple(QResultClass *self, StatementClass *stmt)
 	ConnectionClass	*conn;
 	ConnInfo   *ci;
 	BOOL		reached_eof_now = FALSE, curr_eof; /* detecting EOF is pretty important */
+	BOOL		prefetched;
+	double		fetch_start = 0;
 
 MYLOG(DETAIL_LOG_LEVEL, "Oh %p->fetch_number=" FORMAT_LEN "\n", self, self->fetch_number);
 MYLOG(DETAIL_LOG_LEVEL, "in total_read=" FORMAT_ULEN " cursT=" FORMAT_LEN " currT=" FORMAT_LEN " ad=%d total=" FORMAT_ULEN " rowsetSize=%d\n", self->num_total_read, self->cursTuple, stmt->currTuple, self->ad_count, QR_get_num_total_tuples(self), self->rowset_size_include_ommitted);
@@ -965,6 +1151,14 @@ MYLOG(DETAIL_LOG_LEVEL, "in total_read=" FORMAT_ULEN " cursT=" FORMAT_LEN " curr
 	/* Determine the optimum cache size.  */
 	ci = &(conn->connInfo);
 	fetch_size = ci->drivers.fetch_max;
+	if (ci->fetch_target_bytes > 0 && NULL != QR_get_cursor(self))
+	{
+		/* learn the row size from the rows fetched with DECLARE */
+		if (0 == self->fetched_rows)
+			QR_adapt_fetch_size(self, 0, num_backend_rows, 0);
+		if (self->adaptive_fetch_size > 0)
+			fetch_size = self->adaptive_fetch_size;
+	}
 	if ((Int4)req_size > fetch_size)
 		fetch_size = req_size;
 	if (QR_once_reached_eof(self) && self->cursTuple >= (Int4) QR_get_num_total_read(self))
@@ -1069,6 +1263,7 @@ MYLOG(DETAIL_LOG_LEVEL, "moved=" FORMAT_ULEN " ? " FORMAT_ULEN "\n", moved, move
 MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 		/* move to next row */
 		QR_inc_next_in_cache(self);
+		QR_prefetch_next_block(self, stmt, fetch_size);
 		RETURN(TRUE)
 	}
 	else if (QR_once_reached_eof(self))
@@ -1094,6 +1289,36 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 	 */
 	self->tupleField = NULL;
 
+	if (QR_stream_pending(self))
+	{
+		SQLLEN	num_rows;
+
+		if (QR_get_rowstart_in_cache(self) >= num_backend_rows)
+		{
+			/* All the cached rows have been fetched. Read the next block. */
+			if (req_size > 0 && 0 != fetch_size % req_size)
+				fetch_size += req_size - fetch_size % req_size;
+			QR_clear_cached_rows(self, self->backend_tuples, num_fields, num_backend_rows);
+			QR_set_num_cached_rows(self, 0);
+			QR_set_rowstart_in_cache(self, 0);
+			QR_set_next_in_cache(self, (SQLLEN) 0);
+			num_rows = fetch_size;
+		}
+		else
+			/* The rowset extends beyond the cached rows */
+			num_rows = end_tuple - num_backend_rows;
+		MYLOG(0, "STREAMING: reading " FORMAT_LEN " rows, fetch_number = " FORMAT_LEN "\n", num_rows, self->fetch_number);
+		if (!QR_read_streaming_rows(self, num_rows))
+			RETURN(FALSE)
+		if (self->fetch_number < (SQLLEN) self->num_cached_rows)
+		{
+			self->tupleField = self->backend_tuples + (self->fetch_number * num_fields);
+			QR_inc_next_in_cache(self);
+			RETURN(TRUE)
+		}
+		RETURN(-1)		/* end of tuples */
+	}
+
 	if (!QR_get_cursor(self))
 	{
 		MYLOG(0, "ALL_ROWS: done, fcount = " FORMAT_ULEN ", fetch_number = " FORMAT_LEN "\n", QR_get_num_total_tuples(self), fetch_number);
@@ -1102,16 +1327,20 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 		RETURN(-1)		/* end of tuples */
 	}
 
+	/* Has the FETCH been sent in advance ? */
+	prefetched = (self->prefetch_size > 0);
 	if (QR_get_rowstart_in_cache(self) >= num_backend_rows ||
 		QR_is_moving(self))
 	{
 		TupleField *tuple = self->backend_tuples;
 
+		if (prefetched)
+			fetch_size = self->prefetch_size;
 		/* not a correction */
 		self->cache_size = fetch_size;
 		/* clear obsolete tuples */
 MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_rows);
-		ClearCachedRows(tuple, num_fields, num_backend_rows);
+		QR_clear_cached_rows(self, tuple, num_fields, num_backend_rows);
 		self->dataFilled = FALSE;
 		QR_stop_movement(self);
 		self->move_offset = 0;
@@ -1131,6 +1360,8 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 			MYLOG(0, "corrupted fetch_size end_tuple=" FORMAT_LEN " <= cached_rows=" FORMAT_LEN "\n", end_tuple, num_backend_rows);
 			RETURN(-1)
 		}
+		if (prefetched)
+			fetch_size = self->prefetch_size;
 		/* and enlarge the cache size */
 		self->cache_size += fetch_size;
 		offset = self->fetch_number;
@@ -1146,7 +1377,10 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 			 "fetch %d in \"%s\"",
 			 fetch_size, QR_get_cursor(self));
 
-	MYLOG(0, "sending actual fetch (%d) query '%s'\n", fetch_size, fetch);
+	if (prefetched)
+		MYLOG(0, "reading the prefetched rows (%d)\n", fetch_size);
+	else
+		MYLOG(0, "sending actual fetch (%d) query '%s'\n", fetch_size, fetch);
 	if (!boundary_adjusted)
 	{
 		QR_set_num_cached_rows(self, 0);
@@ -1154,17 +1388,31 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 	}
 	num_rows_in = self->num_cached_rows;
 
-	/* don't read ahead for the next tuple (self) ! */
-	qi.row_size = self->cache_size;
-	qi.fetch_size = fetch_size;
-	qi.result_in = self;
-	qi.cursor = NULL;
-	res = CC_send_query(conn, fetch, &qi, READ_ONLY_QUERY, stmt);
-	if (!QR_command_maybe_successful(res))
+	if (ci->fetch_target_bytes > 0)
+		fetch_start = current_msec();
+	if (prefetched)
 	{
-		if (!QR_get_message(self))
-			QR_set_message(self, "Error fetching next group.");
-		RETURN(FALSE)
+		if (!QR_read_prefetched(self, stmt, fetch_size))
+		{
+			if (!QR_get_message(self))
+				QR_set_message(self, "Error fetching next group.");
+			RETURN(FALSE)
+		}
+	}
+	else
+	{
+		/* don't read ahead for the next tuple (self) ! */
+		qi.row_size = self->cache_size;
+		qi.fetch_size = fetch_size;
+		qi.result_in = self;
+		qi.cursor = NULL;
+		res = CC_send_query(conn, fetch, &qi, READ_ONLY_QUERY, stmt);
+		if (!QR_command_maybe_successful(res))
+		{
+			if (!QR_get_message(self))
+				QR_set_message(self, "Error fetching next group.");
+			RETURN(FALSE)
+		}
 	}
 	cur_fetch = 0;
 
@@ -1177,6 +1425,8 @@ MYLOG(DETAIL_LOG_LEVEL, "reached_eof_now=%d\n", reached_eof_now);
 	MYLOG(0, ": PGresult: cursTuple = " FORMAT_LEN ", offset = " FORMAT_LEN "\n", self->cursTuple, offset);
 
 	cur_fetch = self->num_cached_rows - num_rows_in;
+	if (ci->fetch_target_bytes > 0)
+		QR_adapt_fetch_size(self, num_rows_in, cur_fetch, current_msec() - fetch_start);
 	if (!ret)
 		RETURN(ret)
 
@@ -1223,7 +1473,7 @@ MYLOG(DETAIL_LOG_LEVEL, "will add " FORMAT_LEN " added_tuples from " FORMAT_LEN
 				tuple = self->backend_tuples + num_fields * num_backend_rows;
 				memset(tuple, 0, sizeof(TupleField) * num_fields * add_size);
 				added_tuple = self->added_tuples + num_fields * start_idx;
-				ReplaceCachedRows(tuple, added_tuple, num_fields, add_size);
+				QR_replace_cached_rows(self, tuple, added_tuple, num_fields, add_size);
 				self->num_cached_rows += add_size;
 				self->num_cached_keys += add_size;
 				num_backend_rows = self->num_cached_rows;
@@ -1284,7 +1534,7 @@ MYLOG(DETAIL_LOG_LEVEL, "will add " FORMAT_LEN " added_tuples from " FORMAT_LEN
 				if (0 == (self->keyset[lf].status & CURS_NEEDS_REREAD))
 					continue;
 				self->keyset[lf] = self->updated_keyset[i];
-				ReplaceCachedRows(self->backend_tuples + lf * num_fields, self->updated_tuples + i * num_fields, num_fields, 1);
+				QR_replace_cached_rows(self, self->backend_tuples + lf * num_fields, self->updated_tuples + i * num_fields, num_fields, 1);
 				self->keyset[lf].status &= (~CURS_NEEDS_REREAD);
 			}
 		}
@@ -1304,15 +1554,178 @@ MYLOG(DETAIL_LOG_LEVEL, "returning %d offset=" FORMAT_LEN "\n", ret, offset);
 	return ret;
 }
 
+/*
+ * Send the FETCH for the next block of a forward-only cursor without
+ * waiting for its result, once the rows in the cache have been read up to
+ * the PrefetchWatermark percentage. QR_next_tuple() reads the result
+ * when the cache is exhausted.
+ */
+static void
+QR_prefetch_next_block(QResultClass *self, StatementClass *stmt, Int4 fetch_size)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	Int4		watermark = conn->connInfo.prefetch_watermark;
+	char		fetch[128];
+	int		func_cs_count = 0;
+
+	if (watermark <= 0)
+		return;
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	if (NULL == conn->pqconn)
+		goto cleanup;
+	if (conn->prefetch_res == self)
+	{
+		/* let libpq take in the rows which have arrived meanwhile */
+		if (0 == self->fetch_number % 64)
+			PQconsumeInput(conn->pqconn);
+		goto cleanup;
+	}
+	if (self->prefetch_size > 0 ||
+	    NULL == QR_get_cursor(self) ||
+	    QR_once_reached_eof(self) ||
+	    QR_haskeyset(self) ||
+	    SQL_CURSOR_FORWARD_ONLY != stmt->options.cursor_type ||
+	    NULL != conn->streaming_res ||
+	    NULL != conn->prefetch_res ||
+	    NULL != conn->async_stmt)
+		goto cleanup;
+	if (self->fetch_number < (SQLLEN) self->num_cached_rows * watermark / 100)
+		goto cleanup;
+	/* CC_send_query() would precede the FETCH with an internal savepoint */
+	if (!CC_started_rbpoint(conn) &&
+	    0 == (conn->opt_previous & SVPOPT_RDONLY) &&
+	    SC_is_rb_stmt(SC_get_ancestor(stmt)))
+		goto cleanup;
+
+	SPRINTF_FIXED(fetch,
+			 "fetch %d in \"%s\"",
+			 fetch_size, QR_get_cursor(self));
+	QLOG(0, "PQsendQuery: %p '%s'\n", conn->pqconn, fetch);
+	if (!PQsendQuery(conn->pqconn, fetch))
+	{
+		MYLOG(0, "couldn't send the prefetch: %s\n", PQerrorMessage(conn->pqconn));
+		goto cleanup;
+	}
+	MYLOG(0, "prefetching %d rows after row " FORMAT_LEN " of " FORMAT_ULEN "\n", fetch_size, self->fetch_number, self->num_cached_rows);
+	self->prefetch_size = fetch_size;
+	conn->prefetch_res = self;
+
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+}
+
+static double
+current_msec(void)
+{
+#ifdef	WIN32
+	return (double) GetTickCount();
+#else
+	struct timeval	tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif /* WIN32 */
+}
+
+/*
+ * Choose the size of the next FETCH from the average size of the rows
+ * fetched so far, so that one round trip brings about FetchTargetBytes
+ * bytes. The size changes at most by a factor of 2 at a time, but never
+ * goes past FetchMaxBytes (except for a single row).
+ */
+static void
+QR_adapt_fetch_size(QResultClass *self, SQLLEN start, SQLLEN num_rows, double msec)
+{
+	ConnInfo	*ci = &(QR_get_conn(self)->connInfo);
+	TupleField	*tuple;
+	SQLLEN		i, bytes = 0;
+	double		row_bytes, size;
+	Int4		cur_size;
+
+	if (num_rows <= 0 || NULL == self->backend_tuples)
+		return;
+	tuple = self->backend_tuples + start * self->num_fields;
+	for (i = 0; i < num_rows * self->num_fields; i++, tuple++)
+	{
+		if (tuple->len > 0)
+			bytes += tuple->len;
+	}
+	self->fetched_bytes += bytes;
+	self->fetched_rows += num_rows;
+	row_bytes = (double) self->fetched_bytes / self->fetched_rows;
+	if (row_bytes < 1)
+		row_bytes = 1;
+
+	size = ci->fetch_target_bytes / row_bytes;
+	cur_size = (self->adaptive_fetch_size > 0 ? self->adaptive_fetch_size : ci->drivers.fetch_max);
+	if (size > 2.0 * cur_size)
+		size = 2.0 * cur_size;
+	else if (size < cur_size / 2.0)
+		size = cur_size / 2.0;
+	/* the damping mustn't keep a size which is too big for the rows now */
+	if (ci->fetch_max_bytes > 0 && size > ci->fetch_max_bytes / row_bytes)
+	{
+		MYLOG(0, "fetch size %.0f capped by FetchMaxBytes %d\n", size, ci->fetch_max_bytes);
+		size = ci->fetch_max_bytes / row_bytes;
+	}
+	if (size < 1)
+		size = 1;
+	self->adaptive_fetch_size = (Int4) size;
+	MYLOG(0, "fetched " FORMAT_LEN " rows (" FORMAT_LEN " bytes) in %.3f msec, %.1f bytes per row, next fetch size %d\n", num_rows, bytes, msec, row_bytes, self->adaptive_fetch_size);
+}
+
+/*
+ * Read the rows of the FETCH sent in advance into the tuple cache.
+ */
+static BOOL
+QR_read_prefetched(QResultClass *self, StatementClass *stmt, Int4 fetch_size)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	PGresult	*pgres;
+	BOOL		ret = FALSE;
+
+	if (conn->prefetch_res == self)
+		CC_finish_pending_rows(conn);
+	pgres = self->prefetched;
+	self->prefetched = NULL;
+	self->prefetch_size = 0;
+	if (NULL == pgres)
+		return FALSE;
+	switch (PQresultStatus(pgres))
+	{
+		case PGRES_TUPLES_OK:
+			self->cmd_fetch_size = fetch_size;
+			ret = QR_from_PGresult(self, stmt, NULL, QR_get_cursor(self), &pgres);
+			break;
+		default:
+			handle_pgres_error(conn, pgres, "fetch", self, TRUE);
+			break;
+	}
+	if (pgres)
+		PQclear(pgres);
+	return ret;
+}
+
 /*
  * Read tuples from a libpq PGresult object into QResultClass.
  *
  * The result status of the passed-in PGresult should be either
- * PGRES_TUPLES_OK, or PGRES_SINGLE_TUPLE. If it's PGRES_SINGLE_TUPLE,
- * this function will call PQgetResult() to read all the available tuples.
+ * PGRES_TUPLES_OK, PGRES_SINGLE_TUPLE or PGRES_TUPLES_CHUNK. If it's
+ * PGRES_SINGLE_TUPLE or PGRES_TUPLES_CHUNK, this function will call
+ * PQgetResult() to read all the available tuples.
+ *
+ * If hold_pgres is TRUE, a PGRES_TUPLES_OK or PGRES_TUPLES_CHUNK result
+ * is kept by self and the tuple cache points into it instead of copying
+ * the values. *pgres is set to NULL then, so that the caller doesn't
+ * PQclear() it.
+ *
+ * A streaming result stops reading after cache_size rows are cached and
+ * leaves the rest to QR_read_streaming_rows().
  */
 static BOOL
-QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
+QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres, BOOL hold_pgres)
 {
 	Int2		field_lf;
 	int			len;
@@ -1327,6 +1740,10 @@ QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
 	int			nrows;
 	int			resStatus;
 	int		numTotalRows = 0;
+	PGresult	*curres;
+	BOOL		held = FALSE, column_major;
+	SQLULEN		first_row, row;
+	TupleField	*tuple;
 
 	/* set the current row to read the fields into */
 	effective_cols = QR_NumPublicResultCols(self);
@@ -1334,27 +1751,52 @@ QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
 	flds = QR_get_fields(self);
 
 nextrow:
-	resStatus = PQresultStatus(*pgres);
+	curres = *pgres;
+	held = FALSE;
+	resStatus = PQresultStatus(curres);
 	switch (resStatus)
 	{
 		case PGRES_TUPLES_OK:
-			QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(*pgres));
+			QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(curres));
 			break;
 		case PGRES_SINGLE_TUPLE:
+#ifdef	LIBPQ_HAS_CHUNK_MODE
+		case PGRES_TUPLES_CHUNK:
+#endif /* LIBPQ_HAS_CHUNK_MODE */
 			break;
 
 		case PGRES_NONFATAL_ERROR:
 		case PGRES_BAD_RESPONSE:
 		case PGRES_FATAL_ERROR:
 		default:
-			handle_pgres_error(self->conn, *pgres, "read_tuples", self, TRUE);
+			handle_pgres_error(self->conn, curres, "read_tuples", self, TRUE);
 			QR_set_rstatus(self, PORES_FATAL_ERROR);
 			return FALSE;
 	}
 
-	nrows = PQntuples(*pgres);
+	nrows = PQntuples(curres);
 	numTotalRows += nrows;
+	if (hold_pgres && PGRES_SINGLE_TUPLE != resStatus && nrows > 0)
+	{
+		if (!QR_hold_pgres(self, curres))
+		{
+			QR_set_rstatus(self, PORES_NO_MEMORY_ERROR);
+			QR_set_messageref(self, "Out of memory while holding the PGresult.");
+			return FALSE;
+		}
+		if (PGRES_TUPLES_OK == resStatus)
+			QR_set_command(self, PQcmdStatus(curres));
+		*pgres = NULL;
+		held = TRUE;
+	}
 
+	/*
+	 * The values copied into the arena are copied column by column
+	 * after the rows are read, so that the values of a column lie next
+	 * to each other.
+	 */
+	column_major = (!held && QR_values_in_arena(self));
+	first_row = self->num_cached_rows;
 	for (rowno = 0; rowno < nrows; rowno++)
 	{
 		TupleField *this_tuplefield;
@@ -1376,7 +1818,7 @@ nextrow:
 		{
 			BOOL isnull = FALSE;
 
-			isnull = PQgetisnull(*pgres, rowno, field_lf);
+			isnull = PQgetisnull(curres, rowno, field_lf);
 
 			if (isnull)
 			{
@@ -1387,16 +1829,26 @@ nextrow:
 			}
 			else
 			{
-				len = PQgetlength(*pgres, rowno, field_lf);
-				value = PQgetvalue(*pgres, rowno, field_lf);
+				len = PQgetlength(curres, rowno, field_lf);
+				value = PQgetvalue(curres, rowno, field_lf);
 				if (field_lf >= effective_cols)
 					buffer = tidoidbuf;
+				else if (held || column_major)
+					buffer = value;	/* already null-terminated */
+				else if (QR_values_in_arena(self))
+				{
+					QR_ARENA_ALLOC_return_with_error(buffer, len + 1, self, "Out of memory in allocating item buffer.", FALSE);
+				}
 				else
 				{
 					QR_MALLOC_return_with_error(buffer, char, len + 1, self, "Out of memory in allocating item buffer.", FALSE);
+					self->malloced_size += len + 1;
+				}
+				if (buffer != value)
+				{
+					memcpy(buffer, value, len);
+					buffer[len] = '\0';
 				}
-				memcpy(buffer, value, len);
-				buffer[len] = '\0';
 
 				QPRINTF(TUPLE_LOG_LEVEL, " '%s'(%d)", buffer, len);
 
@@ -1431,7 +1883,8 @@ nextrow:
 					 * row!
 					 */
 
-					if (flds && flds->coli_array && CI_get_display_size(flds, field_lf) < len)
+					if (flds && flds->coli_array && !CI_is_binary(flds, field_lf) &&
+						CI_get_display_size(flds, field_lf) < len)
 						CI_get_display_size(flds, field_lf) = len;
 				}
 			}
@@ -1448,14 +1901,52 @@ nextrow:
 		if (self->cursTuple >= self->num_total_read)
 			self->num_total_read = self->cursTuple + 1;
 	}
-
-	if (resStatus == PGRES_SINGLE_TUPLE)
+	if (column_major && num_fields > 0)
 	{
-		/* Process next row */
-		PQclear(*pgres);
+		for (field_lf = 0; field_lf < effective_cols && field_lf < num_fields; field_lf++)
+		{
+			size_t	total = 0;
 
-		*pgres = PQgetResult(self->conn->pqconn);
-		goto nextrow;
+			for (row = first_row; row < self->num_cached_rows; row++)
+			{
+				tuple = self->backend_tuples + row * num_fields + field_lf;
+				if (NULL != tuple->value)
+					total += tuple->len + 1;
+			}
+			if (0 == total)
+				continue;
+			QR_ARENA_ALLOC_return_with_error(buffer, total, self, "Out of memory in allocating item buffer.", FALSE);
+			for (row = first_row; row < self->num_cached_rows; row++)
+			{
+				tuple = self->backend_tuples + row * num_fields + field_lf;
+				if (NULL == tuple->value)
+					continue;
+				memcpy(buffer, tuple->value, tuple->len);
+				buffer[tuple->len] = '\0';
+				tuple->value = buffer;
+				buffer += tuple->len + 1;
+			}
+		}
+	}
+	if (!QR_check_memory_limit(self, held ? NULL : curres))
+		return FALSE;
+
+	if (resStatus != PGRES_TUPLES_OK)
+	{
+		/* Process next row or chunk */
+		if (!held)
+			PQclear(curres);
+		*pgres = NULL;
+
+		/* leave the rest of the rows to QR_read_streaming_rows() */
+		if (QR_is_streaming(self) && self->cache_size > 0 &&
+		    self->num_cached_rows >= self->cache_size)
+			self->conn->streaming_res = self;
+		else
+		{
+			*pgres = PQgetResult(self->conn->pqconn);
+			goto nextrow;
+		}
 	}
 
 	self->dataFilled = TRUE;
@@ -1467,6 +1958,245 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 	return TRUE;
 }
 
+/*
+ * The following functions are the counterparts of ClearCachedRows(),
+ * ReplaceCachedRows() and MoveCachedRows() for the tuple cache of self.
+ * The values in the tuple arena can't be freed one by one; they are
+ * released when the whole cache is cleared.
+ */
+SQLLEN
+QR_clear_cached_rows(QResultClass *self, TupleField *tuple, int num_fields, SQLLEN num_rows)
+{
+	SQLLEN	i;
+	BOOL	whole_cache = (tuple == self->backend_tuples && num_rows >= (SQLLEN) self->num_cached_rows);
+
+	if (!QR_values_in_arena(self))
+	{
+		QR_sub_malloced_size(self, tuple, num_fields * num_rows);
+		i = ClearCachedRows(tuple, num_fields, num_rows);
+		QR_account_memory(self);
+		return i;
+	}
+
+	for (i = 0; i < num_fields * num_rows; i++, tuple++)
+	{
+		tuple->value = NULL;
+		tuple->len = -1;
+	}
+	if (whole_cache)
+	{
+		TA_reset(&self->value_arena);
+		QR_release_held_pgres(self);
+		QR_account_memory(self);
+	}
+	return i;
+}
+
+/*
+ * Keep a PGresult whose values the tuple cache refers to directly.
+ */
+static BOOL
+QR_hold_pgres(QResultClass *self, PGresult *pgres)
+{
+	if (self->num_held_pgres >= self->count_held_pgres_allocated)
+	{
+		int		alloc = self->count_held_pgres_allocated > 0 ? self->count_held_pgres_allocated * 2 : 4;
+		PGresult **held = (PGresult **) realloc(self->held_pgres, sizeof(PGresult *) * alloc);
+
+		if (NULL == held)
+			return FALSE;
+		self->held_pgres = held;
+		self->count_held_pgres_allocated = alloc;
+	}
+	self->held_pgres[self->num_held_pgres++] = pgres;
+	self->held_pgres_size += PQresultMemorySize(pgres);
+	return TRUE;
+}
+
+static void
+QR_release_held_pgres(QResultClass *self)
+{
+	int	i;
+
+	for (i = 0; i < self->num_held_pgres; i++)
+		PQclear(self->held_pgres[i]);
+	self->num_held_pgres = 0;
+	self->held_pgres_size = 0;
+}
+
+/*
+ * The memory the tuple cache and the keysets of the result hold.
+ * The values which spilled to a file aren't counted (see
+ * QR_get_spilled_size()).
+ */
+SQLULEN
+QR_get_memory_size(const QResultClass *self)
+{
+	SQLULEN	size = self->value_arena.allocated +
+				   self->held_pgres_size + self->malloced_size;
+
+	if (self->backend_tuples)
+		size += self->count_backend_allocated * self->num_fields * sizeof(TupleField);
+	if (self->keyset)
+		size += self->count_keyset_allocated * sizeof(KeySet);
+	if (self->rollback)
+		size += self->rb_alloc * sizeof(Rollback);
+	if (self->added_keyset)
+		size += self->ad_alloc * sizeof(KeySet);
+	if (self->added_tuples)
+		size += self->ad_alloc * self->num_fields * sizeof(TupleField);
+	if (self->deleted)
+		size += self->dl_alloc * (sizeof(SQLLEN) + sizeof(KeySet));
+	if (self->updated)
+		size += self->up_alloc * (sizeof(SQLLEN) + sizeof(KeySet));
+	if (self->updated_tuples)
+		size += self->up_alloc * self->num_fields * sizeof(TupleField);
+	if (self->prefetched)
+		size += PQresultMemorySize(self->prefetched);
+	return size;
+}
+
+static SQLULEN
+values_size(const TupleField *tuple, SQLLEN count)
+{
+	SQLULEN	size = 0;
+	SQLLEN	i;
+
+	for (i = 0; i < count; i++, tuple++)
+	{
+		if (NULL != tuple->value && tuple->len >= 0)
+			size += tuple->len + 1;
+	}
+	return size;
+}
+
+/*
+ * The malloc'ed values about to be freed are no longer counted.
+ */
+static void
+QR_sub_malloced_size(QResultClass *self, const TupleField *tuple, SQLLEN count)
+{
+	SQLULEN	size = values_size(tuple, count);
+
+	/* the values put in by other means than reading them weren't counted */
+	if (self->malloced_size > size)
+		self->malloced_size -= size;
+	else
+		self->malloced_size = 0;
+}
+
+/*
+ * Bring the count of the memory the results of the connection hold,
+ * conn->result_memory, up to date with the memory the result holds now.
+ * Returns the count.
+ */
+SQLULEN
+QR_account_memory(QResultClass *self)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	SQLULEN		size = QR_get_memory_size(self), total;
+
+	if (NULL == conn)
+		return size;
+	CONNLOCK_ACQUIRE(conn);
+	conn->result_memory += size;
+	conn->result_memory -= self->accounted_size;
+	total = conn->result_memory;
+	CONNLOCK_RELEASE(conn);
+	self->accounted_size = size;
+	return total;
+}
+
+/*
+ * Fail when the results of the connection hold more memory than
+ * ResultMemoryLimit, counting pgres which is being read into the cache.
+ */
+static BOOL
+QR_check_memory_limit(QResultClass *self, const PGresult *pgres)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	SQLULEN		limit, used;
+	char		emsg[160];
+
+	if (NULL == conn)
+		return TRUE;
+	used = QR_account_memory(self);
+	if (conn->connInfo.result_memory_limit <= 0)
+		return TRUE;
+	limit = (SQLULEN) conn->connInfo.result_memory_limit * 1024 * 1024;
+	if (NULL != pgres)
+		used += PQresultMemorySize(pgres);
+	if (used <= limit)
+		return TRUE;
+	MYLOG(0, "the results hold " FORMAT_ULEN " bytes over the limit " FORMAT_ULEN "\n", used, limit);
+	QR_set_rstatus(self, PORES_NO_MEMORY_ERROR);
+	QR_free_memory(self);
+	SPRINTF_FIXED(emsg, "The results of the connection would hold " FORMAT_ULEN " bytes, more than ResultMemoryLimit (%d MB)", used, conn->connInfo.result_memory_limit);
+	QR_set_message(self, emsg);
+	return FALSE;
+}
+
+SQLLEN
+QR_replace_cached_rows(QResultClass *self, TupleField *otuple, const TupleField *ituple, int num_fields, SQLLEN num_rows)
+{
+	SQLLEN	i;
+
+	if (!QR_values_in_arena(self))
+	{
+		QR_sub_malloced_size(self, otuple, num_fields * num_rows);
+		i = ReplaceCachedRows(otuple, ituple, num_fields, num_rows);
+		self->malloced_size += values_size(otuple, num_fields * num_rows);
+		QR_account_memory(self);
+		return i;
+	}
+
+	for (i = 0; i < num_fields * num_rows; i++, ituple++, otuple++)
+	{
+		otuple->value = NULL;
+		if (ituple->value)
+			otuple->value = TA_strdup(&self->value_arena, ituple->value);
+		if (otuple->value)
+			otuple->len = ituple->len;
+		else
+			otuple->len = -1;
+	}
+	QR_account_memory(self);
+	return i;
+}
+
+SQLLEN
+QR_move_cached_rows(QResultClass *self, TupleField *otuple, QResultClass *ires, TupleField *ituple, int num_fields, SQLLEN num_rows)
+{
+	SQLLEN	i;
+	BOOL	iarena = QR_values_in_arena(ires);
+
+	if (!QR_values_in_arena(self) && !iarena)
+		return MoveCachedRows(otuple, ituple, num_fields, num_rows);
+
+	for (i = 0; i < num_fields * num_rows; i++, ituple++, otuple++)
+	{
+		if (!QR_values_in_arena(self) && otuple->value)
+			free(otuple->value);
+		otuple->value = NULL;
+		otuple->len = ituple->len;
+		if (ituple->value)
+		{
+			/* the values can't move across the arenas */
+			if (QR_values_in_arena(self))
+				otuple->value = TA_strdup(&self->value_arena, ituple->value);
+			else
+				otuple->value = strdup(ituple->value);
+			if (NULL == otuple->value)
+				otuple->len = -1;
+			if (!iarena)
+				free(ituple->value);
+			ituple->value = NULL;
+		}
+		ituple->len = -1;
+	}
+	return i;
+}
+
 int
 QR_search_by_fieldname(const QResultClass *self, const char *name)
 {
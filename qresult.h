@@ -84,6 +84,18 @@ struct QResultClass_
 
 	TupleField *backend_tuples;	/* data from the backend (the tuple cache) */
 	TupleField *tupleField;		/* current backend tuple being retrieved */
+	TupleArena	value_arena;	/* holds the values of backend_tuples */
+	PGresult  **held_pgres;		/* PGresults whose values backend_tuples refer to */
+	int		num_held_pgres;
+	int		count_held_pgres_allocated;
+	SQLULEN		held_pgres_size;	/* memory size of the held PGresults */
+	SQLULEN		malloced_size;	/* size of the values malloc'ed one by one */
+	SQLULEN		accounted_size;	/* the size counted in conn->result_memory */
+	PGresult	*prefetched;	/* the result of the FETCH sent in advance */
+	Int4		prefetch_size;	/* the number of rows it was sent for */
+	Int4		adaptive_fetch_size;	/* FETCH size chosen by the row size */
+	SQLULEN		fetched_bytes;	/* the size of the rows fetched so far */
+	SQLULEN		fetched_rows;	/* and their number */
 
 	char	pstatus;		/* processing status */
 	char	aborted;		/* was aborted ? */
@@ -119,13 +131,20 @@ enum {
 	,FQR_WITHHOLD	= (1L << 1)
 	,FQR_HOLDPERMANENT = (1L << 2) /* the cursor is alive across transactions */
 	,FQR_SYNCHRONIZEKEYS = (1L<<3) /* synchronize the keyset range with that of cthe tuples cache */
+	,FQR_VALUES_IN_ARENA = (1L<<4) /* the values of backend_tuples are allocated in value_arena or held_pgres */
+	,FQR_STREAMING = (1L<<5) /* the rows are read from the connection as they are fetched */
 };
 
 #define	QR_haskeyset(self)		(0 != (self->flags & FQR_HASKEYSET))
 #define	QR_is_withhold(self)		(0 != (self->flags & FQR_WITHHOLD))
 #define	QR_is_permanent(self)		(0 != (self->flags & FQR_HOLDPERMANENT))
 #define	QR_synchronize_keys(self)	(0 != (self->flags & FQR_SYNCHRONIZEKEYS))
+#define	QR_values_in_arena(self)	(0 != (self->flags & FQR_VALUES_IN_ARENA))
+#define	QR_is_streaming(self)		(0 != (self->flags & FQR_STREAMING))
+/* the rest of the rows of self are still to be read from the connection */
+#define	QR_stream_pending(self)		(NULL != (self)->conn && (self)->conn->streaming_res == (self))
 #define QR_get_fields(self)		(self->fields)
+#define QR_get_spilled_size(self)	((self)->value_arena.spilled)
 
 
 /*	These functions are for retrieving data from the qresult */
@@ -163,6 +182,8 @@ enum {
 #define QR_set_aborted(self, aborted_)		( self->aborted = aborted_)
 #define QR_set_haskeyset(self)		(self->flags |= FQR_HASKEYSET)
 #define QR_set_synchronize_keys(self)	(self->flags |= FQR_SYNCHRONIZEKEYS)
+#define QR_set_values_in_arena(self)	(self->flags |= FQR_VALUES_IN_ARENA)
+#define QR_set_streaming(self)		(self->flags |= FQR_STREAMING)
 #define QR_set_no_cursor(self)		((self)->flags &= ~(FQR_WITHHOLD | FQR_HOLDPERMANENT), (self)->pstatus &= ~FQR_NEEDS_SURVIVAL_CHECK)
 #define QR_set_withhold(self)		(self->flags |= FQR_WITHHOLD)
 #define QR_set_permanent(self)		(self->flags |= FQR_HOLDPERMANENT)
@@ -230,6 +251,10 @@ void		QR_close_result(QResultClass *self, BOOL destroy);
 void		QR_reset_for_re_execute(QResultClass *self);
 BOOL		QR_from_PGresult(QResultClass *self, StatementClass *stmt, ConnectionClass *conn, const char *cursor, PGresult **pgres);
 void		QR_free_memory(QResultClass *self);
+BOOL		QR_read_streaming_rows(QResultClass *self, SQLLEN num_rows);
+void		QR_discard_streaming_rows(QResultClass *self);
+SQLULEN		QR_get_memory_size(const QResultClass *self);
+SQLULEN		QR_account_memory(QResultClass *self);
 void		QR_set_command(QResultClass *self, const char *msg);
 void		QR_set_message(QResultClass *self, const char *msg);
 void		QR_add_message(QResultClass *self, const char *msg);
@@ -250,6 +275,9 @@ SQLLEN		getNthValid(const QResultClass *self, SQLLEN sta, UWORD orientation, SQL
 SQLLEN		QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt);
 BOOL		QR_get_last_bookmark(const QResultClass *self, Int4 index, KeySet *keyset);
 int			QR_search_by_fieldname(const QResultClass *self, const char *name);
+SQLLEN		QR_clear_cached_rows(QResultClass *self, TupleField *tuple, int num_fields, SQLLEN num_rows);
+SQLLEN		QR_replace_cached_rows(QResultClass *self, TupleField *otuple, const TupleField *ituple, int num_fields, SQLLEN num_rows);
+SQLLEN		QR_move_cached_rows(QResultClass *self, TupleField *otuple, QResultClass *ires, TupleField *ituple, int num_fields, SQLLEN num_rows);
 
 #define QR_MALLOC_return_with_error(t, tp, s, a, m, r) \
 do { \
@@ -275,6 +303,17 @@ qlog("QR_REALLOC_error\n"); \
 	} \
 	t = tmp; \
 } while (0)
+#define QR_ARENA_ALLOC_return_with_error(t, s, a, m, r) \
+do { \
+	if (t = TA_alloc(&(a)->value_arena, s), NULL == t) \
+	{ \
+		QR_set_rstatus(a, PORES_NO_MEMORY_ERROR); \
+qlog("QR_ARENA_ALLOC_error\n"); \
+		QR_free_memory(a); \
+		QR_set_messageref(a, m); \
+		return r; \
+	} \
+} while (0)
 #define	QR_REALLOC_gexit_with_error(t, tp, s, a, m, r) \
 do { \
 	tp *tmp; \
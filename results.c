@@ -76,7 +76,11 @@ PGAPI_RowCount(HSTMT hstmt,
 		}
 		else if (QR_NumResultCols(res) > 0)
 		{
-			*pcrow = QR_get_cursor(res) ? -1 : QR_get_num_total_tuples(res) - res->dl_count;
+			if (QR_get_cursor(res) ||
+			    (QR_is_streaming(res) && !QR_once_reached_eof(res)))
+				*pcrow = -1;
+			else
+				*pcrow = QR_get_num_total_tuples(res) - res->dl_count;
 			MYLOG(0, "RowCount=" FORMAT_LEN "\n", *pcrow);
 			return SQL_SUCCESS;
 		}
@@ -1090,8 +1094,12 @@ MYLOG(DETAIL_LOG_LEVEL, "currT=" FORMAT_LEN " base=" FORMAT_LEN " rowset=" FORMA
 
 	SC_set_current_col(stmt, icol);
 
-	result = copy_and_convert_field(stmt, field_type, atttypmod, value,
-			target_type, precision, rgbValue, cbValueMax, pcbValue, pcbValue);
+	if (CI_is_binary(QR_get_fields(res), icol))
+		result = copy_and_convert_binary_field(stmt, field_type, atttypmod, value,
+				target_type, precision, rgbValue, cbValueMax, pcbValue, pcbValue);
+	else
+		result = copy_and_convert_field(stmt, field_type, atttypmod, value,
+				target_type, precision, rgbValue, cbValueMax, pcbValue, pcbValue);
 
 	switch (result)
 	{
@@ -1356,6 +1364,11 @@ move_cursor_position_if_needed(StatementClass *self, QResultClass *res)
 	{
 		QR_stop_movement(res); /* for safety */
 		res->move_offset = 0;
+		/* the cache of a streaming result starts at the current rowset */
+		if (QR_is_streaming(res) &&
+		    QR_get_rowstart_in_cache(res) >= 0 &&
+		    QR_get_rowstart_in_cache(res) <= res->num_cached_rows)
+			QR_set_next_in_cache(res, QR_get_rowstart_in_cache(res));
 		return;
 	}
 MYLOG(DETAIL_LOG_LEVEL, "BASE=" FORMAT_LEN " numb=" FORMAT_LEN " curr=" FORMAT_LEN " cursT=" FORMAT_LEN "\n", QR_get_rowstart_in_cache(res), res->num_cached_rows, self->currTuple, res->cursTuple);
@@ -1495,9 +1508,10 @@ PGAPI_ExtendedFetch(HSTMT hstmt,
 	if (pcrow)
 		*pcrow = 0;
 
-	useCursor = (SC_is_fetchcursor(stmt) && NULL != QR_get_cursor(res));
+	useCursor = ((SC_is_fetchcursor(stmt) && NULL != QR_get_cursor(res)) ||
+		     QR_is_streaming(res));
 	num_tuples = QR_get_num_total_tuples(res);
-	reached_eof = QR_once_reached_eof(res) && QR_get_cursor(res);
+	reached_eof = QR_once_reached_eof(res) && (QR_get_cursor(res) || QR_is_streaming(res));
 	if (useCursor && !reached_eof)
 		num_tuples = INT_MAX;
 
@@ -1806,7 +1820,8 @@ MYLOG(DETAIL_LOG_LEVEL, "num_tuples=" FORMAT_LEN "\n", num_tuples);
 	stmt->currTuple = RowIdx2GIdx(-1, stmt);
 
 	if (SC_is_fetchcursor(stmt) ||
-	    SQL_CURSOR_KEYSET_DRIVEN == stmt->options.cursor_type)
+	    SQL_CURSOR_KEYSET_DRIVEN == stmt->options.cursor_type ||
+	    QR_is_streaming(res))
 	{
 		move_cursor_position_if_needed(stmt, res);
 	}
@@ -1842,6 +1857,20 @@ MYLOG(DETAIL_LOG_LEVEL, "num_tuples=" FORMAT_LEN "\n", num_tuples);
 
 	truncated = error = FALSE;
 
+	/*
+	 * With column-wise binding of the rows in the cache, convert the
+	 * values column by column after all the rows of the rowset are read.
+	 */
+	if (SQL_BIND_BY_COLUMN == opts->bind_size &&
+	    rowsetSize > 1 &&
+	    !useCursor &&
+	    NULL == res->keyset &&
+	    SQL_RD_ON == stmt->options.retrieve_data)
+		stmt->fetch_by_column = TRUE;
+	/* convert the bound columns following the compiled plan */
+	if (SQL_RD_ON == stmt->options.retrieve_data)
+		stmt->fetch_by_plan = prepare_fetch_plan(stmt);
+
 	currp = -1;
 	stmt->bind_row = 0;		/* set the binding location */
 	result = SC_fetch(stmt);
@@ -1925,6 +1954,19 @@ MYLOG(DETAIL_LOG_LEVEL, "just skipping deleted row " FORMAT_LEN "\n", currp);
 	}
 	if (SQL_ERROR == result)
 		goto cleanup;
+	if (stmt->fetch_by_column)
+	{
+		stmt->fetch_by_column = FALSE;
+		if (i > 0)
+		{
+			/* the rows failed to convert are SQL_ROW_ERROR */
+			result = SC_fetch_by_column(stmt, i, rgfRowStatus);
+			if (SQL_ERROR == result)
+				error = TRUE;
+			else if (SQL_SUCCESS_WITH_INFO == result)
+				truncated = TRUE;
+		}
+	}
 
 	/* Save the fetch count for SQLSetPos */
 	stmt->last_fetch_count = i;
@@ -1964,6 +2006,8 @@ MYLOG(DETAIL_LOG_LEVEL, "pcrow=" FORMAT_LEN "\n", i);
 
 cleanup:
 #undef	return
+	stmt->fetch_by_column = FALSE;
+	stmt->fetch_by_plan = FALSE;
 	return result;
 }
 
@@ -2163,7 +2207,6 @@ MYLOG(DETAIL_LOG_LEVEL, "[" FORMAT_LEN "," FORMAT_LEN "] %s copied\n", i / num_f
 	return i;
 }
 
-static
 int MoveCachedRows(TupleField *otuple, TupleField *ituple, Int2 num_fields, SQLLEN num_rows)
 {
 	int	i;
@@ -2275,6 +2318,7 @@ static BOOL enlargeAdded(QResultClass *res, UInt4 number, const StatementClass *
 	if (SQL_CURSOR_KEYSET_DRIVEN != stmt->options.cursor_type)
 		QR_REALLOC_return_with_error(res->added_tuples, TupleField, sizeof(TupleField) * num_fields * alloc, res, "enlargeAdded failed 2", FALSE);
 	res->ad_alloc = alloc;
+	QR_account_memory(res);
 	return TRUE;
 }
 static void AddAdded(StatementClass *stmt, QResultClass *res, SQLLEN index, const TupleField *tuple_added)
@@ -2413,6 +2457,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering " FORMAT_ULEN "\n", index);
 		deleted = res->deleted;
 		deleted_keyset = res->deleted_keyset;
 		res->dl_alloc = new_alloc;
+		QR_account_memory(res);
 	}
 	else
 	{
@@ -2425,6 +2470,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering " FORMAT_ULEN "\n", index);
 			QR_REALLOC_return_with_error(res->deleted_keyset, KeySet, sizeof(KeySet) * new_alloc, res, "Deleted KeySet realloc error", FALSE);
 			deleted_keyset = res->deleted_keyset;
 			res->dl_alloc = new_alloc;
+			QR_account_memory(res);
 		}
 		/* sort deleted indexes in ascending order */
 		for (i = 0, deleted = res->deleted, deleted_keyset = res->deleted_keyset; i < dl_count; i++, deleted++, deleted_keyset++)
@@ -2556,6 +2602,7 @@ enlargeUpdated(QResultClass *res, Int4 number, const StatementClass *stmt)
 	if (SQL_CURSOR_KEYSET_DRIVEN != stmt->options.cursor_type)
 		QR_REALLOC_return_with_error(res->updated_tuples, TupleField, sizeof(TupleField) * res->num_fields * alloc, res, "enlargeUpdated failed 3", FALSE);
 	res->up_alloc = alloc;
+	QR_account_memory(res);
 
 	return TRUE;
 }
@@ -2961,7 +3008,7 @@ MYLOG(DETAIL_LOG_LEVEL, " index=" FORMAT_LEN " status=%hx", index, status);
 				if (ridx >=0 && ridx < res->num_cached_rows)
 				{
 					TupleField *tuple = res->backend_tuples + res->num_fields * ridx;
-					ClearCachedRows(tuple, res->num_fields, 1);
+					QR_clear_cached_rows(res, tuple, res->num_fields, 1);
 					res->num_cached_rows--;
 				}
 				res->num_cached_keys--;
@@ -2994,7 +3041,7 @@ MYPRINTF(DETAIL_LOG_LEVEL, "->(%u, %u)", wkey->blocknum, wkey->offset);
 					if (QR_command_maybe_successful(qres) &&
 					    QR_get_num_cached_tuples(qres) == 1)
 					{
-						MoveCachedRows(res->backend_tuples + num_fields * ridx, qres->backend_tuples, num_fields, 1);
+						QR_move_cached_rows(res, res->backend_tuples + num_fields * ridx, qres, qres->backend_tuples, num_fields, 1);
 						wkey->status &= ~CURS_NEEDS_REREAD;
 					}
 					QR_Destructor(qres);
@@ -3290,7 +3337,7 @@ SC_pos_reload_with_key(StatementClass *stmt, SQLULEN global_ridx, UInt2 *count,
 				strcmp(tuple_new[qres->num_fields - res->num_key_fields].value, tidval))
 				res->keyset[kres_ridx].status |= SQL_ROW_UPDATED;
 			KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, FALSE);
-			MoveCachedRows(tuple_old, tuple_new, effective_fields, 1);
+			QR_move_cached_rows(res, tuple_old, qres, tuple_new, effective_fields, 1);
 		}
 		if (rcnt > 1)
 		{
@@ -3371,7 +3418,6 @@ static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, int rows_
 			if (QR_command_maybe_successful(qres))
 			{
 				SQLLEN		j, k, l;
-				Int2		m;
 				TupleField	*tuple, *tuplew;
 				UInt4		bln;
 				UInt2		off;
@@ -3390,15 +3436,7 @@ static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, int rows_
 							l = GIdx2CacheIdx(k, stmt, res);
 							tuple = res->backend_tuples + res->num_fields * l;
 							tuplew = qres->backend_tuples + qres->num_fields * j;
-							for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
-							{
-								if (tuple->len > 0 && tuple->value)
-									free(tuple->value);
-								tuple->value = tuplew->value;
-								tuple->len = tuplew->len;
-								tuplew->value = NULL;
-								tuplew->len = -1;
-							}
+							QR_move_cached_rows(res, tuple, qres, tuplew, res->num_fields, 1);
 							res->keyset[k].status &= ~CURS_NEEDS_REREAD;
 							break;
 						}
@@ -3548,7 +3586,6 @@ MYLOG(0, "entering in rows_per_fetch=%d limitrow=" FORMAT_LEN "\n", rows_per_fet
 			if (QR_command_maybe_successful(qres))
 			{
 				SQLLEN		k, l;
-				Int2		m;
 				TupleField	*tuple, *tuplew;
 				UInt4		bln;
 				UInt2		off;
@@ -3568,15 +3605,7 @@ MYLOG(0, "entering in rows_per_fetch=%d limitrow=" FORMAT_LEN "\n", rows_per_fet
 							l = GIdx2CacheIdx(k, stmt, res);
 							tuple = res->backend_tuples + res->num_fields * l;
 							tuplew = qres->backend_tuples + qres->num_fields * j;
-							for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
-							{
-								if (tuple->len > 0 && tuple->value)
-									free(tuple->value);
-								tuple->value = tuplew->value;
-								tuple->len = tuplew->len;
-								tuplew->value = NULL;
-								tuplew->len = -1;
-							}
+							QR_move_cached_rows(res, tuple, qres, tuplew, res->num_fields, 1);
 							res->keyset[k].status &= ~CURS_NEEDS_REREAD;
 							break;
 						}
@@ -3674,7 +3703,7 @@ SC_pos_reload_needed(StatementClass *stmt, SQLULEN req_size, UDWORD flag)
 	if (create_from_scratch ||
 	    !res->dataFilled)
 	{
-		ClearCachedRows(res->backend_tuples, res->num_fields, res->num_cached_rows);
+		QR_clear_cached_rows(res, res->backend_tuples, res->num_fields, res->num_cached_rows);
 		res->dataFilled = FALSE;
 	}
 	if (!res->dataFilled)
@@ -3735,12 +3764,85 @@ cleanup:
 	return ret;
 }
 
+/*
+ * Add a row read back after its insertion (tuple_new of qres) to the
+ * keyset and the cache of res.
+ */
+static RETCODE
+pos_newload_tuple(StatementClass *stmt, QResultClass *res, QResultClass *qres, TupleField *tuple_new)
+{
+	int	effective_fields = res->num_fields;
+	ssize_t	tuple_size;
+	SQLLEN	num_total_rows, num_cached_rows, kres_ridx;
+	BOOL	appendKey = FALSE, appendData = FALSE;
+	TupleField *tuple_old;
+
+	num_total_rows = QR_get_num_total_tuples(res);
+
+	AddAdded(stmt, res, num_total_rows, tuple_new);
+	num_cached_rows = QR_get_num_cached_tuples(res);
+	kres_ridx = GIdx2KResIdx(num_total_rows, stmt, res);
+	if (QR_haskeyset(res))
+	{	if (!QR_get_cursor(res))
+		{
+			appendKey = TRUE;
+			if (num_total_rows == CacheIdx2GIdx(num_cached_rows, stmt, res))
+				appendData = TRUE;
+			else
+			{
+MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " <> backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
+num_total_rows, num_cached_rows,
+QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
+			}
+		}
+		else if (kres_ridx >= 0 && kres_ridx < res->cache_size)
+		{
+			appendKey = TRUE;
+			appendData = TRUE;
+		}
+	}
+	if (appendKey)
+	{
+		if (res->num_cached_keys >= res->count_keyset_allocated)
+		{
+			if (!res->count_keyset_allocated)
+				tuple_size = TUPLE_MALLOC_INC;
+			else
+				tuple_size = res->count_keyset_allocated * 2;
+			QR_REALLOC_return_with_error(res->keyset, KeySet, sizeof(KeySet) * tuple_size, res, "pos_newload failed", SQL_ERROR);
+			res->count_keyset_allocated = tuple_size;
+		}
+		KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, TRUE);
+		res->num_cached_keys++;
+	}
+	if (appendData)
+	{
+MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " == backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
+num_total_rows, num_cached_rows,
+QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
+		if (num_cached_rows >= res->count_backend_allocated)
+		{
+			if (!res->count_backend_allocated)
+				tuple_size = TUPLE_MALLOC_INC;
+			else
+				tuple_size = res->count_backend_allocated * 2;
+			QR_REALLOC_return_with_error(res->backend_tuples, TupleField, res->num_fields * sizeof(TupleField) * tuple_size, res, "SC_pos_newload failed", SQL_ERROR);
+			res->count_backend_allocated = tuple_size;
+		}
+		tuple_old = res->backend_tuples + res->num_fields * num_cached_rows;
+		memset(tuple_old, 0, sizeof(TupleField) * effective_fields);
+		QR_move_cached_rows(res, tuple_old, qres, tuple_new, effective_fields, 1);
+		res->num_cached_rows++;
+	}
+
+	return SQL_SUCCESS;
+}
+
 static RETCODE	SQL_API
 SC_pos_newload(StatementClass *stmt, const UInt4 *oidint, BOOL tidRef,
 			   const char *tidval)
 {
 	CSTR	func = "SC_pos_newload";
-	int			i;
 	QResultClass *res, *qres;
 	RETCODE		ret = SQL_ERROR;
 
@@ -3770,76 +3872,7 @@ SC_pos_newload(StatementClass *stmt, const UInt4 *oidint, BOOL tidRef,
 		QR_set_position(qres, 0);
 		if (count == 1)
 		{
-			int	effective_fields = res->num_fields;
-			ssize_t	tuple_size;
-			SQLLEN	num_total_rows, num_cached_rows, kres_ridx;
-			BOOL	appendKey = FALSE, appendData = FALSE;
-			TupleField *tuple_old, *tuple_new;
-
-			tuple_new = qres->tupleField;
-			num_total_rows = QR_get_num_total_tuples(res);
-
-			AddAdded(stmt, res, num_total_rows, tuple_new);
-			num_cached_rows = QR_get_num_cached_tuples(res);
-			kres_ridx = GIdx2KResIdx(num_total_rows, stmt, res);
-			if (QR_haskeyset(res))
-			{	if (!QR_get_cursor(res))
-				{
-					appendKey = TRUE;
-					if (num_total_rows == CacheIdx2GIdx(num_cached_rows, stmt, res))
-						appendData = TRUE;
-					else
-					{
-MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " <> backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
-num_total_rows, num_cached_rows,
-QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
-					}
-				}
-				else if (kres_ridx >= 0 && kres_ridx < res->cache_size)
-				{
-					appendKey = TRUE;
-					appendData = TRUE;
-				}
-			}
-			if (appendKey)
-			{
-				if (res->num_cached_keys >= res->count_keyset_allocated)
-				{
-					if (!res->count_keyset_allocated)
-						tuple_size = TUPLE_MALLOC_INC;
-					else
-						tuple_size = res->count_keyset_allocated * 2;
-					QR_REALLOC_return_with_error(res->keyset, KeySet, sizeof(KeySet) * tuple_size, res, "pos_newload failed", SQL_ERROR);
-					res->count_keyset_allocated = tuple_size;
-				}
-				KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, TRUE);
-				res->num_cached_keys++;
-			}
-			if (appendData)
-			{
-MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " == backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
-num_total_rows, num_cached_rows,
-QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
-				if (num_cached_rows >= res->count_backend_allocated)
-				{
-					if (!res->count_backend_allocated)
-						tuple_size = TUPLE_MALLOC_INC;
-					else
-						tuple_size = res->count_backend_allocated * 2;
-					QR_REALLOC_return_with_error(res->backend_tuples, TupleField, res->num_fields * sizeof(TupleField) * tuple_size, res, "SC_pos_newload failed", SQL_ERROR);
-					res->count_backend_allocated = tuple_size;
-				}
-				tuple_old = res->backend_tuples + res->num_fields * num_cached_rows;
-				for (i = 0; i < effective_fields; i++)
-				{
-					tuple_old[i].len = tuple_new[i].len;
-					tuple_new[i].len = -1;
-					tuple_old[i].value = tuple_new[i].value;
-					tuple_new[i].value = NULL;
-				}
-				res->num_cached_rows++;
-			}
-			ret = SQL_SUCCESS;
+			ret = pos_newload_tuple(stmt, res, qres, qres->tupleField);
 		}
 		else if (0 == count)
 			ret = SQL_NO_DATA_FOUND;
@@ -4430,6 +4463,47 @@ typedef struct
 	SQLSETPOSIROW		irow;
 }	padd_cdata;
 
+/*
+ * Set the status of the keyset entry and of the row status array for
+ * the row irow of the rowset just added.
+ */
+static void
+pos_add_set_status(StatementClass *stmt, QResultClass *res, IRDFields *irdflds, SQLSETPOSIROW irow, RETCODE ret)
+{
+	if (SQL_SUCCESS == ret && res->keyset)
+	{
+		SQLLEN	global_ridx = QR_get_num_total_tuples(res) - 1;
+		ConnectionClass	*conn = SC_get_conn(stmt);
+		SQLLEN	kres_ridx;
+		UWORD	status = SQL_ROW_ADDED;
+
+		if (CC_is_in_trans(conn))
+			status |= CURS_SELF_ADDING;
+		else
+			status |= CURS_SELF_ADDED;
+		kres_ridx = GIdx2KResIdx(global_ridx, stmt, res);
+		if (kres_ridx >= 0 && kres_ridx < res->num_cached_keys)
+		{
+			res->keyset[kres_ridx].status = status;
+		}
+	}
+	if (irdflds->rowStatusArray)
+	{
+		switch (ret)
+		{
+			case SQL_SUCCESS:
+				irdflds->rowStatusArray[irow] = SQL_ROW_ADDED;
+				break;
+			case SQL_NO_DATA_FOUND:
+			case SQL_SUCCESS_WITH_INFO:
+				irdflds->rowStatusArray[irow] = SQL_ROW_SUCCESS_WITH_INFO;
+				break;
+			default:
+				irdflds->rowStatusArray[irow] = SQL_ROW_ERROR;
+		}
+	}
+}
+
 static RETCODE
 pos_add_callback(RETCODE retcode, void *para)
 {
@@ -4457,38 +4531,7 @@ pos_add_callback(RETCODE retcode, void *para)
 		SC_error_copy(s->stmt, s->qstmt, TRUE);
 	PGAPI_FreeStmt((HSTMT) s->qstmt, SQL_DROP);
 	s->qstmt = NULL;
-	if (SQL_SUCCESS == ret && s->res->keyset)
-	{
-		SQLLEN	global_ridx = QR_get_num_total_tuples(s->res) - 1;
-		ConnectionClass	*conn = SC_get_conn(s->stmt);
-		SQLLEN	kres_ridx;
-		UWORD	status = SQL_ROW_ADDED;
-
-		if (CC_is_in_trans(conn))
-			status |= CURS_SELF_ADDING;
-		else
-			status |= CURS_SELF_ADDED;
-		kres_ridx = GIdx2KResIdx(global_ridx, s->stmt, s->res);
-		if (kres_ridx >= 0 && kres_ridx < s->res->num_cached_keys)
-		{
-			s->res->keyset[kres_ridx].status = status;
-		}
-	}
-	if (s->irdflds->rowStatusArray)
-	{
-		switch (ret)
-		{
-			case SQL_SUCCESS:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_ADDED;
-				break;
-			case SQL_NO_DATA_FOUND:
-			case SQL_SUCCESS_WITH_INFO:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_SUCCESS_WITH_INFO;
-				break;
-			default:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_ERROR;
-		}
-	}
+	pos_add_set_status(s->stmt, s->res, s->irdflds, s->irow, ret);
 
 	return ret;
 }
@@ -4668,6 +4711,340 @@ cleanup:
 	return ret;
 }
 
+/*
+ * The protocol limits the number of parameters of a statement.
+ */
+#define	MAX_PARAMS_PER_STATEMENT	65535
+
+/*
+ * Insert the nrows rows of the rowset from first_row by one multi-row
+ * INSERT ... RETURNING ctid statement, read them back by one
+ * SELECT ... WHERE ctid IN (...) and add them to the keyset and the
+ * cache of res. cols are the indexes of the bound columns to insert.
+ *
+ * Returns SQL_NO_DATA_FOUND, leaving the status of the rows alone, if
+ * the INSERT statement failed, i.e. no row was inserted.
+ */
+static RETCODE
+pos_add_rows(StatementClass *stmt, QResultClass *res, const int *cols,
+			 int add_cols, SQLSETPOSIROW first_row, SQLSETPOSIROW nrows)
+{
+	CSTR	func = "pos_add_rows";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	BindInfoClass	*bindings = opts->bindings, *bookmark = opts->bookmark;
+	FIELD_INFO	**fi = irdflds->fi;
+	TABLE_INFO	*ti = stmt->ti[0];
+	const char *bestitem = GET_NAME(ti->bestitem);
+	Int4		bind_size = opts->bind_size;
+	int		unknown_sizes = conn->connInfo.drivers.unknown_sizes;
+	HSTMT		hstmt;
+	StatementClass	*qstmt;
+	IPDFields	*ipdopts;
+	QResultClass	*ires, *tres, *qres = NULL;
+	PQExpBufferData		addstr = {0};
+	KeySet		*keys = NULL, lkeys;
+	TupleField	*tuple;
+	SQLSETPOSIROW	irow, brow_save, done = 0;
+	SQLLEN		addpos, count, j, k;
+	OID		fieldtype, oid;
+	int		i, addcnt, nflds;
+	const char	*cmdstr;
+	char		*buffer;
+	SQLLEN		*used;
+	char		table_fqn[256];
+	RETCODE		ret = SQL_ERROR, qret;
+
+	if (PGAPI_AllocStmt(conn, &hstmt, 0) != SQL_SUCCESS)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "internal AllocStmt error", func);
+		return SQL_ERROR;
+	}
+	qstmt = (StatementClass *) hstmt;
+	initPQExpBuffer(&addstr);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	printfPQExpBuffer(&addstr,
+			 "insert into %s (",
+			 ti_quote(stmt, 0, table_fqn, sizeof(table_fqn)));
+	for (i = 0; i < add_cols; i++)
+		appendPQExpBuffer(&addstr, i ? ", \"%s\"" : "\"%s\"", GET_NAME(fi[cols[i]]->column_name));
+	appendPQExpBufferStr(&addstr, ") values ");
+	SC_get_APDF(qstmt)->param_offset_ptr = opts->row_offset_ptr;
+	ipdopts = SC_get_IPDF(qstmt);
+	extend_iparameter_bindings(ipdopts, (int) nrows * add_cols);
+	for (irow = first_row, k = 0; irow < first_row + nrows; irow++)
+	{
+		appendPQExpBufferStr(&addstr, irow > first_row ? ", (" : "(");
+		for (i = 0; i < add_cols; i++)
+		{
+			BindInfoClass	*bind = bindings + cols[i];
+			Int4		ctypelen;
+
+			if (bind_size > 0)
+			{
+				buffer = bind->buffer ? bind->buffer + bind_size * irow : NULL;
+				used = LENADDR_SHIFT(bind->used, bind_size * irow);
+			}
+			else
+			{
+				/* the fixed-length C types are packed regardless of buflen */
+				if (ctypelen = ctype_length(bind->returntype), ctypelen <= 0)
+					ctypelen = (Int4) bind->buflen;
+				buffer = bind->buffer ? bind->buffer + ctypelen * irow : NULL;
+				used = LENADDR_SHIFT(bind->used, irow * sizeof(SQLLEN));
+			}
+			fieldtype = getEffectiveOid(conn, fi[cols[i]]);
+			PIC_set_pgtype(ipdopts->parameters[k], fieldtype);
+			PGAPI_BindParameter(hstmt,
+				(SQLUSMALLINT) ++k,
+				SQL_PARAM_INPUT,
+				bind->returntype,
+				pgtype_to_concise_type(stmt, fieldtype, cols[i], unknown_sizes),
+				fi[cols[i]]->column_size > 0 ? fi[cols[i]]->column_size : pgtype_column_size(stmt, fieldtype, cols[i], unknown_sizes),
+				(SQLSMALLINT) fi[cols[i]]->decimal_digits,
+				buffer,
+				bind->buflen,
+				used);
+			appendPQExpBufferStr(&addstr, i ? ", ?" : "?");
+		}
+		appendPQExpBufferChar(&addstr, ')');
+	}
+	appendPQExpBufferStr(&addstr, " returning ctid");
+	if (bestitem)
+		appendPQExpBuffer(&addstr, ", \"%s\"", bestitem);
+	if (PQExpBufferDataBroken(addstr))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in pos_add_rows()", func);
+		goto cleanup;
+	}
+	MYLOG(0, "addstr=%s\n", addstr.data);
+	SC_set_delegate(stmt, qstmt);
+	qstmt->exec_start_row = qstmt->exec_end_row = 0;
+	ret = PGAPI_ExecDirect(hstmt, (SQLCHAR *) addstr.data, SQL_NTS, 0);
+	SC_setInsertedTable(qstmt, ret);
+	if (!SQL_SUCCEEDED(ret))
+	{
+		/* none of the rows was inserted */
+		SC_error_copy(stmt, qstmt, TRUE);
+		ret = SQL_NO_DATA_FOUND;
+		goto cleanup;
+	}
+
+	/* the keys of the inserted rows in the order of the rowset */
+	ires = SC_get_Curres(qstmt);
+	tres = (QR_nextr(ires) ? QR_nextr(ires) : ires);
+	cmdstr = QR_get_command(tres);
+	if (NULL == cmdstr ||
+		sscanf(cmdstr, "INSERT %u %d", &oid, &addcnt) != 2 ||
+		addcnt != (int) nrows ||
+		NULL == tres->backend_tuples ||
+		QR_get_num_cached_tuples(tres) != nrows)
+	{
+		SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "SetPos insert return error", func);
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	if (NULL == (keys = malloc(sizeof(KeySet) * nrows)))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in pos_add_rows()", func);
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	nflds = QR_NumResultCols(tres);
+	for (k = 0; k < (SQLLEN) nrows; k++)
+		KeySetSet(tres->backend_tuples + k * nflds, nflds, nflds, keys + k, TRUE);
+
+	/* read the inserted rows back */
+	printfPQExpBuffer(&addstr, "%s where ctid in (", stmt->load_statement);
+	for (k = 0; k < (SQLLEN) nrows; k++)
+		appendPQExpBuffer(&addstr, k ? ",'(%u,%u)'" : "'(%u,%u)'", keys[k].blocknum, keys[k].offset);
+	appendPQExpBufferChar(&addstr, ')');
+	if (PQExpBufferDataBroken(addstr))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in pos_add_rows()", func);
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	MYLOG(0, "selstr=%s\n", addstr.data);
+	qres = CC_send_query(conn, addstr.data, NULL, READ_ONLY_QUERY, stmt);
+	if (!QR_command_maybe_successful(qres))
+	{
+		SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "the reload of the inserted rows failed", func);
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+
+	count = QR_get_num_cached_tuples(qres);
+	for (k = 0, irow = first_row; k < (SQLLEN) nrows; k++, irow++)
+	{
+		/* the rows mostly come back in the order of the insertion */
+		tuple = NULL;
+		for (j = 0; j < count; j++)
+		{
+			TupleField	*qtuple = qres->backend_tuples + ((k + j) % count) * qres->num_fields;
+
+			KeySetSet(qtuple, qres->num_fields, res->num_key_fields, &lkeys, TRUE);
+			if (lkeys.blocknum == keys[k].blocknum &&
+				lkeys.offset == keys[k].offset)
+			{
+				tuple = qtuple;
+				break;
+			}
+		}
+		if (QR_get_cursor(res))
+			addpos = -(SQLLEN)(res->ad_count + 1);
+		else
+			addpos = QR_get_num_total_tuples(res);
+		if (NULL != tuple)
+			qret = pos_newload_tuple(stmt, res, qres, tuple);
+		else
+			qret = SQL_SUCCESS_WITH_INFO;
+		if (SQL_ERROR == qret)
+		{
+			ret = SQL_ERROR;
+			goto cleanup;
+		}
+		if (bookmark && bookmark->buffer)
+		{
+			brow_save = stmt->bind_row;
+			stmt->bind_row = irow;
+			SC_set_current_col(stmt, -1);
+			SC_Create_bookmark(stmt, bookmark, stmt->bind_row, addpos, keys + k);
+			stmt->bind_row = brow_save;
+		}
+		pos_add_set_status(stmt, res, irdflds, irow, qret);
+		if (SQL_SUCCESS != qret)
+			ret = SQL_SUCCESS_WITH_INFO;
+		done++;
+	}
+
+cleanup:
+#undef	return
+	if (SQL_ERROR == ret)
+	{
+		for (irow = first_row + done; irow < first_row + nrows; irow++)
+			pos_add_set_status(stmt, res, irdflds, irow, SQL_ERROR);
+	}
+	QR_Destructor(qres);
+	if (keys)
+		free(keys);
+	PGAPI_FreeStmt(hstmt, SQL_DROP);
+	if (!PQExpBufferDataBroken(addstr))
+		termPQExpBuffer(&addstr);
+	return ret;
+}
+
+/*
+ * Add the nrows rows of the rowset for SQLBulkOperations(SQL_ADD) by
+ * multi-row INSERT statements instead of one INSERT per row.
+ *
+ * Returns SQL_NO_DATA_FOUND without doing anything if the rowset can't
+ * be added this way, e.g. when a value is sent at execution time or the
+ * columns to insert differ between the rows. The rows are then to be
+ * added one by one by SC_pos_add().
+ *
+ * SQL_NO_DATA_FOUND is also returned when a multi-row INSERT fails, e.g.
+ * because one of its rows violates a constraint, with *processed set to
+ * the number of rows the preceding statements inserted and the error of
+ * the INSERT reset. The rows from *processed on are then to be added one
+ * by one by SC_pos_add(), which tells the failing rows from the others.
+ */
+RETCODE
+SC_pos_add_rowset(StatementClass *stmt, SQLSETPOSIROW nrows, SQLSETPOSIROW *processed)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	IRDFields	*irdflds;
+	BindInfoClass	*bindings = opts->bindings;
+	FIELD_INFO	**fi;
+	QResultClass	*res;
+	Int4		bind_size = opts->bind_size;
+	SQLULEN		offset;
+	SQLLEN		*used;
+	SQLSETPOSIROW	irow, rows_per_stmt;
+	int		*cols = NULL;
+	int		num_cols, add_cols, i;
+	int		func_cs_count = 0;
+	RETCODE		ret = SQL_NO_DATA_FOUND, qret;
+
+	*processed = 0;
+	if (nrows < 2 ||
+		!(res = SC_get_Curres(stmt)) ||
+		!PG_VERSION_GE(conn, 8.2))
+		return SQL_NO_DATA_FOUND;
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt) ||
+		NULL == stmt->ti ||
+		TI_has_subclass(stmt->ti[0]) ||
+		NULL == stmt->load_statement)
+		return SQL_NO_DATA_FOUND;
+	irdflds = SC_get_IRDF(stmt);
+	fi = irdflds->fi;
+	num_cols = irdflds->nfields;
+	if (num_cols > opts->allocated)
+		num_cols = opts->allocated;
+	if (NULL == (cols = malloc(sizeof(int) * (num_cols + 1))))
+		return SQL_NO_DATA_FOUND;
+	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+
+	/* every row must insert the same columns */
+	for (i = add_cols = 0; i < num_cols; i++)
+	{
+		BOOL	added = FALSE;
+
+		if (NULL == bindings[i].used || !fi[i]->updatable)
+			continue;
+		for (irow = 0; irow < nrows; irow++)
+		{
+			used = LENADDR_SHIFT(bindings[i].used, offset);
+			if (bind_size > 0)
+				used = LENADDR_SHIFT(used, bind_size * irow);
+			else
+				used = LENADDR_SHIFT(used, irow * sizeof(SQLLEN));
+			if (*used == SQL_DATA_AT_EXEC ||
+				*used <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+				goto cleanup;
+			if (0 == irow)
+				added = (*used != SQL_IGNORE);
+			else if (added != (*used != SQL_IGNORE))
+				goto cleanup;
+		}
+		if (added)
+			cols[add_cols++] = i;
+	}
+	if (0 == add_cols)
+		goto cleanup;
+
+	MYLOG(0, "adding " FORMAT_ULEN " rows of %d columns\n", nrows, add_cols);
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	rows_per_stmt = MAX_PARAMS_PER_STATEMENT / add_cols;
+	for (irow = 0; irow < nrows; irow += rows_per_stmt)
+	{
+		if (rows_per_stmt > nrows - irow)
+			rows_per_stmt = nrows - irow;
+		qret = pos_add_rows(stmt, res, cols, add_cols, irow, rows_per_stmt);
+		if (SQL_NO_DATA_FOUND == qret)
+		{
+			MYLOG(0, "INSERT of " FORMAT_ULEN " rows failed, adding them one by one\n", rows_per_stmt);
+			SC_clear_error(stmt);
+			ret = SQL_NO_DATA_FOUND;
+			break;
+		}
+		if (SQL_NO_DATA_FOUND == ret || SQL_SUCCESS == ret)
+			ret = qret;
+		if (SQL_ERROR == qret)
+			break;
+		*processed += rows_per_stmt;
+	}
+
+cleanup:
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+	free(cols);
+	return ret;
+}
+
 /*
  *	Stuff for updatable cursors end.
  */
@@ -5177,7 +5554,7 @@ MYLOG(0, "i=%d bidx=" FORMAT_LEN " cached=" FORMAT_ULEN "\n", i, bidx, res->num_
 			otuple = res->backend_tuples + i * num_fields;
 			ituple = qres->backend_tuples;
 			if (otuple != ituple)
-				MoveCachedRows(otuple, ituple, num_fields, 1);
+				QR_move_cached_rows(res, otuple, qres, ituple, num_fields, 1);
 			if (NULL != rowStatusArray)
 				rowStatusArray[i] = SQL_ROW_SUCCESS;
 		}
@@ -172,7 +172,30 @@ static const struct
 	}
 };
 
+/*
+ * The state of an execution libpq_bind_and_exec() left running for
+ * SQL_ASYNC_ENABLE_ON, kept until its result has arrived.
+ */
+struct AsyncExec
+{
+	notice_receiver_arg	nrarg;	/* the notices go to nrarg.res */
+	PGresult	*pgres;		/* the result read so far */
+	BOOL		drained;	/* nothing is left to read from libpq */
+	/* what SC_execute() resumes with */
+	Int2		oldstatus;
+	BOOL		is_in_trans;
+	BOOL		use_cursor;
+	unsigned int	qflag;
+	int		errnum_sav;
+	char		*errmsg_sav;
+};
+
 static QResultClass *libpq_bind_and_exec(StatementClass *stmt);
+static QResultClass *libpq_async_result(StatementClass *stmt, BOOL *busy);
+#ifdef	LIBPQ_HAS_PIPELINING
+static QResultClass *libpq_pipeline_exec(StatementClass *stmt);
+static QResultClass *libpq_copy_exec(StatementClass *stmt);
+#endif /* LIBPQ_HAS_PIPELINING */
 static void SC_set_errorinfo(StatementClass *self, QResultClass *res, int errkind);
 static void SC_set_error_if_not_set(StatementClass *self, int errornumber, const char *errmsg, const char *func);
 
@@ -253,6 +276,9 @@ PGAPI_FreeStmt(HSTMT hstmt,
 		return SQL_INVALID_HANDLE;
 	}
 	SC_clear_error(stmt);
+	/* the pending asynchronous execution is discarded with the results */
+	if (SQL_DROP == fOption || SQL_CLOSE == fOption)
+		SC_complete_async_exec(stmt);
 
 	if (fOption == SQL_DROP)
 	{
@@ -342,6 +368,7 @@ InitializeStatementOptions(StatementOptions *opt)
 	opt->retrieve_data = SQL_RD_ON;
 	opt->use_bookmarks = SQL_UB_OFF;
 	opt->metadata_id = SQL_FALSE;
+	opt->async_enable = SQL_ASYNC_ENABLE_OFF;
 }
 
 static void SC_clear_parse_status(StatementClass *self, ConnectionClass *conn)
@@ -410,6 +437,9 @@ SC_Constructor(ConnectionClass *conn)
 		SC_set_rowset_start(rv, -1, FALSE);
 		rv->current_col = -1;
 		rv->bind_row = 0;
+		rv->fetch_by_column = FALSE;
+		rv->fetch_by_plan = FALSE;
+		rv->fetch_plan = NULL;
 		rv->from_pos = rv->load_from_pos = rv->where_pos = -1;
 		rv->last_fetch_count = rv->last_fetch_count_include_ommitted = 0;
 		rv->save_rowset_size = -1;
@@ -455,6 +485,7 @@ SC_Constructor(ConnectionClass *conn)
 		rv->stmt_time = 0;
 		rv->execute_delegate = NULL;
 		rv->execute_parent = NULL;
+		rv->async_exec = NULL;
 		rv->allocated_callbacks = 0;
 		rv->num_callbacks = 0;
 		rv->callbacks = NULL;
@@ -464,6 +495,13 @@ SC_Constructor(ConnectionClass *conn)
 		rv->lock_CC_for_rb = FALSE;
 		// for batch execution
 		memset(&rv->stmt_deffered, 0, sizeof(rv->stmt_deffered));
+		rv->bind_allocated = 0;
+		rv->bind_types = NULL;
+		rv->bind_values = NULL;
+		rv->bind_lengths = NULL;
+		rv->bind_formats = NULL;
+		rv->bind_value_pos = NULL;
+		memset(&rv->bind_buf, 0, sizeof(rv->bind_buf));
 		if ((rv->batch_size = conn->connInfo.batch_size) < 1)
 			rv->batch_size = 1;
 		rv->exec_type = DIRECT_EXEC;
@@ -481,6 +519,11 @@ SC_Destructor(StatementClass *self)
 	QResultClass	*res = SC_get_Result(self);
 
 	MYLOG(0, "entering self=%p, self->result=%p, self->hdbc=%p\n", self, res, self->hdbc);
+	if (SC_async_executing(self))
+	{
+		SC_complete_async_exec(self);
+		res = SC_get_Result(self);
+	}
 	SC_clear_error(self);
 	if (STMT_EXECUTING == self->status)
 	{
@@ -509,6 +552,7 @@ SC_Destructor(StatementClass *self)
 	DC_Destructor((DescriptorClass *) SC_get_IPDi(self));
 	GDATA_unbind_cols(SC_get_GDTI(self), TRUE);
 	PDATA_free_params(SC_get_PDTI(self), STMT_FREE_PARAMS_ALL);
+	free_fetch_plan(self->fetch_plan);
 
 	if (self->__error_message)
 		free(self->__error_message);
@@ -519,6 +563,7 @@ SC_Destructor(StatementClass *self)
 		free(self->callbacks);
 	if (!PQExpBufferDataBroken(self->stmt_deffered))
 		termPQExpBuffer(&self->stmt_deffered);
+	SC_free_bind_params(self);
 
 	DELETE_STMT_CS(self);
 	free(self);
@@ -617,6 +662,28 @@ statement_type(const char *statement)
 	return STMT_TYPE_OTHER;
 }
 
+/*
+ * Set the type of the new statement, and its parameter counts as well if
+ * it is in the cache of processed statements, without scanning it.
+ */
+void
+SC_set_statement_type(StatementClass *self)
+{
+	Int2	stmt_type, num_params;
+	po_ind_t	multi;
+
+	if (!CC_lookup_scanned(SC_get_conn(self), self->statement, &stmt_type, &num_params, &multi))
+	{
+		self->statement_type = statement_type(self->statement);
+		return;
+	}
+	MYLOG(DETAIL_LOG_LEVEL, "found in the cache of processed statements\n");
+	self->statement_type = stmt_type;
+	self->num_params = num_params;
+	self->multi_statement = multi;
+	self->proc_return = 0;
+}
+
 void
 SC_set_planname(StatementClass *stmt, const char *plan_name)
 {
@@ -693,7 +760,9 @@ SC_set_prepared(StatementClass *stmt, int prepared)
 		if (conn)
 		{
 			ENTER_CONN_CS(conn);
-			if (CONN_CONNECTED == conn->status)
+			if (CC_release_plan(conn, stmt->plan_name))
+				;	/* the plan stays in the cache */
+			else if (CONN_CONNECTED == conn->status)
 			{
 				if (CC_is_in_error_trans(conn))
 				{
@@ -855,6 +924,7 @@ SC_recycle_statement(StatementClass *self)
 
 	MYLOG(0, "entering self=%p\n", self);
 
+	SC_complete_async_exec(self);
 	SC_clear_error(self);
 	/* This would not happen */
 	if (self->status == STMT_EXECUTING)
@@ -1625,6 +1695,25 @@ PGAPI_StmtError(SQLHSTMT	hstmt,
 						  pcbErrorMsg, flag);
 }
 
+/*
+ *	The memory the results and the SQLGetData buffers of the statement
+ *	hold, including the values the results spilled to a file. The
+ *	result exclude isn't counted.
+ */
+SQLULEN
+SC_get_result_memory(StatementClass *self, const QResultClass *exclude)
+{
+	SQLULEN		size = GDATA_get_memory_size(SC_get_GDTI(self));
+	QResultClass	*res;
+
+	for (res = SC_get_Result(self); NULL != res; res = QR_nextr(res))
+	{
+		if (res != exclude)
+			size += QR_get_memory_size(res) + QR_get_spilled_size(res);
+	}
+	return size;
+}
+
 time_t
 SC_get_time(StatementClass *stmt)
 {
@@ -1656,10 +1745,83 @@ SC_get_localtime(StatementClass *stmt)
 	return &(stmt->localtime);
 }
 
+/*
+ *	Fold the return value of copy_and_convert_field() for the column lf
+ *	into the result of a fetch.
+ */
+static RETCODE
+SC_copy_result(StatementClass *self, int retval, int lf, const char *value, RETCODE result)
+{
+	CSTR func = "SC_fetch";
+
+	switch (retval)
+	{
+		case COPY_OK:
+			break;		/* OK, do next bound column */
+
+		case COPY_UNSUPPORTED_TYPE:
+			SC_set_error(self, STMT_RESTRICTED_DATA_TYPE_ERROR, "Received an unsupported type from Postgres.", func);
+			result = SQL_ERROR;
+			break;
+
+		case COPY_UNSUPPORTED_CONVERSION:
+			SC_set_error(self, STMT_RESTRICTED_DATA_TYPE_ERROR, "Couldn't handle the necessary data type conversion.", func);
+			result = SQL_ERROR;
+			break;
+
+		case COPY_RESULT_TRUNCATED:
+			SC_set_error(self, STMT_TRUNCATED, "Fetched item was truncated.", func);
+			MYLOG(DETAIL_LOG_LEVEL, "The %dth item was truncated\n", lf + 1);
+			MYLOG(DETAIL_LOG_LEVEL, "The buffer size = " FORMAT_LEN, SC_get_ARDF(self)->bindings[lf].buflen);
+			MYLOG(DETAIL_LOG_LEVEL, " and the value is '%s'\n", value);
+			result = SQL_SUCCESS_WITH_INFO;
+			break;
+
+		case COPY_INVALID_STRING_CONVERSION:    /* invalid string */
+			SC_set_error(self, STMT_STRING_CONVERSION_ERROR, "invalid string conversion occured.", func);
+			result = SQL_ERROR;
+			break;
+
+			/* error msg already filled in */
+		case COPY_GENERAL_ERROR:
+			result = SQL_ERROR;
+			break;
+
+			/* This would not be meaningful in SQLFetch. */
+		case COPY_NO_DATA_FOUND:
+			break;
+
+		default:
+			SC_set_error(self, STMT_INTERNAL_ERROR, "Unrecognized return value from copy_and_convert_field.", func);
+			result = SQL_ERROR;
+			break;
+	}
+	return result;
+}
+
+/*
+ *	SC_copy_result() for the row of SC_fetch_by_column(), which marks
+ *	the row failed and goes on with the other rows as SC_fetch() does.
+ */
+static RETCODE
+SC_copy_row_result(StatementClass *self, int retval, int lf, const char *value, SQLLEN row, SQLUSMALLINT *row_status, RETCODE result)
+{
+	RETCODE		ret = SC_copy_result(self, retval, lf, value, SQL_SUCCESS);
+
+	if (SQL_ERROR == ret)
+	{
+		if (row_status)
+			row_status[row] = SQL_ROW_ERROR;
+		return SQL_ERROR;
+	}
+	if (SQL_SUCCESS == ret || SQL_ERROR == result)
+		return result;
+	return ret;
+}
+
 RETCODE
 SC_fetch(StatementClass *self)
 {
-	CSTR func = "SC_fetch";
 	QResultClass *res = SC_get_Curres(self);
 	ARDFields	*opts;
 	GetDataInfo	*gdata;
@@ -1686,7 +1848,8 @@ MYLOG(DETAIL_LOG_LEVEL, "entering statement=%p res=%p ommitted=0\n", self, res);
 
 	MYLOG(0, "fetch_cursor=%d, %p->total_read=" FORMAT_LEN "\n", SC_is_fetchcursor(self), res, res->num_total_read);
 
-	useCursor = (SC_is_fetchcursor(self) && (NULL != QR_get_cursor(res)));
+	useCursor = ((SC_is_fetchcursor(self) && (NULL != QR_get_cursor(res))) ||
+		     QR_is_streaming(res));
 	if (!useCursor)
 	{
 		if (self->currTuple >= (Int4) QR_get_num_total_tuples(res) - 1 ||
@@ -1775,6 +1938,28 @@ MYLOG(DETAIL_LOG_LEVEL, "stmt=%p ommitted++\n", self);
 
 	if (self->options.retrieve_data == SQL_RD_OFF)		/* data isn't required */
 		return SQL_SUCCESS;
+	/* SC_fetch_by_column() converts the columns after all the rows */
+	if (self->fetch_by_column)
+		return SQL_SUCCESS;
+	if (self->fetch_by_plan)
+	{
+		const FetchPlan	*plan = self->fetch_plan;
+		const FetchPlanCol	*pc;
+		SQLLEN	curt = 0;
+
+		if (!useCursor)
+			curt = GIdx2CacheIdx(self->currTuple, self, res);
+		for (pc = plan->cols; pc < plan->cols + plan->num_cols; pc++)
+		{
+			if (useCursor)
+				value = QR_get_value_backend(res, pc->col);
+			else
+				value = QR_get_value_backend_row(res, curt, pc->col);
+			retval = copy_and_convert_field_planned(self, pc, value);
+			result = SC_copy_result(self, retval, pc->col, value, result);
+		}
+		return result;
+	}
 	/* The following adjustment would be needed after SQLMoreResults() */
 	if (opts->allocated < num_cols)
 		extend_column_bindings(opts, num_cols);
@@ -1812,54 +1997,102 @@ MYLOG(DETAIL_LOG_LEVEL, "curt=" FORMAT_LEN "\n", curt);
 
 			MYLOG(0, "value = '%s'\n", (value == NULL) ? "<NULL>" : value);
 
-			retval = copy_and_convert_field_bindinfo(self, type, atttypmod, value, lf);
+			retval = copy_and_convert_field_bindinfo(self, type, atttypmod, value, lf, CI_is_binary(coli, lf));
 
 			MYLOG(0, "copy_and_convert: retval = %d\n", retval);
 
-			switch (retval)
-			{
-				case COPY_OK:
-					break;		/* OK, do next bound column */
-
-				case COPY_UNSUPPORTED_TYPE:
-					SC_set_error(self, STMT_RESTRICTED_DATA_TYPE_ERROR, "Received an unsupported type from Postgres.", func);
-					result = SQL_ERROR;
-					break;
-
-				case COPY_UNSUPPORTED_CONVERSION:
-					SC_set_error(self, STMT_RESTRICTED_DATA_TYPE_ERROR, "Couldn't handle the necessary data type conversion.", func);
-					result = SQL_ERROR;
-					break;
+			result = SC_copy_result(self, retval, lf, value, result);
+		}
+	}
 
-				case COPY_RESULT_TRUNCATED:
-					SC_set_error(self, STMT_TRUNCATED, "Fetched item was truncated.", func);
-					MYLOG(DETAIL_LOG_LEVEL, "The %dth item was truncated\n", lf + 1);
-					MYLOG(DETAIL_LOG_LEVEL, "The buffer size = " FORMAT_LEN, opts->bindings[lf].buflen);
-					MYLOG(DETAIL_LOG_LEVEL, " and the value is '%s'\n", value);
-					result = SQL_SUCCESS_WITH_INFO;
-					break;
+	return result;
+}
 
-				case COPY_INVALID_STRING_CONVERSION:    /* invalid string */
-					SC_set_error(self, STMT_STRING_CONVERSION_ERROR, "invalid string conversion occured.", func);
-					result = SQL_ERROR;
-					break;
+/*
+ *	Convert the bound columns of the first num_rows rows of the rowset
+ *	one column at a time, which walks the values of a column in the
+ *	order they are stored in the cache. This is for column-wise binding
+ *	of the rows which SC_fetch() read with fetch_by_column on.
+ *
+ *	The rows whose conversion fails are set to SQL_ROW_ERROR in
+ *	row_status (if not NULL) and SQL_ERROR is returned.
+ */
+#define	FETCH_BATCH_ROWS	256
+RETCODE
+SC_fetch_by_column(StatementClass *self, SQLLEN num_rows, SQLUSMALLINT *row_status)
+{
+	QResultClass	*res = SC_get_Curres(self);
+	ARDFields	*opts = SC_get_ARDF(self);
+	GetDataInfo	*gdata = SC_get_GDTI(self);
+	ColumnInfoClass	*coli = QR_get_fields(res);
+	int		num_cols = QR_NumPublicResultCols(res);
+	int		lf, retval, atttypmod;
+	OID		type;
+	BOOL		binary;
+	SQLLEN		row, curt;
+	char		*value;
+	RETCODE		result = SQL_SUCCESS;
+
+	MYLOG(0, "entering rows=" FORMAT_LEN " cols=%d\n", num_rows, num_cols);
+	if (self->fetch_by_plan)
+	{
+		const FetchPlan	*plan = self->fetch_plan;
+		const FetchPlanCol	*pc;
+		char	*values[FETCH_BATCH_ROWS];
+		SQLLEN	nvals, i;
 
-					/* error msg already filled in */
-				case COPY_GENERAL_ERROR:
-					result = SQL_ERROR;
-					break;
+		/* the values of each column are converted FETCH_BATCH_ROWS at a time */
+		for (pc = plan->cols; pc < plan->cols + plan->num_cols; pc++)
+		{
+			for (row = 0; row < num_rows; row += nvals)
+			{
+				nvals = num_rows - row;
+				if (nvals > FETCH_BATCH_ROWS)
+					nvals = FETCH_BATCH_ROWS;
+				for (i = 0; i < nvals; i++)
+				{
+					curt = GIdx2CacheIdx(RowIdx2GIdx(row + i, self), self, res);
+					values[i] = QR_get_value_backend_row(res, curt, pc->col);
+				}
+				for (i = 0; i < nvals; i++)
+				{
+					i += copy_and_convert_column_planned(self, pc, values + i, (SQLSETPOSIROW) (row + i), nvals - i);
+					if (i >= nvals)
+						break;
+					self->bind_row = (SQLSETPOSIROW) (row + i);
+					retval = copy_and_convert_field_planned(self, pc, values[i]);
+					result = SC_copy_row_result(self, retval, pc->col, values[i], row + i, row_status, result);
+				}
+			}
+		}
+		self->bind_row = 0;
 
-					/* This would not be meaningful in SQLFetch. */
-				case COPY_NO_DATA_FOUND:
-					break;
+		return result;
+	}
+	if (opts->allocated < num_cols)
+		extend_column_bindings(opts, num_cols);
+	if (gdata->allocated != opts->allocated)
+		extend_getdata_info(gdata, opts->allocated, TRUE);
+	for (lf = 0; lf < num_cols; lf++)
+	{
+		/* reset for SQLGetData */
+		GETDATA_RESET(gdata->gdata[lf]);
 
-				default:
-					SC_set_error(self, STMT_INTERNAL_ERROR, "Unrecognized return value from copy_and_convert_field.", func);
-					result = SQL_ERROR;
-					break;
-			}
+		if (NULL == opts->bindings || NULL == opts->bindings[lf].buffer)
+			continue;
+		type = CI_get_oid(coli, lf);
+		atttypmod = CI_get_atttypmod(coli, lf);
+		binary = CI_is_binary(coli, lf);
+		for (row = 0; row < num_rows; row++)
+		{
+			curt = GIdx2CacheIdx(RowIdx2GIdx(row, self), self, res);
+			value = QR_get_value_backend_row(res, curt, lf);
+			self->bind_row = (SQLSETPOSIROW) row;
+			retval = copy_and_convert_field_bindinfo(self, type, atttypmod, value, lf, binary);
+			result = SC_copy_row_result(self, retval, lf, value, row, row_status, result);
 		}
 	}
+	self->bind_row = 0;
 
 	return result;
 }
@@ -1886,10 +2119,40 @@ SC_execute(StatementClass *self)
 	char		*errmsg_sav = NULL;
 	SQLULEN		stmt_timeout;
 	QResultHold	rhold = {0};
+	QResultClass	*first;
+	BOOL		still_executing = FALSE;
 
 	conn = SC_get_conn(self);
 	ci = &(conn->connInfo);
 
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	if (SC_async_executing(self))
+	{
+		struct AsyncExec	*async = self->async_exec;
+		BOOL		busy;
+
+		/* poll the execution left running by the previous call */
+		ENTER_INNER_CONN_CS(conn, func_cs_count);
+		oldstatus = async->oldstatus;
+		is_in_trans = async->is_in_trans;
+		useCursor = async->use_cursor;
+		qflag = async->qflag;
+		errnum_sav = async->errnum_sav;
+		errmsg_sav = async->errmsg_sav;
+		isSelectType = (SC_may_use_cursor(self) || self->statement_type == STMT_TYPE_PROCCALL);
+		first = libpq_async_result(self, &busy);
+		if (busy)
+		{
+			still_executing = TRUE;
+			goto cleanup;
+		}
+		free(async);
+		self->async_exec = NULL;
+		if (conn->async_stmt == self)
+			conn->async_stmt = NULL;
+		goto async_done;
+	}
+
 	errnum_sav = SC_get_errornumber(self);
 	errmsg_sav = SC_get_errormsg(self);
 	if (NULL != errmsg_sav)
@@ -1906,7 +2169,6 @@ SC_execute(StatementClass *self)
 	 * 2) we are in autocommit off state and the statement isn't of type
 	 * OTHER.
 	 */
-#define	return	DONT_CALL_RETURN_FROM_HERE???
 	ENTER_INNER_CONN_CS(conn, func_cs_count);
 	oldstatus = conn->status;
 	if (CONN_EXECUTING == conn->status)
@@ -2007,12 +2269,33 @@ SC_execute(StatementClass *self)
 	isSelectType = (SC_may_use_cursor(self) || self->statement_type == STMT_TYPE_PROCCALL);
 	if (use_extended_protocol)
 	{
-		QResultClass *first;
-
-		if (issue_begin)
+		/* otherwise RequestStart() begins it with the request */
+		if (issue_begin && !CC_loves_visible_trans(conn))
 			CC_begin(conn);
 
+#ifdef	LIBPQ_HAS_PIPELINING
+		if (PIPELINE_EXEC == self->exec_type)
+			first = libpq_pipeline_exec(self);
+		else if (COPY_EXEC == self->exec_type)
+			first = libpq_copy_exec(self);
+		else
+#endif /* LIBPQ_HAS_PIPELINING */
 		first = libpq_bind_and_exec(self);
+		if (!first && SC_async_executing(self))
+		{
+			struct AsyncExec	*async = self->async_exec;
+
+			/* SQLExecute() is called again until the result arrives */
+			async->oldstatus = oldstatus;
+			async->is_in_trans = is_in_trans;
+			async->use_cursor = useCursor;
+			async->qflag = qflag;
+			async->errnum_sav = errnum_sav;
+			async->errmsg_sav = errmsg_sav;
+			still_executing = TRUE;
+			goto cleanup;
+		}
+async_done:
 		if (!first)
 		{
 			if (SC_get_errornumber(self) <= 0)
@@ -2046,6 +2329,14 @@ SC_execute(StatementClass *self)
 			appendq = fetch;
 			qflag &= (~READ_ONLY_QUERY); /* must be a SAVEPOINT after DECLARE */
 		}
+		else if (ci->stream_results &&
+			 !issue_begin &&
+			 STMT_TYPE_SELECT == self->statement_type &&
+			 0 == self->multi_statement &&
+			 0 == self->options.maxRows &&
+			 SQL_CURSOR_FORWARD_ONLY == self->options.cursor_type &&
+			 SQL_CONCUR_READ_ONLY == self->options.scroll_concurrency)
+			qflag |= STREAM_ROWS;
 		rhold = CC_send_query_append(conn, self->stmt_with_params, qryi, qflag, SC_get_ancestor(self), appendq);
 		first = rhold.first;	
 		if (useCursor && QR_command_maybe_successful(first))
@@ -2356,6 +2647,12 @@ MYLOG(DETAIL_LOG_LEVEL, "!!SC_fetch return =%d\n", ret);
 	}
 cleanup:
 #undef	return
+	if (still_executing)
+	{
+		/* the statement and the connection stay executing */
+		CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+		return SQL_STILL_EXECUTING;
+	}
 	SC_SetExecuting(self, FALSE);
 	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
 	if (CONN_DOWN != conn->status)
@@ -2503,8 +2800,18 @@ SC_log_error(const char *func, const char *desc, const StatementClass *self)
  *	Extended Query
  */
 
+/*
+ * Start a request: set the per-statement savepoint or begin a transaction
+ * implicitly if needed.
+ *
+ * If 'ctrlcmd' is not NULL, the SAVEPOINT or BEGIN command isn't issued
+ * here but copied to it, so that the caller sends it in the same pipeline
+ * as the request and reads its result by read_control_result(). It's left
+ * empty if no command is needed.
+ */
 static BOOL
-RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
+RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func,
+			 char *ctrlcmd, size_t ctrlsize)
 {
 	BOOL	ret = TRUE;
 	unsigned int	svpopt = 0;
@@ -2518,10 +2825,15 @@ RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
 		SC_set_error(stmt, STMT_COMMUNICATION_ERROR, "The connection has been lost", __FUNCTION__);
 		return SQL_ERROR;
 	}
+	CC_finish_pending_rows(conn);
+	if (ctrlcmd)
+		ctrlcmd[0] = '\0';
 	if (CC_started_rbpoint(conn))
 		return TRUE;
 	if (SC_is_readonly(stmt))
 		svpopt |= SVPOPT_RDONLY;
+	if (ctrlcmd)
+		svpopt |= SVPOPT_REDUCE_ROUNDTRIP;
 	if (SQL_ERROR == SetStatementSvp(stmt, svpopt))
 	{
 		char	emsg[128];
@@ -2530,6 +2842,12 @@ RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
 		SC_set_error_if_not_set(stmt, STMT_INTERNAL_ERROR, emsg, func);
 		return FALSE;
 	}
+	if (ctrlcmd && PREPEND_IN_PROGRESS == conn->internal_op)
+	{
+		GenerateSvpCommand(conn, INTERNAL_SAVEPOINT_OPERATION, ctrlcmd, (int) ctrlsize);
+		conn->internal_op = SAVEPOINT_IN_PROGRESS;
+		return TRUE;
+	}
 
 	/*
 	 * In auto-commit mode, begin a new transaction implicitly if no
@@ -2539,11 +2857,69 @@ RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
 	if (!CC_is_in_trans(conn) && CC_loves_visible_trans(conn) &&
 		stmt->statement_type != STMT_TYPE_SPECIAL)
 	{
-		ret = CC_begin(conn);
+		if (ctrlcmd)
+			strncpy_null(ctrlcmd, "BEGIN", ctrlsize);
+		else
+			ret = CC_begin(conn);
 	}
 	return ret;
 }
 
+/*
+ * Issue the command RequestStart() left to the caller by itself, when the
+ * request doesn't go to the server after all.
+ */
+static BOOL
+issue_control_command(ConnectionClass *conn, const char *ctrlcmd)
+{
+	QResultClass	*res;
+	BOOL		ret;
+
+	if (SAVEPOINT_IN_PROGRESS != conn->internal_op)
+		return CC_begin(conn);
+	res = CC_send_query(conn, ctrlcmd, NULL, 0, NULL);
+	conn->internal_op = 0;
+	ret = QR_command_maybe_successful(res);
+	QR_Destructor(res);
+
+	return ret;
+}
+
+#ifdef	LIBPQ_HAS_PIPELINING
+/*
+ * Read the result of the command RequestStart() left to the caller, sent
+ * ahead of the request in pipeline mode. If it failed, the error is set to
+ * 'res' and the request is reported as PGRES_PIPELINE_ABORTED. Returns
+ * FALSE if the connection is broken.
+ */
+static BOOL
+read_control_result(ConnectionClass *conn, QResultClass *res)
+{
+	PGresult   *pgres;
+	BOOL		svp = (SAVEPOINT_IN_PROGRESS == conn->internal_op);
+
+	if (NULL == (pgres = PQgetResult(conn->pqconn)))
+		return FALSE;
+	if (PGRES_COMMAND_OK == PQresultStatus(pgres))
+	{
+		QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+		if (svp)
+			CC_start_rbpoint(conn);
+		else
+			CC_set_in_trans(conn);
+	}
+	else
+		handle_pgres_error(conn, pgres, "read_control_result", res, TRUE);
+	if (svp)
+		conn->internal_op = 0;
+	PQclear(pgres);
+	while (NULL != (pgres = PQgetResult(conn->pqconn)))
+		PQclear(pgres);
+
+	return TRUE;
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
 static void log_params(int nParams, const Oid *paramTypes, const UCHAR * const *paramValues, const int *paramLengths, const int *paramFormats, int resultFormat)
 {
 	int	i, j;
@@ -2581,70 +2957,346 @@ QResultClass *add_libpq_notice_receiver(StatementClass *stmt, notice_receiver_ar
 	return newres;
 }
 
-static QResultClass *
-libpq_bind_and_exec(StatementClass *stmt)
+/*
+ * Make room for num_params parameters in the libpq parameter arrays of
+ * the statement. The arrays only grow, so that the executions of the
+ * statement don't allocate them each time.
+ */
+BOOL
+SC_reserve_bind_params(StatementClass *self, int num_params)
 {
-	CSTR		func = "libpq_bind_and_exec";
-	ConnectionClass	*conn = SC_get_conn(stmt);
-	int			nParams;
-	Oid		   *paramTypes = NULL;
-	char	  **paramValues = NULL;
-	int		   *paramLengths = NULL;
-	int		   *paramFormats = NULL;
-	int			resultFormat;
-	PGresult   *pgres = NULL;
-	int			pgresstatus;
-	QResultClass	*newres = NULL;
-	QResultClass *res = NULL;
-	char	   *cmdtag;
-	char	   *rowcount;
-	notice_receiver_arg	nrarg;
+	void	*p;
 
-	if (!RequestStart(stmt, conn, func))
-		return NULL;
+	if (num_params <= self->bind_allocated)
+		return TRUE;
+	if (p = realloc(self->bind_types, sizeof(OID) * num_params), NULL == p)
+		return FALSE;
+	self->bind_types = p;
+	if (p = realloc(self->bind_values, sizeof(char *) * num_params), NULL == p)
+		return FALSE;
+	self->bind_values = p;
+	if (p = realloc(self->bind_lengths, sizeof(int) * num_params), NULL == p)
+		return FALSE;
+	self->bind_lengths = p;
+	if (p = realloc(self->bind_formats, sizeof(int) * num_params), NULL == p)
+		return FALSE;
+	self->bind_formats = p;
+	if (p = realloc(self->bind_value_pos, sizeof(ssize_t) * num_params), NULL == p)
+		return FALSE;
+	self->bind_value_pos = p;
+	self->bind_allocated = num_params;
 
-#ifdef	NOT_USED
-	if (CC_is_in_trans(conn) && !CC_started_rbpoint(conn))
+	return TRUE;
+}
+
+void
+SC_free_bind_params(StatementClass *self)
+{
+	if (self->bind_types)
+		free(self->bind_types);
+	if (self->bind_values)
+		free(self->bind_values);
+	if (self->bind_lengths)
+		free(self->bind_lengths);
+	if (self->bind_formats)
+		free(self->bind_formats);
+	if (self->bind_value_pos)
+		free(self->bind_value_pos);
+	self->bind_types = NULL;
+	self->bind_values = NULL;
+	self->bind_lengths = NULL;
+	self->bind_formats = NULL;
+	self->bind_value_pos = NULL;
+	self->bind_allocated = 0;
+	if (!PQExpBufferDataBroken(self->bind_buf))
+		termPQExpBuffer(&self->bind_buf);
+	memset(&self->bind_buf, 0, sizeof(self->bind_buf));
+}
+
+/*
+ * The result format for libpq_bind_and_exec().
+ *
+ * libpq can't request the format column by column, so the binary format
+ * is used only when the driver handles the binary layouts of all the
+ * described columns.
+ */
+static int
+binary_result_format(const StatementClass *stmt)
+{
+	const ConnectionClass *conn = SC_get_conn(stmt);
+	QResultClass	*res = SC_get_ExecdOrParsed(stmt);
+	ColumnInfoClass	*flds;
+	int		i, num_fields;
+
+	if (!conn->connInfo.binary_results)
+		return 0;
+	if (SQL_CURSOR_FORWARD_ONLY != stmt->options.cursor_type ||
+		SQL_CONCUR_READ_ONLY != stmt->options.scroll_concurrency ||
+		SC_is_fetchcursor(stmt))
+		return 0;
+	if (NULL == res || NULL != QR_nextr(res) || QR_haskeyset(res))
+		return 0;
+	flds = QR_get_fields(res);
+	if (NULL == flds || NULL == flds->coli_array ||
+		(num_fields = CI_get_num_fields(flds)) <= 0)
+		return 0;
+	for (i = 0; i < num_fields; i++)
 	{
-		if (SQL_ERROR == SetStatementSvp(stmt, 0))
-		{
-			SC_set_error_if_not_set(stmt, STMT_INTERNAL_ERROR, "internal savepoint error in build_libpq_bind_params", func);
-			return NULL;
-		}
+		if (!pg_binary_result_supported(CI_get_oid(flds, i)))
+			return 0;
 	}
-#endif /* NOT_USED */
+	MYLOG(0, "requesting the binary result format\n");
+	return 1;
+}
 
-	/* 1. Bind */
-	MYLOG(0, "bind stmt=%p\n", stmt);
-	if (!build_libpq_bind_params(stmt,
-								 &nParams,
-								 &paramTypes,
-								 &paramValues,
-								 &paramLengths, &paramFormats,
-								 &resultFormat))
+#ifdef	LIBPQ_HAS_PIPELINING
+/*
+ * Binding a SQL_LONGVARBINARY parameter may create a large object, which
+ * must be done in the transaction of the statement.
+ */
+static BOOL
+may_bind_large_objects(StatementClass *stmt)
+{
+	IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	int		i;
+
+	for (i = 0; i < ipdopts->allocated; i++)
 	{
-		if (SC_get_errornumber(stmt) <= 0)
-			SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
-		goto cleanup;
+		if (SQL_LONGVARBINARY == ipdopts->parameters[i].SQLType)
+			return TRUE;
 	}
+	return FALSE;
+}
 
-	/* 2. Execute */
-	MYLOG(0, "execute stmt=%p\n", stmt);
-	if (!SC_is_fetchcursor(stmt))
+/*
+ * Execute a statement in pipeline mode after the command RequestStart()
+ * left to the caller, to save its round trip. The statement is the query
+ * 'query' if not NULL, otherwise the prepared statement 'plan_name'.
+ *
+ * Returns the result of the execution, which is PGRES_PIPELINE_ABORTED if
+ * the command failed, or NULL if the connection is broken.
+ */
+static PGresult *
+pipeline_exec_with_control(ConnectionClass *conn, const char *ctrlcmd,
+						   QResultClass *res,
+						   const char *query, const char *plan_name,
+						   int nParams, const Oid *paramTypes,
+						   const char * const *paramValues,
+						   const int *paramLengths, const int *paramFormats,
+						   int resultFormat)
+{
+	CSTR		func = "pipeline_exec_with_control";
+	PGconn	   *pqconn = conn->pqconn;
+	PGresult   *pgres = NULL, *pgres2;
+	BOOL		broken = TRUE;
+
+	if (!PQenterPipelineMode(pqconn))
+		goto cleanup;
+	QLOG(0, "PQsendQueryParams: %p '%s'\n", pqconn, ctrlcmd);
+	if (!PQsendQueryParams(pqconn, ctrlcmd, 0, NULL, NULL, NULL, NULL, 0))
+		goto cleanup;
+	if (query)
 	{
-		if (stmt->prepared == NOT_YET_PREPARED ||
-			(stmt->prepared == PREPARED_TEMPORARILY && conn->unnamed_prepared_stmt != stmt))
-		{
-			SC_set_error(stmt, STMT_EXEC_ERROR, "about to execute a non-prepared statement", func);
+		if (!PQsendQueryParams(pqconn, query, nParams, paramTypes,
+							   paramValues, paramLengths, paramFormats,
+							   resultFormat))
 			goto cleanup;
-		}
 	}
-
-	/* 2.5 Prepare and Describe if needed */
-	if (stmt->prepared == PREPARING_TEMPORARILY ||
-		(stmt->prepared == PREPARED_TEMPORARILY && conn->unnamed_prepared_stmt != stmt))
+	else if (!PQsendQueryPrepared(pqconn, plan_name, nParams,
+								  paramValues, paramLengths, paramFormats,
+								  resultFormat))
+		goto cleanup;
+	if (!PQpipelineSync(pqconn))
+		goto cleanup;
+	if (!read_control_result(conn, res))
+		goto cleanup;
+	/* the result of the execution followed by NULL */
+	if (NULL == (pgres = PQgetResult(pqconn)))
+		goto cleanup;
+	while (NULL != (pgres2 = PQgetResult(pqconn)))
+		PQclear(pgres2);
+	/* and the Sync */
+	if (NULL == (pgres2 = PQgetResult(pqconn)))
+		goto cleanup;
+	broken = (PGRES_PIPELINE_SYNC != PQresultStatus(pgres2));
+	PQclear(pgres2);
+cleanup:
+	if (PQ_PIPELINE_OFF != PQpipelineStatus(pqconn) &&
+		!PQexitPipelineMode(pqconn))
+		broken = TRUE;
+	if (broken)
 	{
-		ProcessedStmt *pstmt;
+		if (pgres)
+			PQclear(pgres);
+		pgres = NULL;
+		CC_set_error(conn, CONNECTION_COMMUNICATION_ERROR, "Unexpected result in pipeline mode", func);
+		CC_on_abort(conn, CONN_DEAD);
+	}
+
+	return pgres;
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
+/*
+ * Read the result 'pgres' of the execution into 'res'. Returns FALSE if
+ * the rows couldn't be stored.
+ */
+static BOOL
+receive_exec_result(StatementClass *stmt, QResultClass *res, PGresult **pgres)
+{
+	CSTR		func = "libpq_bind_and_exec";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	int			pgresstatus;
+	char	   *cmdtag;
+	char	   *rowcount;
+
+	pgresstatus = PQresultStatus(*pgres);
+	switch (pgresstatus)
+	{
+		case PGRES_COMMAND_OK:
+			/* portal query command, no tuples returned */
+			/* read in the return message from the backend */
+			cmdtag = PQcmdStatus(*pgres);
+			QLOG(0, "\tok: - 'C' - %s\n", cmdtag);
+			QR_set_command(res, cmdtag);
+			if (QR_command_successful(res))
+				QR_set_rstatus(res, PORES_COMMAND_OK);
+
+			/* get rowcount */
+			rowcount = PQcmdTuples(*pgres);
+			if (rowcount && rowcount[0])
+				res->recent_processed_row_count = atoi(rowcount);
+			else
+				res->recent_processed_row_count = -1;
+			break;
+
+		case PGRES_EMPTY_QUERY:
+			/* We return the empty query */
+			QR_set_rstatus(res, PORES_EMPTY_QUERY);
+			break;
+		case PGRES_NONFATAL_ERROR:
+			handle_pgres_error(conn, *pgres, "libpq_bind_and_exec", res, FALSE);
+			break;
+#ifdef	LIBPQ_HAS_PIPELINING
+		case PGRES_PIPELINE_ABORTED:
+			/* the implicit SAVEPOINT or BEGIN failed and set the error */
+			break;
+#endif /* LIBPQ_HAS_PIPELINING */
+
+		case PGRES_BAD_RESPONSE:
+		case PGRES_FATAL_ERROR:
+			handle_pgres_error(conn, *pgres, "libpq_bind_and_exec", res, TRUE);
+			break;
+		case PGRES_TUPLES_OK:
+			if (!QR_from_PGresult(res, stmt, conn, NULL, pgres))
+				return FALSE;
+			if (res->rstatus == PORES_TUPLES_OK && res->notice)
+				QR_set_rstatus(res, PORES_NONFATAL_ERROR);
+			break;
+		case PGRES_COPY_OUT:
+		case PGRES_COPY_IN:
+		case PGRES_COPY_BOTH:
+		default:
+			/* skip the unexpected response if possible */
+			QR_set_rstatus(res, PORES_BAD_RESPONSE);
+			CC_set_error(conn, CONNECTION_BACKEND_CRAZY, "Unexpected protocol character from backend (send_query)", func);
+			CC_on_abort(conn, CONN_DEAD);
+
+			QLOG(0, "PQexecXxxx error: - (%d) - %s\n", pgresstatus, CC_get_errormsg(conn));
+			break;
+	}
+
+	return TRUE;
+}
+
+static QResultClass *
+libpq_bind_and_exec(StatementClass *stmt)
+{
+	CSTR		func = "libpq_bind_and_exec";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	int			nParams;
+	Oid		   *paramTypes = NULL;
+	char	  **paramValues = NULL;
+	int		   *paramLengths = NULL;
+	int		   *paramFormats = NULL;
+	int			resultFormat;
+	PGresult   *pgres = NULL;
+	QResultClass	*newres = NULL;
+	QResultClass *res = NULL;
+	notice_receiver_arg	nrarg;
+	char		ctrlcmd[128];
+	BOOL		started, sent = FALSE;
+	struct AsyncExec	*async_exec = NULL;
+
+	/*
+	 * For SQL_ASYNC_ENABLE_ON, the execution is only sent and the caller
+	 * returns SQL_STILL_EXECUTING. Otherwise it's executed synchronously.
+	 */
+	if (SC_is_async_call(stmt))
+		async_exec = malloc(sizeof(struct AsyncExec));
+	ctrlcmd[0] = '\0';
+#ifdef	LIBPQ_HAS_PIPELINING
+	/*
+	 * The implicit SAVEPOINT or BEGIN is sent in the same pipeline as the
+	 * execution, unless the statement is prepared and described first or
+	 * is executed asynchronously.
+	 */
+	if (NULL == async_exec &&
+		PREPARING_PERMANENTLY != stmt->prepared &&
+		!may_bind_large_objects(stmt))
+		started = RequestStart(stmt, conn, func, ctrlcmd, sizeof(ctrlcmd));
+	else
+#endif /* LIBPQ_HAS_PIPELINING */
+	started = RequestStart(stmt, conn, func, NULL, 0);
+	if (!started)
+	{
+		if (async_exec)
+			free(async_exec);
+		return NULL;
+	}
+
+#ifdef	NOT_USED
+	if (CC_is_in_trans(conn) && !CC_started_rbpoint(conn))
+	{
+		if (SQL_ERROR == SetStatementSvp(stmt, 0))
+		{
+			SC_set_error_if_not_set(stmt, STMT_INTERNAL_ERROR, "internal savepoint error in build_libpq_bind_params", func);
+			return NULL;
+		}
+	}
+#endif /* NOT_USED */
+
+	/* 1. Bind */
+	MYLOG(0, "bind stmt=%p\n", stmt);
+	if (!build_libpq_bind_params(stmt,
+								 &nParams,
+								 &paramTypes,
+								 &paramValues,
+								 &paramLengths, &paramFormats,
+								 &resultFormat))
+	{
+		if (SC_get_errornumber(stmt) <= 0)
+			SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
+		goto cleanup;
+	}
+
+	/* 2. Execute */
+	MYLOG(0, "execute stmt=%p\n", stmt);
+	if (!SC_is_fetchcursor(stmt))
+	{
+		if (stmt->prepared == NOT_YET_PREPARED ||
+			(stmt->prepared == PREPARED_TEMPORARILY && conn->unnamed_prepared_stmt != stmt))
+		{
+			SC_set_error(stmt, STMT_EXEC_ERROR, "about to execute a non-prepared statement", func);
+			goto cleanup;
+		}
+	}
+
+	/* 2.5 Prepare and Describe if needed */
+	if (stmt->prepared == PREPARING_TEMPORARILY ||
+		(stmt->prepared == PREPARED_TEMPORARILY && conn->unnamed_prepared_stmt != stmt))
+	{
+		ProcessedStmt *pstmt;
 
 		if (!stmt->processed_statements)
 		{
@@ -2657,6 +3309,31 @@ libpq_bind_and_exec(StatementClass *stmt)
 		log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
 		/* set notice receiver */
 		newres = add_libpq_notice_receiver(stmt, &nrarg);
+		if (async_exec)
+			sent = PQsendQueryParams(conn->pqconn,
+									 pstmt->query,
+									 nParams,
+									 paramTypes,
+									 (const char * const *) paramValues,
+									 paramLengths,
+									 paramFormats,
+									 resultFormat);
+		else
+#ifdef	LIBPQ_HAS_PIPELINING
+		if (ctrlcmd[0])
+		{
+			pgres = pipeline_exec_with_control(conn, ctrlcmd, newres,
+											   pstmt->query, NULL,
+											   nParams,
+											   paramTypes,
+											   (const char * const *) paramValues,
+											   paramLengths,
+											   paramFormats,
+											   resultFormat);
+			ctrlcmd[0] = '\0';
+		}
+		else
+#endif /* LIBPQ_HAS_PIPELINING */
 		pgres = PQexecParams(conn->pqconn,
 							 pstmt->query,
 							 nParams,
@@ -2678,12 +3355,35 @@ libpq_bind_and_exec(StatementClass *stmt)
 
 		/* prepareParameters() set plan name, so don't fetch this earlier */
 		plan_name = stmt->plan_name ? stmt->plan_name : NULL_STRING;
+		/* the columns are known now */
+		resultFormat = binary_result_format(stmt);
 
 		/* already prepared */
 		QLOG(0, "PQexecPrepared: %p plan=%s nParams=%d\n", conn->pqconn, plan_name, nParams);
 		log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
 		/* set notice receiver */
 		newres = add_libpq_notice_receiver(stmt, &nrarg);
+		if (async_exec)
+			sent = PQsendQueryPrepared(conn->pqconn,
+									   plan_name,
+									   nParams,
+									   (const char * const *) paramValues,
+									   paramLengths, paramFormats,
+									   resultFormat);
+		else
+#ifdef	LIBPQ_HAS_PIPELINING
+		if (ctrlcmd[0])
+		{
+			pgres = pipeline_exec_with_control(conn, ctrlcmd, newres,
+											   NULL, plan_name,
+											   nParams, NULL,
+											   (const char * const *) paramValues,
+											   paramLengths, paramFormats,
+											   resultFormat);
+			ctrlcmd[0] = '\0';
+		}
+		else
+#endif /* LIBPQ_HAS_PIPELINING */
 		pgres = PQexecPrepared(conn->pqconn,
 							   plan_name, 	/* portal name == plan name */
 							   nParams,
@@ -2692,6 +3392,17 @@ libpq_bind_and_exec(StatementClass *stmt)
 	}
 	/* reset notice receiver */
 	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+	if (sent)
+	{
+		/* libpq_async_result() reads the result */
+		MYLOG(0, "executing stmt=%p asynchronously\n", stmt);
+		async_exec->nrarg = nrarg;
+		async_exec->pgres = NULL;
+		async_exec->drained = FALSE;
+		stmt->async_exec = async_exec;
+		conn->async_stmt = stmt;
+		return NULL;
+	}
 	if (!(res = nrarg.res))
 	{
 		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
@@ -2700,93 +3411,630 @@ libpq_bind_and_exec(StatementClass *stmt)
 
 	/* 3. Receive results */
 MYLOG(DETAIL_LOG_LEVEL, "get_Result=%p %p\n", res, SC_get_Result(stmt));
-	pgresstatus = PQresultStatus(pgres);
-	switch (pgresstatus)
+	if (!receive_exec_result(stmt, res, &pgres))
+		goto cleanup;
+
+	if (res != newres && NULL != newres)
+		QR_Destructor(newres);
+
+cleanup:
+	/* not executed, the transaction must still be in the expected state */
+	if (ctrlcmd[0])
+		issue_control_command(conn, ctrlcmd);
+	if (pgres)
+		PQclear(pgres);
+	if (async_exec)
+		free(async_exec);
+	/* the parameter arrays belong to the statement */
+
+	return res;
+}
+
+/*
+ * Poll the execution libpq_bind_and_exec() left running asynchronously,
+ * without blocking. Sets *busy while the result hasn't arrived yet,
+ * otherwise returns the result as libpq_bind_and_exec() does.
+ */
+static QResultClass *
+libpq_async_result(StatementClass *stmt, BOOL *busy)
+{
+	CSTR		func = "libpq_async_result";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	struct AsyncExec	*async = stmt->async_exec;
+	PGconn	   *pqconn = conn->pqconn;
+	PGresult   *pgres;
+	QResultClass	*res;
+	BOOL		done = FALSE;
+
+	*busy = FALSE;
+	if (NULL != pqconn && !async->drained)
 	{
-		case PGRES_COMMAND_OK:
-			/* portal query command, no tuples returned */
-			/* read in the return message from the backend */
-			cmdtag = PQcmdStatus(pgres);
-			QLOG(0, "\tok: - 'C' - %s\n", cmdtag);
-			QR_set_command(res, cmdtag);
-			if (QR_command_successful(res))
-				QR_set_rstatus(res, PORES_COMMAND_OK);
+		PQsetNoticeReceiver(pqconn, receive_libpq_notice, &async->nrarg);
+		if (!PQconsumeInput(pqconn))
+			done = TRUE;	/* handle_pgres_error() reports it */
+		else while (!PQisBusy(pqconn))
+		{
+			/* the result of the execution followed by NULL */
+			if (NULL == (pgres = PQgetResult(pqconn)))
+			{
+				done = TRUE;
+				break;
+			}
+			if (NULL == async->pgres)
+				async->pgres = pgres;
+			else
+				PQclear(pgres);
+		}
+		PQsetNoticeReceiver(pqconn, receive_libpq_notice, NULL);
+		if (!done)
+		{
+			*busy = TRUE;
+			return NULL;
+		}
+	}
+	pgres = async->pgres;
+	async->pgres = NULL;
+	if (!(res = async->nrarg.res))
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
+	else
+		receive_exec_result(stmt, res, &pgres);
+	if (pgres)
+		PQclear(pgres);
 
-			/* get rowcount */
-			rowcount = PQcmdTuples(pgres);
-			if (rowcount && rowcount[0])
-				res->recent_processed_row_count = atoi(rowcount);
+	return res;
+}
+
+/*
+ * Wait for the result of the asynchronous execution of the statement, so
+ * that the connection can be used for other queries. The result is kept
+ * for the next SQLExecute() call of the statement to return.
+ */
+void
+SC_wait_async_exec(StatementClass *self)
+{
+	ConnectionClass	*conn = SC_get_conn(self);
+	struct AsyncExec	*async = self->async_exec;
+	PGresult   *pgres;
+	int		func_cs_count = 0;
+
+	if (NULL == async || async->drained)
+		return;
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	MYLOG(0, "waiting for the asynchronous execution of stmt=%p\n", self);
+	if (NULL != conn->pqconn)
+	{
+		PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, &async->nrarg);
+		while ((pgres = PQgetResult(conn->pqconn)) != NULL)
+		{
+			if (NULL == async->pgres)
+				async->pgres = pgres;
 			else
-				res->recent_processed_row_count = -1;
-			break;
+				PQclear(pgres);
+		}
+		PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+	}
+	async->drained = TRUE;
+	if (conn->async_stmt == self)
+		conn->async_stmt = NULL;
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+}
 
-		case PGRES_EMPTY_QUERY:
-			/* We return the empty query */
-			QR_set_rstatus(res, PORES_EMPTY_QUERY);
-			break;
-		case PGRES_NONFATAL_ERROR:
-			handle_pgres_error(conn, pgres, "libpq_bind_and_exec", res, FALSE);
-			break;
+/*
+ * Finish the asynchronous execution of the statement as SQLExecute()
+ * would, so that the statement can be closed, recycled or freed.
+ */
+RETCODE
+SC_complete_async_exec(StatementClass *self)
+{
+	RETCODE		ret;
 
-		case PGRES_BAD_RESPONSE:
-		case PGRES_FATAL_ERROR:
-			handle_pgres_error(conn, pgres, "libpq_bind_and_exec", res, TRUE);
-			break;
-		case PGRES_TUPLES_OK:
-			if (!QR_from_PGresult(res, stmt, conn, NULL, &pgres))
+	if (!SC_async_executing(self))
+		return SQL_SUCCESS;
+	SC_wait_async_exec(self);
+	ret = PGAPI_Execute(self, 0);
+	return DiscardStatementSvp(self, ret, FALSE);
+}
+
+#ifdef	LIBPQ_HAS_PIPELINING
+/*
+ * Is the row of the parameter arrays to be skipped ?
+ */
+static BOOL
+param_row_is_ignored(const APDFields *apdopts, SQLLEN row)
+{
+	return (NULL != apdopts->param_operation_ptr &&
+			SQL_PARAM_IGNORE == apdopts->param_operation_ptr[row]);
+}
+
+/*
+ * Execute the remaining rows of the parameter arrays, from
+ * exec_current_row to the last one, in libpq pipeline mode.
+ *
+ * The statement is prepared once and the rows are queued with
+ * PQsendQueryPrepared(), synchronizing every batch_size rows. The result
+ * carries the sum of the row counts. On error, exec_current_row is the
+ * row which failed and the rest of the rows aren't executed.
+ */
+static QResultClass *
+libpq_pipeline_exec(StatementClass *stmt)
+{
+	CSTR		func = "libpq_pipeline_exec";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	PGconn		*pqconn;
+	APDFields	*apdopts = SC_get_APDF(stmt);
+	IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	SQLUSMALLINT	*param_status;
+	SQLLEN		start_row, end_row, batch_start, batch_end, row;
+	SQLLEN		error_row = -1;
+	SQLLEN		total_count = 0;
+	int			nqueued, nParams, resultFormat;
+	Oid		   *paramTypes;
+	char	  **paramValues;
+	int		   *paramLengths;
+	int		   *paramFormats;
+	const char *plan_name;
+	char		cmdtag[64];
+	BOOL		implicit_trans, broken = FALSE, server_error = FALSE;
+	PGresult   *pgres;
+	QResultClass	*newres = NULL;
+	QResultClass	*res = NULL, *pres;
+	notice_receiver_arg	nrarg;
+
+	if (!RequestStart(stmt, conn, func, NULL, 0))
+		return NULL;
+	pqconn = conn->pqconn;
+	/* the rows of a batch are in one implicit transaction in autocommit mode */
+	implicit_trans = !CC_is_in_trans(conn);
+
+	if (stmt->prepared == PREPARING_PERMANENTLY ||
+		stmt->prepared == PREPARING_TEMPORARILY ||
+		(stmt->prepared == PREPARED_TEMPORARILY && conn->unnamed_prepared_stmt != stmt))
+	{
+		if (prepareParameters(stmt, FALSE) == SQL_ERROR)
+			return NULL;
+	}
+	/* a statement returning rows is executed row by row */
+	if (pres = SC_get_ExecdOrParsed(stmt), NULL == pres ||
+		NULL == QR_get_fields(pres) ||
+		CI_get_num_fields(QR_get_fields(pres)) > 0)
+	{
+		MYLOG(0, "the statement may return rows, no pipeline\n");
+		stmt->exec_type = DIRECT_EXEC;
+		return libpq_bind_and_exec(stmt);
+	}
+	plan_name = stmt->plan_name ? stmt->plan_name : NULL_STRING;
+
+	start_row = stmt->exec_current_row;
+	if (end_row = stmt->exec_end_row, end_row < 0)
+		end_row = (SQLLEN) apdopts->paramset_size - 1;
+	param_status = ipdopts->param_status_ptr;
+	cmdtag[0] = '\0';
+
+	if (!PQenterPipelineMode(pqconn))
+	{
+		SC_set_error(stmt, STMT_EXEC_ERROR, PQerrorMessage(pqconn), func);
+		return NULL;
+	}
+	/* set notice receiver */
+	newres = add_libpq_notice_receiver(stmt, &nrarg);
+	if (!(res = nrarg.res))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
+		goto cleanup;
+	}
+
+	for (batch_start = start_row; batch_start <= end_row && error_row < 0; batch_start = batch_end + 1)
+	{
+		/* 1. Queue a batch of rows */
+		nqueued = 0;
+		for (row = batch_start; row <= end_row && nqueued < stmt->batch_size; row++)
+		{
+			if (param_row_is_ignored(apdopts, row))
+				continue;
+			stmt->exec_current_row = row;
+			if (!build_libpq_bind_params(stmt,
+										 &nParams,
+										 &paramTypes,
+										 &paramValues,
+										 &paramLengths, &paramFormats,
+										 &resultFormat))
+			{
+				if (SC_get_errornumber(stmt) <= 0)
+					SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
+				if (param_status)
+					param_status[row] = SQL_PARAM_ERROR;
+				error_row = row;
+				break;
+			}
+			QLOG(0, "PQsendQueryPrepared: %p plan=%s nParams=%d row=" FORMAT_LEN "\n", pqconn, plan_name, nParams, row);
+			log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
+			if (!PQsendQueryPrepared(pqconn, plan_name, nParams,
+									 (const char **) paramValues, paramLengths, paramFormats,
+									 resultFormat))
+			{
+				SC_set_error(stmt, STMT_EXEC_ERROR, PQerrorMessage(pqconn), func);
+				if (param_status)
+					param_status[row] = SQL_PARAM_ERROR;
+				error_row = row;
+				break;
+			}
+			nqueued++;
+		}
+		batch_end = row - 1;
+		if (!PQpipelineSync(pqconn))
+		{
+			SC_set_error(stmt, STMT_COMMUNICATION_ERROR, PQerrorMessage(pqconn), func);
+			broken = TRUE;
+			goto cleanup;
+		}
+		MYLOG(0, "queued %d rows " FORMAT_LEN "-" FORMAT_LEN "\n", nqueued, batch_start, batch_end);
+
+		/* 2. Read the results of the batch */
+		for (row = batch_start; nqueued > 0; row++)
+		{
+			ExecStatusType	pgresstatus;
+			char	   *rowcount;
+
+			if (param_row_is_ignored(apdopts, row))
+				continue;
+			nqueued--;
+			if (NULL == (pgres = PQgetResult(pqconn)))
+			{
+				SC_set_error(stmt, STMT_COMMUNICATION_ERROR, PQerrorMessage(pqconn), func);
+				broken = TRUE;
 				goto cleanup;
-			if (res->rstatus == PORES_TUPLES_OK && res->notice)
-				QR_set_rstatus(res, PORES_NONFATAL_ERROR);
-			break;
-		case PGRES_COPY_OUT:
-		case PGRES_COPY_IN:
-		case PGRES_COPY_BOTH:
-		default:
-			/* skip the unexpected response if possible */
-			QR_set_rstatus(res, PORES_BAD_RESPONSE);
-			CC_set_error(conn, CONNECTION_BACKEND_CRAZY, "Unexpected protocol character from backend (send_query)", func);
-			CC_on_abort(conn, CONN_DEAD);
+			}
+			pgresstatus = PQresultStatus(pgres);
+			switch (pgresstatus)
+			{
+				case PGRES_COMMAND_OK:
+				case PGRES_TUPLES_OK:
+					STRCPY_FIXED(cmdtag, PQcmdStatus(pgres));
+					rowcount = PQcmdTuples(pgres);
+					if (rowcount && rowcount[0])
+						total_count += atoi(rowcount);
+					if (param_status)
+						param_status[row] = SQL_PARAM_SUCCESS;
+					break;
+				case PGRES_PIPELINE_ABORTED:
+					/* not executed because of the error of a previous row */
+					if (param_status)
+						param_status[row] = SQL_PARAM_UNUSED;
+					break;
+				default:
+					handle_pgres_error(conn, pgres, func, res, TRUE);
+					if (param_status)
+						param_status[row] = SQL_PARAM_ERROR;
+					/* precedes the row the client failed to queue */
+					if (error_row < 0 || !server_error)
+						error_row = row;
+					server_error = TRUE;
+					break;
+			}
+			if (row > start_row &&
+				PGRES_PIPELINE_ABORTED != pgresstatus &&
+				ipdopts->param_processed_ptr)
+				(*ipdopts->param_processed_ptr)++;
+			PQclear(pgres);
+			/* the end of the results of the row */
+			while (NULL != (pgres = PQgetResult(pqconn)))
+				PQclear(pgres);
+		}
+		pgres = PQgetResult(pqconn);
+		if (NULL == pgres || PGRES_PIPELINE_SYNC != PQresultStatus(pgres))
+		{
+			if (pgres)
+				PQclear(pgres);
+			SC_set_error(stmt, STMT_COMMUNICATION_ERROR, "Unexpected result in pipeline mode", func);
+			broken = TRUE;
+			goto cleanup;
+		}
+		PQclear(pgres);
 
-			QLOG(0, "PQexecXxxx error: - (%d) - %s\n", pgresstatus, CC_get_errormsg(conn));
-			break;
+		/*
+		 * The rows of the batch before an error of the server were rolled
+		 * back. The rows queued before an error of the client were
+		 * committed by the sync.
+		 */
+		if (server_error && implicit_trans && param_status)
+		{
+			for (row = batch_start; row < error_row; row++)
+			{
+				if (SQL_PARAM_SUCCESS == param_status[row])
+					param_status[row] = SQL_PARAM_ERROR;
+			}
+		}
+	}
+
+	if (error_row < 0)
+	{
+		stmt->exec_current_row = end_row;
+		QLOG(0, "\tok: - 'C' - %s rows=" FORMAT_LEN "\n", cmdtag, total_count);
+		QR_set_command(res, cmdtag);
+		if (QR_command_successful(res))
+			QR_set_rstatus(res, PORES_COMMAND_OK);
+		res->recent_processed_row_count = total_count;
+	}
+	else
+	{
+		stmt->exec_current_row = error_row;
+		if (QR_command_maybe_successful(res))
+			QR_set_rstatus(res, PORES_FATAL_ERROR);
 	}
 
+cleanup:
+	/* reset notice receiver */
+	PQsetNoticeReceiver(pqconn, receive_libpq_notice, NULL);
+	if (!PQexitPipelineMode(pqconn))
+		broken = TRUE;
 	if (res != newres && NULL != newres)
 		QR_Destructor(newres);
+	if (broken)
+	{
+		/* the state of the connection is unknown */
+		if (res)
+			QR_Destructor(res);
+		CC_on_abort(conn, CONN_DEAD);
+		return NULL;
+	}
 
-cleanup:
-	if (pgres)
+	return res;
+}
+
+#define	COPY_SVP	"_COPY_SVP"
+#define	COPY_FLUSH_SIZE	(64 * 1024)
+
+/*
+ * Run a command of libpq_copy_exec() which returns no rows.
+ */
+static BOOL
+copy_exec_command(PGconn *pqconn, const char *cmd)
+{
+	PGresult   *pgres;
+	BOOL		ret;
+
+	QLOG(0, "PQexec: %p '%s'\n", pqconn, cmd);
+	pgres = PQexec(pqconn, cmd);
+	if (ret = (PGRES_COMMAND_OK == PQresultStatus(pgres)), ret)
+		QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+	else
+		QLOG(0, "\terror: %s", PQerrorMessage(pqconn));
+	PQclear(pgres);
+
+	return ret;
+}
+
+/*
+ * Execute the remaining rows of the parameter arrays of a plain INSERT
+ * statement by one COPY FROM STDIN.
+ *
+ * COPY inserts all the rows or none of them. If it fails, the rows are
+ * executed one by one by libpq_pipeline_exec(), so that the status of
+ * each row is reported. In a transaction the COPY is enclosed in a
+ * savepoint not to abort the transaction.
+ */
+static QResultClass *
+libpq_copy_exec(StatementClass *stmt)
+{
+	CSTR		func = "libpq_copy_exec";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	PGconn		*pqconn;
+	APDFields	*apdopts = SC_get_APDF(stmt);
+	IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	SQLLEN		start_row, end_row, row, nrows = 0;
+	char	   *copycmd;
+	const char *errmsg = NULL;
+	char		cmdtag[64];
+	BOOL		use_svp, copied = FALSE;
+	PGresult   *pgres;
+	PQExpBufferData	buf = {0};
+	QResultClass	*res;
+
+	if (NULL == (copycmd = insert_to_copy_statement(stmt, stmt->num_params, NULL, NULL)))
+	{
+		stmt->exec_type = PIPELINE_EXEC;
+		return libpq_pipeline_exec(stmt);
+	}
+	if (!RequestStart(stmt, conn, func, NULL, 0))
+	{
+		free(copycmd);
+		return NULL;
+	}
+	pqconn = conn->pqconn;
+	start_row = stmt->exec_current_row;
+	if (end_row = stmt->exec_end_row, end_row < 0)
+		end_row = (SQLLEN) apdopts->paramset_size - 1;
+	cmdtag[0] = '\0';
+
+	if (use_svp = CC_is_in_trans(conn), use_svp)
+	{
+		if (!copy_exec_command(pqconn, "SAVEPOINT " COPY_SVP))
+			goto cleanup;
+	}
+	QLOG(0, "PQexec: %p '%s'\n", pqconn, copycmd);
+	pgres = PQexec(pqconn, copycmd);
+	if (PGRES_COPY_IN != PQresultStatus(pgres))
+	{
+		QLOG(0, "\terror: %s", PQerrorMessage(pqconn));
 		PQclear(pgres);
-	if (paramValues)
+		goto cleanup;
+	}
+	PQclear(pgres);
+
+	initPQExpBuffer(&buf);
+	for (row = start_row; row <= end_row; row++)
 	{
-		int			i;
-		for (i = 0; i < nParams; i++)
+		if (param_row_is_ignored(apdopts, row))
+			continue;
+		stmt->exec_current_row = row;
+		if (!build_copy_row(stmt, &buf))
 		{
-			if (paramValues[i] != NULL)
-				free(paramValues[i]);
+			errmsg = "could not build the row";
+			break;
+		}
+		nrows++;
+		if (buf.len >= COPY_FLUSH_SIZE)
+		{
+			if (PQputCopyData(pqconn, buf.data, (int) buf.len) <= 0)
+			{
+				errmsg = "could not send the data";
+				break;
+			}
+			resetPQExpBuffer(&buf);
 		}
-		free(paramValues);
 	}
-	if (paramTypes)
-		free(paramTypes);
-	if (paramLengths)
-		free(paramLengths);
-	if (paramFormats)
-		free(paramFormats);
+	if (buf.len > 0 && NULL == errmsg &&
+		PQputCopyData(pqconn, buf.data, (int) buf.len) <= 0)
+		errmsg = "could not send the data";
+	if (PQputCopyEnd(pqconn, errmsg) <= 0)
+	{
+		SC_set_error(stmt, STMT_COMMUNICATION_ERROR, PQerrorMessage(pqconn), func);
+		goto cleanup;
+	}
+	MYLOG(0, "sent " FORMAT_LEN " rows errmsg=%s\n", nrows, errmsg ? errmsg : "(null)");
+	while (NULL != (pgres = PQgetResult(pqconn)))
+	{
+		if (PGRES_COMMAND_OK == PQresultStatus(pgres))
+		{
+			STRCPY_FIXED(cmdtag, PQcmdStatus(pgres));
+			copied = (NULL == errmsg);
+			QLOG(0, "\tok: - 'C' - %s\n", cmdtag);
+		}
+		else
+			QLOG(0, "\terror: %s", PQerrorMessage(pqconn));
+		PQclear(pgres);
+	}
+	if (copied && use_svp)
+		copied = copy_exec_command(pqconn, "RELEASE " COPY_SVP);
+
+cleanup:
+	termPQExpBuffer(&buf);
+	free(copycmd);
+	if (CONNECTION_BAD == PQstatus(pqconn))
+	{
+		if (SC_get_errornumber(stmt) <= 0)
+			SC_set_error(stmt, STMT_COMMUNICATION_ERROR, "the connection was lost during COPY", func);
+		CC_on_abort(conn, CONN_DEAD);
+		return NULL;
+	}
+	if (!copied)
+	{
+		/* undo the COPY and execute the rows one by one */
+		if (use_svp &&
+			!copy_exec_command(pqconn, "ROLLBACK TO " COPY_SVP "; RELEASE " COPY_SVP))
+		{
+			SC_set_error(stmt, STMT_INTERNAL_ERROR, "internal savepoint error", func);
+			return NULL;
+		}
+		MYLOG(0, "COPY failed, falling back to the pipeline\n");
+		SC_clear_error(stmt);
+		stmt->exec_current_row = start_row;
+		stmt->exec_type = PIPELINE_EXEC;
+		return libpq_pipeline_exec(stmt);
+	}
+
+	for (row = start_row; row <= end_row; row++)
+	{
+		if (param_row_is_ignored(apdopts, row))
+			continue;
+		if (ipdopts->param_status_ptr)
+			ipdopts->param_status_ptr[row] = SQL_PARAM_SUCCESS;
+	}
+	if (nrows > 1 && ipdopts->param_processed_ptr)
+		*ipdopts->param_processed_ptr += nrows - 1;
+	stmt->exec_current_row = end_row;
+
+	if (!(res = QR_Constructor()))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
+		return NULL;
+	}
+	/* report the row count as INSERT does */
+	SPRINTF_FIXED(cmdtag, "INSERT 0 " FORMAT_LEN, nrows);
+	QR_set_command(res, cmdtag);
+	QR_set_rstatus(res, PORES_COMMAND_OK);
+	res->recent_processed_row_count = nrows;
 
 	return res;
 }
 
+/*
+ * Send Parse and Describe followed by a single Sync, after the command
+ * RequestStart() left to the caller if 'ctrlcmd' isn't empty. *prepres is
+ * set to the result of the Parse and *descres to the result of the
+ * Describe, which are PGRES_PIPELINE_ABORTED if a previous one failed; the
+ * error of the command is set to 'res'. Returns FALSE if the connection is
+ * broken.
+ */
+static BOOL
+pipeline_prepare_and_describe(ConnectionClass *conn, const char *ctrlcmd,
+							  QResultClass *res, const char *plan_name,
+							  const char *query, int nParams,
+							  const Oid *paramTypes,
+							  PGresult **prepres, PGresult **descres)
+{
+	PGconn	   *pqconn = conn->pqconn;
+	PGresult   *pgres;
+	BOOL		ret = FALSE;
+
+	*prepres = *descres = NULL;
+	if (!PQenterPipelineMode(pqconn))
+		return FALSE;
+	if (ctrlcmd[0])
+	{
+		QLOG(0, "PQsendQueryParams: %p '%s'\n", pqconn, ctrlcmd);
+		if (!PQsendQueryParams(pqconn, ctrlcmd, 0, NULL, NULL, NULL, NULL, 0))
+			goto cleanup;
+	}
+	if (!PQsendPrepare(pqconn, plan_name, query, nParams, paramTypes) ||
+		!PQsendDescribePrepared(pqconn, plan_name) ||
+		!PQpipelineSync(pqconn))
+		goto cleanup;
+	if (ctrlcmd[0] && !read_control_result(conn, res))
+		goto cleanup;
+	/* the results of Parse and Describe, each followed by NULL */
+	if (NULL == (*prepres = PQgetResult(pqconn)))
+		goto cleanup;
+	while (NULL != (pgres = PQgetResult(pqconn)))
+		PQclear(pgres);
+	if (NULL == (*descres = PQgetResult(pqconn)))
+		goto cleanup;
+	while (NULL != (pgres = PQgetResult(pqconn)))
+		PQclear(pgres);
+	/* and the Sync */
+	if (NULL == (pgres = PQgetResult(pqconn)))
+		goto cleanup;
+	ret = (PGRES_PIPELINE_SYNC == PQresultStatus(pgres));
+	PQclear(pgres);
+cleanup:
+	if (!PQexitPipelineMode(pqconn))
+		ret = FALSE;
+
+	return ret;
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
 /*
  * Parse a query using libpq.
  *
  * 'res' is only passed here for error reporting purposes. If an error is
  * encountered, it is set in 'res', and the function returns FALSE.
+ *
+ * A named plan is looked up in the plan cache of the connection first.
+ * *cached is set to the cache entry of the plan the statement uses, if
+ * any; the plan was prepared before if the entry has a description.
+ *
+ * If 'desc' is not NULL, the prepared statement is described too, in the
+ * same round trip when libpq supports pipelining, and *desc is set to the
+ * result of the Describe. It's left NULL if the plan was found in the
+ * cache. The command RequestStart() left in 'ctrlcmd', if any, is sent in
+ * the same pipeline, and ctrlcmd is emptied once sent.
  */
 static BOOL
 ParseWithLibpq(StatementClass *stmt, const char *plan_name,
 			   const char *query,
-			   Int2 num_params, const char *comment, QResultClass *res)
+			   Int2 num_params, const char *comment, QResultClass *res,
+			   PlanCacheEntry **cached, PGresult **desc, char *ctrlcmd)
 {
 	CSTR	func = "ParseWithLibpq";
 	ConnectionClass	*conn = SC_get_conn(stmt);
@@ -2797,9 +4045,6 @@ ParseWithLibpq(StatementClass *stmt, const char *plan_name,
 	PGresult   *pgres = NULL;
 
 	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query);
-	if (!RequestStart(stmt, conn, func))
-		return FALSE;
-
 	if (stmt->discard_output_params)
 		num_params = 0;
 	else if (num_params != 0)
@@ -2874,15 +4119,84 @@ MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
 		}
 	}
 
+	*cached = NULL;
+	if (desc)
+		*desc = NULL;
+	if (plan_name && plan_name[0])
+	{
+		PlanCacheEntry	*entry;
+
+		if (entry = CC_lookup_plan(conn, query, num_params, paramTypes), NULL != entry)
+		{
+			QLOG(0, "\tusing the cached plan %s\n", entry->plan_name);
+			SC_set_planname(stmt, entry->plan_name);
+			SC_set_prepared(stmt, PREPARED_PERMANENTLY);
+			*cached = entry;
+			retval = TRUE;
+			goto cleanup;
+		}
+		if (entry = CC_add_plan(conn, query, num_params, paramTypes), NULL != entry)
+		{
+			SC_set_planname(stmt, entry->plan_name);
+			plan_name = stmt->plan_name;
+			*cached = entry;
+		}
+	}
 	if (plan_name == NULL || plan_name[0] == '\0')
 		conn->unnamed_prepared_stmt = NULL;
 
 	/* Prepare */
-	QLOG(0, "PQprepare: %p '%s' plan=%s nParams=%d\n", conn->pqconn, query, plan_name, num_params);
-	pgres = PQprepare(conn->pqconn, plan_name, query, num_params, paramTypes);
+#ifdef	LIBPQ_HAS_PIPELINING
+	if (desc)
+	{
+		QLOG(0, "PQsendPrepare+PQsendDescribePrepared: %p '%s' plan=%s nParams=%d\n", conn->pqconn, query, plan_name, num_params);
+		BOOL	piped;
+
+		piped = pipeline_prepare_and_describe(conn, ctrlcmd, res,
+											  plan_name, query,
+											  num_params, paramTypes,
+											  &pgres, desc);
+		ctrlcmd[0] = '\0';
+		if (!piped)
+		{
+			if (*desc)
+			{
+				PQclear(*desc);
+				*desc = NULL;
+			}
+			if (*cached)
+			{
+				CC_remove_plan(conn, *cached);
+				*cached = NULL;
+			}
+			CC_set_error(conn, CONNECTION_COMMUNICATION_ERROR, "Unexpected result in pipeline mode", func);
+			CC_on_abort(conn, CONN_DEAD);
+			goto cleanup;
+		}
+	}
+	else
+#endif /* LIBPQ_HAS_PIPELINING */
+	{
+		QLOG(0, "PQprepare: %p '%s' plan=%s nParams=%d\n", conn->pqconn, query, plan_name, num_params);
+		pgres = PQprepare(conn->pqconn, plan_name, query, num_params, paramTypes);
+	}
 	if (PQresultStatus(pgres) != PGRES_COMMAND_OK)
 	{
+#ifdef	LIBPQ_HAS_PIPELINING
+		/* else the implicit SAVEPOINT or BEGIN failed and set the error */
+		if (PGRES_PIPELINE_ABORTED != PQresultStatus(pgres))
+#endif /* LIBPQ_HAS_PIPELINING */
 		handle_pgres_error(conn, pgres, "ParseWithlibpq", res, TRUE);
+		if (desc && *desc)
+		{
+			PQclear(*desc);
+			*desc = NULL;
+		}
+		if (*cached)
+		{
+			CC_remove_plan(conn, *cached);
+			*cached = NULL;
+		}
 		goto cleanup;
 	}
 	cstatus = PQcmdStatus(pgres);
@@ -2934,9 +4248,19 @@ ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
 	int			i;
 	Oid			oid;
 	SQLSMALLINT paramType;
+	PlanCacheEntry	*cached = NULL;
+	BOOL		desc_cached = FALSE;
+	char		ctrlcmd[128];
+	BOOL		started;
 
 	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query_param);
-	if (!RequestStart(stmt, conn, func))
+	ctrlcmd[0] = '\0';
+#ifdef	LIBPQ_HAS_PIPELINING
+	started = RequestStart(stmt, conn, func, ctrlcmd, sizeof(ctrlcmd));
+#else
+	started = RequestStart(stmt, conn, func, NULL, 0);
+#endif /* LIBPQ_HAS_PIPELINING */
+	if (!started)
 		return NULL;
 
 	if (!res)
@@ -2944,21 +4268,42 @@ ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
 	if (!res)
 	{
 		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for query", func);
+		if (ctrlcmd[0])
+			issue_control_command(conn, ctrlcmd);
 		return NULL;
 	}
 
 	/*
-	 * We need to do Prepare + Describe as two different round-trips to the
-	 * server, while before we switched to use libpq, we used to send a Parse
-	 * and Describe message followed by a single Sync.
+	 * The implicit SAVEPOINT or BEGIN, Parse and Describe are sent with a
+	 * single Sync when libpq supports pipelining, otherwise they are
+	 * different round trips.
 	 */
-	if (!ParseWithLibpq(stmt, plan_name, query_param, num_params, comment, res))
+	if (!ParseWithLibpq(stmt, plan_name, query_param, num_params, comment, res, &cached, &pgres, ctrlcmd))
 		goto cleanup;
 
 	/* Describe */
-	QLOG(0, "\tPQdescribePrepared: %p plan_name=%s\n", conn->pqconn, plan_name);
-
-	pgres = PQdescribePrepared(conn->pqconn, plan_name);
+	if (cached && cached->desc)
+	{
+		QLOG(0, "\tusing the description of %s\n", cached->plan_name);
+		pgres = cached->desc;
+		desc_cached = TRUE;
+	}
+	else
+	{
+		if (NULL == pgres)
+		{
+			if (cached)
+				plan_name = cached->plan_name;
+			QLOG(0, "\tPQdescribePrepared: %p plan_name=%s\n", conn->pqconn, plan_name);
+			pgres = PQdescribePrepared(conn->pqconn, plan_name);
+		}
+		/* keep the description with the plan */
+		if (cached && PGRES_COMMAND_OK == PQresultStatus(pgres))
+		{
+			cached->desc = pgres;
+			desc_cached = TRUE;
+		}
+	}
 	switch (PQresultStatus(pgres))
 	{
 		case PGRES_COMMAND_OK:
@@ -3071,7 +4416,10 @@ MYLOG(DETAIL_LOG_LEVEL, "num_params=%d info=%d\n", stmt->num_params, num_p);
 	}
 
 cleanup:
-	if (pgres)
+	/* not sent, e.g. the plan and its description were in the cache */
+	if (ctrlcmd[0])
+		issue_control_command(conn, ctrlcmd);
+	if (pgres && !desc_cached)
 		PQclear(pgres);
 
 	return res;
@@ -172,7 +172,9 @@ enum
 typedef enum {
 	DIRECT_EXEC,
 	DEFFERED_EXEC,
-	LAST_EXEC
+	LAST_EXEC,
+	PIPELINE_EXEC,	/* all the rows in libpq pipeline mode */
+	COPY_EXEC	/* all the rows by COPY FROM STDIN */
 } EXEC_TYPE;
 
 #define	PG_NUM_NORMAL_KEYS	2
@@ -279,6 +281,8 @@ struct StatementClass_
 	po_ind_t	join_info;	/* have joins ? */
 	po_ind_t	parse_method;	/* parse_statement is forced or ? */
 	po_ind_t	has_notice; /* exec result contains notice messages ? */
+	po_ind_t	fetch_by_column; /* SC_fetch() leaves the bound columns to SC_fetch_by_column() */
+	po_ind_t	fetch_by_plan;	/* convert the bound columns following fetch_plan */
 	pgNAME		cursor_name;
 	char		*plan_name;
 
@@ -305,9 +309,20 @@ struct StatementClass_
 	EXEC_TYPE	exec_type;
 	int		count_of_deffered;
 	PQExpBufferData	stmt_deffered;
+	/* the parameter arrays passed to libpq, reused by the executions */
+	int		bind_allocated;
+	OID		*bind_types;
+	char		**bind_values;
+	int		*bind_lengths;
+	int		*bind_formats;
+	ssize_t		*bind_value_pos;	/* position in bind_buf or -1 */
+	PQExpBufferData	bind_buf;	/* the values built by the driver */
 	/* SQL_NEED_DATA Callback list */
 	StatementClass	*execute_delegate;
 	StatementClass	*execute_parent;
+	/* the execution left running for SQL_ASYNC_ENABLE_ON */
+	struct AsyncExec	*async_exec;
+	struct FetchPlan	*fetch_plan;	/* see prepare_fetch_plan() */
 	UInt2		allocated_callbacks;
 	UInt2		num_callbacks;
 	NeedDataCallback	*callbacks;
@@ -449,6 +464,10 @@ enum
 #define SC_set_readonly(a)	((a)->execinfo |= (1L << 1))
 #define SC_set_no_readonly(a)	((a)->execinfo &= ~(1L << 1))
 #define SC_is_readonly(a)	(((a)->execinfo & (1L << 1)) != 0)
+#define SC_set_async_call(a)	((a)->execinfo |= (1L << 2))
+#define SC_no_async_call(a)	((a)->execinfo &= ~(1L << 2))
+#define SC_is_async_call(a)	(((a)->execinfo & (1L << 2)) != 0)
+#define SC_async_executing(a)	(NULL != (a)->async_exec)
 #define SC_execinfo_clear(a)	(((a)->execinfo = 0)
 #define	STMT_HAS_NO_JOIN	0L
 #define	STMT_HAS_OUTER_JOIN	1L
@@ -505,6 +524,7 @@ RETCODE		SC_initialize_and_recycle(StatementClass *self);
 void		SC_initialize_cols_info(StatementClass *self, BOOL DCdestroy, BOOL parseReset);
 void		SC_reset_result_for_rerun(StatementClass *self);
 int		statement_type(const char *statement);
+void		SC_set_statement_type(StatementClass *self);
 char		parse_statement(StatementClass *stmt, BOOL);
 char		parse_sqlsvr(StatementClass *stmt);
 SQLRETURN	SC_set_SS_columnkey(StatementClass *stmt);
@@ -524,9 +544,15 @@ void		SC_set_rowset_start(StatementClass *self, SQLLEN, BOOL);
 void		SC_inc_rowset_start(StatementClass *self, SQLLEN);
 RETCODE		SC_initialize_stmts(StatementClass *self, BOOL);
 RETCODE		SC_execute(StatementClass *self);
+void		SC_wait_async_exec(StatementClass *self);
+RETCODE		SC_complete_async_exec(StatementClass *self);
 RETCODE		SC_fetch(StatementClass *self);
+RETCODE		SC_fetch_by_column(StatementClass *self, SQLLEN num_rows, SQLUSMALLINT *row_status);
+BOOL		SC_reserve_bind_params(StatementClass *self, int num_params);
+void		SC_free_bind_params(StatementClass *self);
 void		SC_free_params(StatementClass *self, char option);
 void		SC_log_error(const char *func, const char *desc, const StatementClass *self);
+SQLULEN		SC_get_result_memory(StatementClass *self, const QResultClass *exclude);
 time_t		SC_get_time(StatementClass *self);
 struct tm	*SC_get_localtime(StatementClass *self);
 SQLLEN		SC_get_int4_bookmark(StatementClass *self);
@@ -536,6 +562,7 @@ RETCODE		SC_pos_delete(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index,
 RETCODE		SC_pos_refresh(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index);
 RETCODE		SC_pos_fetch(StatementClass *self, const PG_BM *pg_bm);
 RETCODE		SC_pos_add(StatementClass *self, SQLSETPOSIROW irow);
+RETCODE		SC_pos_add_rowset(StatementClass *self, SQLSETPOSIROW nrows, SQLSETPOSIROW *processed);
 RETCODE		SC_fetch_by_bookmark(StatementClass *self);
 int		SC_Create_bookmark(StatementClass *stmt, BindInfoClass *bookmark, Int4 row_pos, Int4 currTuple, const KeySet *keyset);
 PG_BM		SC_Resolve_bookmark(const ARDFields *opts, Int4 idx);
@@ -51,6 +51,7 @@ int main(int argc, char **argv)
 	SQLINTEGER	colvalues2[3];
 	SQLLEN		indColvalues1[3];
 	SQLLEN		indColvalues2[3];
+	SQLUSMALLINT	rowStatus[3];
 
 	memset(bookmark, 0x7F, sizeof(bookmark));
 	memset(saved_bookmarks, 0xF7, sizeof(saved_bookmarks));
@@ -68,7 +69,7 @@ int main(int argc, char **argv)
 	 * Initialize a table with some test data.
 	 */
 	printf("Creating test table bulkoperations_test\n");
-	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE bulkoperations_test(i int4, orig serial)", SQL_NTS);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE bulkoperations_test(i int4 CHECK (i < 9000), orig serial)", SQL_NTS);
 	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
 	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO bulkoperations_test SELECT g, g FROM generate_series(1, 10) g", SQL_NTS);
 	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
@@ -175,6 +176,43 @@ int main(int argc, char **argv)
 	printf ("updated row: %d - %d\n", colvalues1[1], colvalues2[1]);
 	printf ("inserted row: %d - %d\n", colvalues1[2], colvalues2[2]);
 
+	/**** Test bulk add of a rowset bound column-wise ****/
+	printf("Testing bulk add of 3 rows\n");
+	for (i = 0; i < 3; i++)
+	{
+		colvalues1[i] = 2001 + i;
+		colvalues2[i] = 3001 + i;
+		indColvalues1[i] = indColvalues2[i] = sizeof(SQLINTEGER);
+	}
+	rc = SQLBulkOperations(hstmt, SQL_ADD);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+
+	/**** Test bulk add of a rowset whose 2nd row violates the constraint ****/
+	printf("Testing bulk add of 3 rows with a failing row\n");
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, (SQLPOINTER) rowStatus, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	for (i = 0; i < 3; i++)
+	{
+		colvalues1[i] = 4001 + i;
+		colvalues2[i] = 3004 + i;
+		rowStatus[i] = SQL_ROW_NOROW;
+	}
+	colvalues1[1] = 9999;
+	rc = SQLBulkOperations(hstmt, SQL_ADD);
+	if (SQL_SUCCEEDED(rc))
+	{
+		printf("SQLBulkOperations unexpectedly succeeded\n");
+		exit(1);
+	}
+	printf("SQLBulkOperations failed as expected\n");
+	for (i = 0; i < 2; i++)
+		printf("row %d status: %s\n", i,
+			   rowStatus[i] == SQL_ROW_ADDED ? "added" :
+			   rowStatus[i] == SQL_ROW_ERROR ? "error" : "other");
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
 	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
 	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
 
@@ -0,0 +1,196 @@
+/*
+ * Test conversions of date/time/timestamp/interval values, in both
+ * directions. The driver parses and formats the usual ISO forms without
+ * sscanf()/snprintf(), so the expected output here is what the general
+ * code produces for the same values.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+static void
+print_value(SQLSMALLINT ctype, const void *buf)
+{
+	const TIMESTAMP_STRUCT *ts = buf;
+	const DATE_STRUCT *ds = buf;
+	const TIME_STRUCT *tms = buf;
+	const SQL_INTERVAL_STRUCT *iv = buf;
+
+	switch (ctype)
+	{
+		case SQL_C_TYPE_TIMESTAMP:
+			printf("%d-%02u-%02u %02u:%02u:%02u fraction %u\n",
+				   ts->year, ts->month, ts->day,
+				   ts->hour, ts->minute, ts->second,
+				   (unsigned int) ts->fraction);
+			break;
+		case SQL_C_TYPE_DATE:
+			printf("%d-%02u-%02u\n", ds->year, ds->month, ds->day);
+			break;
+		case SQL_C_TYPE_TIME:
+			printf("%02u:%02u:%02u\n", tms->hour, tms->minute, tms->second);
+			break;
+		case SQL_C_INTERVAL_YEAR:
+		case SQL_C_INTERVAL_MONTH:
+		case SQL_C_INTERVAL_YEAR_TO_MONTH:
+			printf("type %d sign %d year %u month %u\n",
+				   (int) iv->interval_type, (int) iv->interval_sign,
+				   (unsigned int) iv->intval.year_month.year,
+				   (unsigned int) iv->intval.year_month.month);
+			break;
+		case SQL_C_INTERVAL_DAY:
+		case SQL_C_INTERVAL_DAY_TO_SECOND:
+			printf("type %d sign %d day %u hour %u minute %u second %u fraction %u\n",
+				   (int) iv->interval_type, (int) iv->interval_sign,
+				   (unsigned int) iv->intval.day_second.day,
+				   (unsigned int) iv->intval.day_second.hour,
+				   (unsigned int) iv->intval.day_second.minute,
+				   (unsigned int) iv->intval.day_second.second,
+				   (unsigned int) iv->intval.day_second.fraction);
+			break;
+		default:
+			printf("%s\n", (const char *) buf);
+			break;
+	}
+}
+
+/* Fetch a value converted to a C type */
+static void
+test_result(HSTMT hstmt, const char *literal, SQLSMALLINT ctype, const char *ctypename)
+{
+	char		sql[200];
+	char		buf[100];
+	SQLLEN		ind;
+	SQLRETURN	rc;
+
+	snprintf(sql, sizeof(sql), "SELECT %s", literal);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+
+	memset(buf, 0, sizeof(buf));
+	rc = SQLGetData(hstmt, 1, ctype, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("%s as %s: ", literal, ctypename);
+	print_value(ctype, buf);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/* Send a timestamp parameter and read it back as text */
+static void
+test_timestamp_param(HSTMT hstmt, SQLSMALLINT year, SQLUSMALLINT month, SQLUSMALLINT day,
+					 SQLUSMALLINT hour, SQLUSMALLINT minute, SQLUSMALLINT second,
+					 SQLUINTEGER fraction)
+{
+	TIMESTAMP_STRUCT ts;
+	SQLLEN		cbParam1 = sizeof(ts);
+	char		buf[100];
+	SQLRETURN	rc;
+
+	ts.year = year;
+	ts.month = month;
+	ts.day = day;
+	ts.hour = hour;
+	ts.minute = minute;
+	ts.second = second;
+	ts.fraction = fraction;
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+						  SQL_C_TYPE_TIMESTAMP,	/* value type */
+						  SQL_TYPE_TIMESTAMP,	/* param type */
+						  26,			/* column size */
+						  6,			/* dec digits */
+						  &ts,			/* param value ptr */
+						  sizeof(ts),	/* buffer len */
+						  &cbParam1		/* StrLen_or_IndPtr */);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT ?::timestamp::text", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("timestamp param %d-%u-%u %u:%u:%u fraction %u: %s\n",
+		   year, month, day, hour, minute, second, (unsigned int) fraction, buf);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+#define TEST_RESULT(literal, ctype) test_result(hstmt, literal, ctype, #ctype)
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SET TimeZone = 'Asia/Kolkata'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SET intervalstyle = postgres", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	printf("-- timestamps\n");
+	TEST_RESULT("'2011-04-22 12:34:56'::timestamp", SQL_C_TYPE_TIMESTAMP);
+	TEST_RESULT("'2011-04-22 12:34:56'::timestamp", SQL_C_CHAR);
+	TEST_RESULT("'2011-04-22 12:34:56.789'::timestamp", SQL_C_TYPE_TIMESTAMP);
+	TEST_RESULT("'2011-04-22 12:34:56.789'::timestamp", SQL_C_CHAR);
+	TEST_RESULT("'2011-04-22 12:34:56.000001'::timestamp", SQL_C_TYPE_TIMESTAMP);
+	TEST_RESULT("'2011-04-22 12:34:56.000001'::timestamp", SQL_C_CHAR);
+	TEST_RESULT("'2011-04-22 12:34:56'::timestamp", SQL_C_TYPE_DATE);
+	TEST_RESULT("'2011-04-22 12:34:56'::timestamp", SQL_C_TYPE_TIME);
+	TEST_RESULT("'0044-03-15 12:00:00 BC'::timestamp", SQL_C_TYPE_TIMESTAMP);
+	TEST_RESULT("'0044-03-15 12:00:00 BC'::timestamp", SQL_C_CHAR);
+	TEST_RESULT("'2011-04-22 12:34:56.5+05:30'::timestamptz", SQL_C_TYPE_TIMESTAMP);
+	TEST_RESULT("'2011-04-22 12:34:56.5+05:30'::timestamptz", SQL_C_CHAR);
+
+	printf("-- dates and times\n");
+	TEST_RESULT("'2011-04-22'::date", SQL_C_TYPE_DATE);
+	TEST_RESULT("'2011-04-22'::date", SQL_C_TYPE_TIMESTAMP);
+	TEST_RESULT("'2011-04-22'::date", SQL_C_CHAR);
+	TEST_RESULT("'12:34:56'::time", SQL_C_TYPE_TIME);
+	TEST_RESULT("'12:34:56.5'::time", SQL_C_TYPE_TIME);
+	TEST_RESULT("'12:34:56.5'::time", SQL_C_CHAR);
+
+	printf("-- intervals\n");
+	TEST_RESULT("'10 years'::interval", SQL_C_INTERVAL_YEAR);
+	TEST_RESULT("'11 months'::interval", SQL_C_INTERVAL_MONTH);
+	TEST_RESULT("'12 days'::interval", SQL_C_INTERVAL_DAY);
+	TEST_RESULT("'-12 days'::interval", SQL_C_INTERVAL_DAY);
+	TEST_RESULT("'1 year 2 months'::interval", SQL_C_INTERVAL_YEAR_TO_MONTH);
+	TEST_RESULT("'-1 year -2 months'::interval", SQL_C_INTERVAL_YEAR_TO_MONTH);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SET intervalstyle = sql_standard", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	TEST_RESULT("'1 year 2 months'::interval", SQL_C_INTERVAL_YEAR_TO_MONTH);
+	TEST_RESULT("'3 days 04:05:06.789'::interval", SQL_C_INTERVAL_DAY_TO_SECOND);
+	TEST_RESULT("'-3 days -04:05:06'::interval", SQL_C_INTERVAL_DAY_TO_SECOND);
+
+	printf("-- parameters\n");
+	test_timestamp_param(hstmt, 2011, 4, 22, 12, 34, 56, 0);
+	test_timestamp_param(hstmt, 2011, 4, 22, 12, 34, 56, 789000000);
+	test_timestamp_param(hstmt, -44, 3, 15, 12, 0, 0, 0);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
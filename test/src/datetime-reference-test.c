@@ -0,0 +1,1061 @@
+/*
+ * Randomized test of the date/time/timestamp/interval conversions against
+ * the sscanf()/snprintf() based functions below, which the driver used
+ * for all values before it got its own parsers/formatters of the ISO
+ * forms. Both must give the same results for the usual values as well as
+ * for the others (infinity, 5 digit years, long fractions, odd spacing,
+ * mixed interval units, times with a zone, ...).
+ *
+ * Parameters are read back with ?::text, so that the driver sends them as
+ * text, formatted by itself, rather than in binary.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "common.h"
+
+#ifdef	WIN32
+#define	stricmp		_stricmp
+#define	strnicmp	_strnicmp
+#else
+#define	stricmp		strcasecmp
+#define	strnicmp	strncasecmp
+#endif
+
+#define NUM_PARAMS		1000
+#define NUM_RESULTS		1000
+#define RESULTS_PER_QUERY	100
+
+static unsigned int seed = 12345;
+
+static unsigned int
+rnd(unsigned int n)
+{
+	seed = seed * 1103515245 + 12345;
+	return ((seed >> 8) & 0xFFFFFF) % n;
+}
+
+typedef struct
+{
+	int			infinity;
+	int			y, m, d, hh, mm, ss, fr;
+} ref_time;
+
+/*
+ * Reference: the previous timestamp2stime(). The driver always calls it
+ * without the time zone adjustment, which is left out here.
+ */
+static int
+ref_timestamp2stime(const char *str, ref_time *st)
+{
+	char		rest[64], bc[16], *ptr;
+	int			scnt, i;
+	int			y, m, d, hh, mm, ss;
+
+	st->fr = 0;
+	st->infinity = 0;
+	rest[0] = '\0';
+	bc[0] = '\0';
+	if ((scnt = sscanf(str, "%4d-%2d-%2d %2d:%2d:%2d%31s %15s", &y, &m, &d, &hh, &mm, &ss, rest, bc)) < 6)
+	{
+		if (scnt == 3) /* date */
+		{
+			st->y  = y;
+			st->m  = m;
+			st->d  = d;
+			st->hh = 0;
+			st->mm = 0;
+			st->ss = 0;
+			return 1;
+		}
+		if ((scnt = sscanf(str, "%2d:%2d:%2d%31s %15s", &hh, &mm, &ss, rest, bc)) < 3)
+			return 0;
+		st->hh = hh;
+		st->mm = mm;
+		st->ss = ss;
+		if (scnt == 3) /* time */
+			return 1;
+	}
+	else
+	{
+		st->y  = y;
+		st->m  = m;
+		st->d  = d;
+		st->hh = hh;
+		st->mm = mm;
+		st->ss = ss;
+		if (scnt == 6)
+			return 1;
+	}
+	switch (rest[0])
+	{
+		case '+':
+		case '-':
+			break;
+		case '.':
+			if ((ptr = strchr(rest, '+')) != NULL)
+				*ptr = '\0';
+			else if ((ptr = strchr(rest, '-')) != NULL)
+				*ptr = '\0';
+			for (i = 1; i < 10; i++)
+			{
+				if (!isdigit((unsigned char) rest[i]))
+					break;
+			}
+			for (; i < 10; i++)
+				rest[i] = '0';
+			rest[i] = '\0';
+			st->fr = atoi(&rest[1]);
+			break;
+		case 'B':
+			if (stricmp(rest, "BC") == 0)
+				st->y *= -1;
+			return 1;
+		default:
+			return 1;
+	}
+	if (stricmp(bc, "BC") == 0)
+		st->y *= -1;
+	return 1;
+}
+
+/* Reference: the previous stime2timestamp(), without a time zone */
+static int
+ref_stime2timestamp(const ref_time *st, char *str, size_t bufsize, int precision)
+{
+	char		precstr[16];
+	int			i;
+
+	precstr[0] = '\0';
+	if (st->infinity > 0)
+		return snprintf(str, bufsize, "%s", "infinity");
+	else if (st->infinity < 0)
+		return snprintf(str, bufsize, "%s", "-infinity");
+	if (precision > 0 && st->fr)
+	{
+		snprintf(precstr, sizeof(precstr), ".%09d", st->fr);
+		if (precision < 9)
+			precstr[precision + 1] = '\0';
+		else if (precision > 9)
+			precision = 9;
+		for (i = precision; i > 0; i--)
+		{
+			if (precstr[i] != '0')
+				break;
+			precstr[i] = '\0';
+		}
+		if (i == 0)
+			precstr[i] = '\0';
+	}
+	if (st->y < 0)
+		return snprintf(str, bufsize, "%.4d-%.2d-%.2d %.2d:%.2d:%.2d%s BC", -st->y, st->m, st->d, st->hh, st->mm, st->ss, precstr);
+	else
+		return snprintf(str, bufsize, "%.4d-%.2d-%.2d %.2d:%.2d:%.2d%s", st->y, st->m, st->d, st->hh, st->mm, st->ss, precstr);
+}
+
+/* Reference: parse_datetime(), which the parameters go through */
+static int
+ref_parse_datetime(const char *buf, ref_time *st)
+{
+	int			y, m, d, hh, mm, ss;
+	int			nf;
+
+	y = m = d = hh = mm = ss = 0;
+	st->fr = 0;
+	st->infinity = 0;
+
+	if (buf[0] == '{')
+	{
+		while (*(++buf) && *buf != '\'');
+		if (!(*buf))
+			return 0;
+		buf++;
+	}
+	if (ref_timestamp2stime(buf, st))
+		return 1;
+	if (buf[4] == '-')			/* year first */
+		nf = sscanf(buf, "%4d-%2d-%2d %2d:%2d:%2d", &y, &m, &d, &hh, &mm, &ss);
+	else
+		nf = sscanf(buf, "%2d-%2d-%4d %2d:%2d:%2d", &m, &d, &y, &hh, &mm, &ss);
+
+	if (nf == 5 || nf == 6)
+	{
+		st->y = y;
+		st->m = m;
+		st->d = d;
+		st->hh = hh;
+		st->mm = mm;
+		st->ss = ss;
+		return 1;
+	}
+
+	if (buf[4] == '-')			/* year first */
+		nf = sscanf(buf, "%4d-%2d-%2d", &y, &m, &d);
+	else
+		nf = sscanf(buf, "%2d-%2d-%4d", &m, &d, &y);
+
+	if (nf == 3)
+	{
+		st->y = y;
+		st->m = m;
+		st->d = d;
+		return 1;
+	}
+
+	nf = sscanf(buf, "%2d:%2d:%2d", &hh, &mm, &ss);
+	if (nf == 2 || nf == 3)
+	{
+		st->hh = hh;
+		st->mm = mm;
+		st->ss = ss;
+		return 1;
+	}
+
+	return 0;
+}
+
+/* the text the driver sends for a SQL_TYPE_DATE parameter */
+static void
+ref_date_param(const ref_time *st, char *str, size_t bufsize)
+{
+	if (st->y < 0)
+		snprintf(str, bufsize, "%.4d-%.2d-%.2d BC", -st->y, st->m, st->d);
+	else
+		snprintf(str, bufsize, "%.4d-%.2d-%.2d", st->y, st->m, st->d);
+}
+
+/* the text the driver sends for a SQL_TYPE_TIME parameter */
+static void
+ref_time_param(const ref_time *st, char *str, size_t bufsize)
+{
+	if (st->fr > 0)
+	{
+		int			fr = st->fr, wdt = 9;
+
+		for (; fr % 10 == 0; wdt--, fr /= 10)
+			;
+		snprintf(str, bufsize, "%.2d:%.2d:%.2d.%0*d", st->hh, st->mm, st->ss, wdt, fr);
+	}
+	else
+		snprintf(str, bufsize, "%.2d:%.2d:%.2d", st->hh, st->mm, st->ss);
+}
+
+static SQLINTERVAL
+ref_interval2itype(SQLSMALLINT ctype)
+{
+	switch (ctype)
+	{
+		case SQL_C_INTERVAL_YEAR:
+			return SQL_IS_YEAR;
+		case SQL_C_INTERVAL_MONTH:
+			return SQL_IS_MONTH;
+		case SQL_C_INTERVAL_YEAR_TO_MONTH:
+			return SQL_IS_YEAR_TO_MONTH;
+		case SQL_C_INTERVAL_DAY:
+			return SQL_IS_DAY;
+		case SQL_C_INTERVAL_HOUR:
+			return SQL_IS_HOUR;
+		case SQL_C_INTERVAL_DAY_TO_HOUR:
+			return SQL_IS_DAY_TO_HOUR;
+		case SQL_C_INTERVAL_MINUTE:
+			return SQL_IS_MINUTE;
+		case SQL_C_INTERVAL_DAY_TO_MINUTE:
+			return SQL_IS_DAY_TO_MINUTE;
+		case SQL_C_INTERVAL_HOUR_TO_MINUTE:
+			return SQL_IS_HOUR_TO_MINUTE;
+		case SQL_C_INTERVAL_SECOND:
+			return SQL_IS_SECOND;
+		case SQL_C_INTERVAL_DAY_TO_SECOND:
+			return SQL_IS_DAY_TO_SECOND;
+		case SQL_C_INTERVAL_HOUR_TO_SECOND:
+			return SQL_IS_HOUR_TO_SECOND;
+		case SQL_C_INTERVAL_MINUTE_TO_SECOND:
+			return SQL_IS_MINUTE_TO_SECOND;
+	}
+	return 0;
+}
+
+static int
+ref_precision_part(int precision, const char *precPart)
+{
+	char		fraction[] = "000000000";
+	size_t		cpys;
+
+	if (precision < 0)
+		precision = 6; /* default */
+	if (precision == 0)
+		return 0;
+	cpys = strlen(precPart);
+	if (cpys > sizeof(fraction) - 1)
+		cpys = sizeof(fraction) - 1;
+	memcpy(fraction, precPart, cpys);
+	fraction[precision] = '\0';
+
+	return atoi(fraction);
+}
+
+/* Reference: the previous interval2istruct() */
+static int
+ref_interval2istruct(SQLSMALLINT ctype, int precision, const char *str, SQL_INTERVAL_STRUCT *st)
+{
+	char		lit1[64], lit2[64];
+	int			scnt, years, mons, days, hours, minutes, seconds;
+	SQLSMALLINT	sign;
+	SQLINTERVAL	itype = ref_interval2itype(ctype);
+
+	memset(st, 0, sizeof(SQL_INTERVAL_STRUCT));
+	if ((scnt = sscanf(str, "%d-%d", &years, &mons)) >= 2)
+	{
+		if (SQL_IS_YEAR_TO_MONTH == itype)
+		{
+			sign = years < 0 ? SQL_TRUE : SQL_FALSE;
+			st->interval_type = itype;
+			st->interval_sign = sign;
+			st->intval.year_month.year = sign ? (-years) : years;
+			st->intval.year_month.month = mons;
+			return 1;
+		}
+		return 0;
+	}
+	else if (scnt = sscanf(str, "%d %02d:%02d:%02d.%09s", &days, &hours, &minutes, &seconds, lit2), 5 == scnt || 4 == scnt)
+	{
+		sign = days < 0 ? SQL_TRUE : SQL_FALSE;
+		st->interval_type = itype;
+		st->interval_sign = sign;
+		st->intval.day_second.day = sign ? (-days) : days;
+		st->intval.day_second.hour = hours;
+		st->intval.day_second.minute = minutes;
+		st->intval.day_second.second = seconds;
+		if (scnt > 4)
+			st->intval.day_second.fraction = ref_precision_part(precision, lit2);
+		return 1;
+	}
+	else if ((scnt = sscanf(str, "%d %10s %d %10s", &years, lit1, &mons, lit2)) >= 4)
+	{
+		if (strnicmp(lit1, "year", 4) == 0 &&
+			strnicmp(lit2, "mon", 2) == 0 &&
+			(SQL_IS_MONTH == itype ||
+			 SQL_IS_YEAR_TO_MONTH == itype))
+		{
+			sign = years < 0 ? SQL_TRUE : SQL_FALSE;
+			st->interval_type = itype;
+			st->interval_sign = sign;
+			st->intval.year_month.year = sign ? (-years) : years;
+			st->intval.year_month.month = sign ? (-mons) : mons;
+			return 1;
+		}
+		return 0;
+	}
+	if ((scnt = sscanf(str, "%d %10s %d", &years, lit1, &days)) == 2)
+	{
+		sign = years < 0 ? SQL_TRUE : SQL_FALSE;
+		if (SQL_IS_YEAR == itype &&
+			(stricmp(lit1, "year") == 0 ||
+			 stricmp(lit1, "years") == 0))
+		{
+			st->interval_type = itype;
+			st->interval_sign = sign;
+			st->intval.year_month.year = sign ? (-years) : years;
+			return 1;
+		}
+		if (SQL_IS_MONTH == itype &&
+			(stricmp(lit1, "mon") == 0 ||
+			 stricmp(lit1, "mons") == 0))
+		{
+			st->interval_type = itype;
+			st->interval_sign = sign;
+			st->intval.year_month.month = sign ? (-years) : years;
+			return 1;
+		}
+		if (SQL_IS_DAY == itype &&
+			(stricmp(lit1, "day") == 0 ||
+			 stricmp(lit1, "days") == 0))
+		{
+			st->interval_type = itype;
+			st->interval_sign = sign;
+			st->intval.day_second.day = sign ? (-years) : years;
+			return 1;
+		}
+		return 0;
+	}
+	if (itype == SQL_IS_YEAR || itype == SQL_IS_MONTH || itype == SQL_IS_YEAR_TO_MONTH)
+		return 0;
+	scnt = sscanf(str, "%d %10s %02d:%02d:%02d.%09s", &days, lit1, &hours, &minutes, &seconds, lit2);
+	if (scnt == 5 || scnt == 6)
+	{
+		if (strnicmp(lit1, "day", 3) != 0)
+			return 0;
+		sign = days < 0 ? SQL_TRUE : SQL_FALSE;
+		st->interval_type = itype;
+		st->interval_sign = sign;
+		st->intval.day_second.day = sign ? (-days) : days;
+		st->intval.day_second.hour = sign ? (-hours) : hours;
+		st->intval.day_second.minute = minutes;
+		st->intval.day_second.second = seconds;
+		if (scnt > 5)
+			st->intval.day_second.fraction = ref_precision_part(precision, lit2);
+		return 1;
+	}
+	scnt = sscanf(str, "%02d:%02d:%02d.%09s", &hours, &minutes, &seconds, lit2);
+	if (scnt == 3 || scnt == 4)
+	{
+		sign = hours < 0 ? SQL_TRUE : SQL_FALSE;
+		st->interval_type = itype;
+		st->interval_sign = sign;
+		st->intval.day_second.hour = sign ? (-hours) : hours;
+		st->intval.day_second.minute = minutes;
+		st->intval.day_second.second = seconds;
+		if (scnt > 3)
+			st->intval.day_second.fraction = ref_precision_part(precision, lit2);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void
+append_digits(char **p, int n)
+{
+	while (n-- > 0)
+		*(*p)++ = '0' + rnd(10);
+}
+
+static void
+append_str(char **p, const char *s)
+{
+	size_t		len = strlen(s);
+
+	memcpy(*p, s, len);
+	*p += len;
+}
+
+/* no quotes, the interval strings are put in SQL literals */
+static const char *const extras[] = {
+	" ", "  ", "-", ":", ".", "+", "BC", " BC", " bc", "T", "0", "12",
+	".123456", ".1234567890", "+05:30", "-08", "x", "day", "days", "mons",
+	"1 ", "3 days", " 04:05:06", "year 2 mons", "99999"
+};
+#define NUM_EXTRAS (sizeof(extras) / sizeof(extras[0]))
+
+static void
+append_extras(char **p, const char *str)
+{
+	while (!rnd(6) && *p - str < 60)
+		append_str(p, extras[rnd(NUM_EXTRAS)]);
+}
+
+/*
+ * A date/time string mostly in the ISO form, with random deviations: 5
+ * digit years, 1 or 3 digit fields, 'T' separators, fractions of up to 12
+ * digits, UTC offsets with minutes and seconds, BC, ODBC escapes, ...
+ */
+static void
+random_datetime_str(char *str)
+{
+	char	   *p = str;
+	unsigned int kind = rnd(20);
+	int			escape = (1 == kind);
+
+	if (0 == kind)
+	{
+		strcpy(str, rnd(2) ? "infinity" : "-infinity");
+		return;
+	}
+	if (escape)
+		append_str(&p, rnd(2) ? "{ts '" : "{t '");
+	if (kind < 14)
+	{
+		append_digits(&p, rnd(8) ? 4 : 1 + rnd(5));
+		*p++ = '-';
+		append_digits(&p, rnd(8) ? 2 : 1);
+		*p++ = '-';
+		append_digits(&p, rnd(8) ? 2 : 1 + rnd(3));
+	}
+	if (kind >= 14 || rnd(5))
+	{
+		if (kind < 14)
+			append_str(&p, rnd(10) ? " " : (rnd(2) ? "T" : "  "));
+		append_digits(&p, rnd(8) ? 2 : 1 + rnd(3));
+		*p++ = ':';
+		append_digits(&p, rnd(8) ? 2 : 1);
+		if (rnd(8))
+		{
+			*p++ = ':';
+			append_digits(&p, rnd(8) ? 2 : 1 + rnd(2));
+		}
+		if (rnd(2))
+		{
+			*p++ = '.';
+			append_digits(&p, rnd(13));
+		}
+		if (!rnd(3))
+		{
+			*p++ = rnd(2) ? '+' : '-';
+			append_digits(&p, rnd(6) ? 2 : 1 + rnd(3));
+			if (!rnd(3))
+			{
+				*p++ = ':';
+				append_digits(&p, rnd(5) ? 2 : 1);
+				if (!rnd(3))
+				{
+					*p++ = ':';
+					append_digits(&p, 2);
+				}
+			}
+		}
+	}
+	if (!rnd(4))
+		append_str(&p, rnd(4) ? " BC" : (rnd(2) ? "BC" : " bc"));
+	append_extras(&p, str);
+	if (escape)
+		append_str(&p, "'}");
+	*p = '\0';
+}
+
+static const char *const interval_units[] = {
+	"year", "years", "mon", "mons", "day", "days", "Year", "MONS", "hours",
+	"yearsXXXXXXXXX", "d"
+};
+#define NUM_UNITS (sizeof(interval_units) / sizeof(interval_units[0]))
+
+/* An interval string in one of the forms interval2istruct() reads, or not */
+static void
+random_interval_str(char *str)
+{
+	char	   *p = str;
+
+	if (!rnd(4))
+		*p++ = '-';
+	append_digits(&p, 1 + rnd(rnd(10) ? 3 : 12));
+	switch (rnd(5))
+	{
+		case 0:		/* Y-M */
+			*p++ = '-';
+			if (!rnd(5))
+				*p++ = '-';
+			append_digits(&p, 1 + rnd(3));
+			break;
+		case 1:		/* D H:MM:SS[.f] */
+			*p++ = ' ';
+			if (!rnd(8))
+				*p++ = '-';
+			append_digits(&p, rnd(6) ? 1 + rnd(2) : 3);
+			*p++ = ':';
+			append_digits(&p, rnd(6) ? 2 : 1);
+			*p++ = ':';
+			append_digits(&p, rnd(6) ? 2 : 1);
+			if (rnd(2))
+			{
+				*p++ = '.';
+				append_digits(&p, rnd(13));
+			}
+			break;
+		case 2:		/* N unit */
+			*p++ = ' ';
+			append_str(&p, interval_units[rnd(NUM_UNITS)]);
+			break;
+		case 3:		/* N unit N unit */
+			*p++ = ' ';
+			append_str(&p, interval_units[rnd(NUM_UNITS)]);
+			*p++ = ' ';
+			if (!rnd(4))
+				*p++ = '-';
+			append_digits(&p, 1 + rnd(3));
+			*p++ = ' ';
+			append_str(&p, interval_units[rnd(NUM_UNITS)]);
+			break;
+		case 4:		/* N unit HH:MM:SS */
+			*p++ = ' ';
+			append_str(&p, interval_units[rnd(NUM_UNITS)]);
+			*p++ = ' ';
+			append_digits(&p, 2);
+			*p++ = ':';
+			append_digits(&p, 2);
+			*p++ = ':';
+			append_digits(&p, 2);
+			break;
+	}
+	append_extras(&p, str);
+	*p = '\0';
+}
+
+static const char *const datetime_edge_cases[] = {
+	"2011-04-22 12:34:56",
+	"2011-04-22 12:34:56.789",
+	"2011-04-22",
+	"12:34:56",
+	"infinity",
+	"-infinity",
+	"12345-01-01 00:00:00",
+	"99999-12-31",
+	"2011-04-22 12:34:56.1234567890123",
+	"12:34:56.0000000001",
+	"2011-04-22  12:34:56",
+	" 2011-04-22 12:34:56",
+	"2011-04-22T12:34:56",
+	"2011-4-2 1:2:3",
+	"0044-03-15 12:00:00 BC",
+	"0044-03-15 12:00:00BC",
+	"0044-03-15 12:00:00.5 BC",
+	"0044-03-15 BC",
+	"2011-04-22 12:34:56+05:30",
+	"2011-04-22 12:34:56.5-08",
+	"12:34:56+05:30",
+	"12:34:56.789-08",
+	"12:34:56+05:30:15",
+	"12:34:56.5+05:30 BC",
+	"{ts '2011-04-22 12:34:56'}",
+	"{d '2011-04-22'}",
+	"{t '12:34:56'}",
+	"04-22-2011 12:34",
+	"garbage"
+};
+
+static const char *const interval_edge_cases[] = {
+	"1 year 2 mons",
+	"-1 years -2 mons",
+	"1 year 2 mons 3 days 04:05:06.789",
+	"3 days 04:05:06.1234567890",
+	"1-2",
+	"-1-2",
+	"1--2",
+	"3 04:05:06",
+	"-3 -04:05:06",
+	"04:05:06.5",
+	"-04:05:06",
+	"@ 1 year 2 mons",
+	"P1Y2M3DT4H5M6S",
+	"3  days",
+	"  3 days",
+	"3 days ",
+	"10 DAYS",
+	"2147483647 days",
+	"99999999999 days",
+	"1 yearsXXXXXXXXX 2 mons"
+};
+
+#define NUM_DATETIME_EDGE_CASES ((int) (sizeof(datetime_edge_cases) / sizeof(datetime_edge_cases[0])))
+#define NUM_INTERVAL_EDGE_CASES ((int) (sizeof(interval_edge_cases) / sizeof(interval_edge_cases[0])))
+
+/*
+ * Date/time strings sent as timestamp, date and time parameters, which
+ * the driver parses and formats again.
+ */
+static void
+test_string_params(HSTMT hstmt)
+{
+	char		str[200];
+	char		result[3][100], expected[3][100];
+	ref_time	st;
+	SQLLEN		cbParam = SQL_NTS;
+	SQLRETURN	rc;
+	int			i, j, total, mismatches = 0;
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT ?::text, ?::text, ?::text", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_TYPE_TIMESTAMP,
+						  26, 6, str, sizeof(str), &cbParam);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_TYPE_DATE,
+						  10, 0, str, sizeof(str), &cbParam);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 3, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_TYPE_TIME,
+						  8, 0, str, sizeof(str), &cbParam);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	total = NUM_DATETIME_EDGE_CASES + NUM_PARAMS;
+	for (i = 0; i < total; i++)
+	{
+		if (i < NUM_DATETIME_EDGE_CASES)
+			strcpy(str, datetime_edge_cases[i]);
+		else
+			random_datetime_str(str);
+
+		memset(&st, 0, sizeof(st));
+		ref_parse_datetime(str, &st);
+		ref_stime2timestamp(&st, expected[0], sizeof(expected[0]), 6);
+		ref_date_param(&st, expected[1], sizeof(expected[1]));
+		ref_time_param(&st, expected[2], sizeof(expected[2]));
+
+		rc = SQLExecute(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+		rc = SQLFetch(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		for (j = 0; j < 3; j++)
+		{
+			rc = SQLGetData(hstmt, j + 1, SQL_C_CHAR, result[j], sizeof(result[j]), NULL);
+			CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+			if (strcmp(result[j], expected[j]) != 0)
+			{
+				printf("param mismatch for \"%s\" as %s: \"%s\", expected \"%s\"\n",
+					   str, 0 == j ? "timestamp" : (1 == j ? "date" : "time"),
+					   result[j], expected[j]);
+				mismatches++;
+			}
+		}
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+	printf("%d string params checked, %d mismatches\n", total * 3, mismatches);
+
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/* TIMESTAMP_STRUCT parameters, including the ones out of the ISO form */
+static void
+test_timestamp_params(HSTMT hstmt)
+{
+	TIMESTAMP_STRUCT ts;
+	char		result[100], expected[100];
+	ref_time	st;
+	SQLLEN		cbParam = sizeof(ts);
+	SQLRETURN	rc;
+	int			i, mismatches = 0;
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT ?::text", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_TYPE_TIMESTAMP, SQL_TYPE_TIMESTAMP,
+						  26, 6, &ts, sizeof(ts), &cbParam);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	for (i = 0; i < NUM_PARAMS; i++)
+	{
+		memset(&ts, 0, sizeof(ts));
+		switch (rnd(10))
+		{
+			case 0:		/* 5 digit years */
+				ts.year = 10000 + rnd(22768);
+				break;
+			case 1:		/* BC */
+				ts.year = -(SQLSMALLINT) (1 + rnd(rnd(2) ? 9999 : 32767));
+				break;
+			default:
+				ts.year = rnd(10000);
+				break;
+		}
+		ts.month = rnd(10) ? 1 + rnd(12) : rnd(200);
+		ts.day = rnd(10) ? 1 + rnd(31) : rnd(200);
+		ts.hour = rnd(10) ? rnd(24) : rnd(200);
+		ts.minute = rnd(10) ? rnd(60) : rnd(200);
+		ts.second = rnd(10) ? rnd(60) : rnd(200);
+		if (rnd(2))
+			ts.fraction = rnd(3) ? rnd(1000) * 1000000 : rnd(1000000) * 1000 + rnd(1000);
+
+		memset(&st, 0, sizeof(st));
+		st.y = ts.year;
+		st.m = ts.month;
+		st.d = ts.day;
+		st.hh = ts.hour;
+		st.mm = ts.minute;
+		st.ss = ts.second;
+		st.fr = ts.fraction;
+		ref_stime2timestamp(&st, expected, sizeof(expected), 6);
+
+		rc = SQLExecute(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+		rc = SQLFetch(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		rc = SQLGetData(hstmt, 1, SQL_C_CHAR, result, sizeof(result), NULL);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		if (strcmp(result, expected) != 0)
+		{
+			printf("timestamp param mismatch: \"%s\", expected \"%s\"\n", result, expected);
+			mismatches++;
+		}
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+	printf("%d timestamp params checked, %d mismatches\n", NUM_PARAMS, mismatches);
+
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/* the driver fills in the missing date fields from the current date */
+#define CHECK_FIELD(field, refval) \
+	((refval) == 0 || (field) == (refval))
+
+/*
+ * Values of the type 'type' from the server, fetched as the C type 'ctype'
+ * and as text, which the reference functions convert.
+ */
+static void
+test_results(HSTMT hstmt, const char *type, SQLSMALLINT ctype)
+{
+	static char	sql[RESULTS_PER_QUERY * 150 + 100];
+	char		text[100];
+	TIMESTAMP_STRUCT ts;
+	DATE_STRUCT	ds;
+	TIME_STRUCT	tms;
+	ref_time	st;
+	SQLRETURN	rc;
+	int			i, j, pos, ok, mismatches = 0;
+
+	for (i = 0; i < NUM_RESULTS; i += RESULTS_PER_QUERY)
+	{
+		pos = sprintf(sql, "SELECT x, x::text FROM (VALUES ");
+		for (j = 0; j < RESULTS_PER_QUERY; j++)
+		{
+			int			year = 1 + (rnd(5) ? rnd(9999) : rnd(99999));
+			const char *bc = "";
+			char		frac[8];
+
+			if (!rnd(5))
+			{
+				year = 1 + rnd(4712);
+				bc = " BC";
+			}
+			frac[0] = '\0';
+			if (rnd(2))
+				sprintf(frac, ".%0*u", 1 + (int) rnd(6), rnd(1000000));
+			pos += sprintf(sql + pos, "%s(%d, ", j > 0 ? ", " : "", j);
+			if (SQL_C_TYPE_TIME == ctype)
+			{
+				if (!rnd(50))
+					pos += sprintf(sql + pos, "'24:00:00'::time)");
+				else
+					pos += sprintf(sql + pos, "'%02u:%02u:%02u%s'::time)",
+								   rnd(24), rnd(60), rnd(60), frac);
+			}
+			else if (!rnd(20))
+				pos += sprintf(sql + pos, "'%sinfinity'::%s)", rnd(2) ? "-" : "", type);
+			else if (SQL_C_TYPE_DATE == ctype)
+				pos += sprintf(sql + pos, "'%04d-%02u-%02u%s'::%s)",
+							   year, 1 + rnd(12), 1 + rnd(28), bc, type);
+			else
+				pos += sprintf(sql + pos, "'%04d-%02u-%02u %02u:%02u:%02u%s%s'::%s)",
+							   year, 1 + rnd(12), 1 + rnd(28),
+							   rnd(24), rnd(60), rnd(60), frac, bc, type);
+		}
+		sprintf(sql + pos, ") v(n, x) ORDER BY n");
+
+		rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+		CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+		for (j = 0; j < RESULTS_PER_QUERY; j++)
+		{
+			rc = SQLFetch(hstmt);
+			CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+			if (SQL_C_TYPE_DATE == ctype)
+				rc = SQLGetData(hstmt, 1, ctype, &ds, sizeof(ds), NULL);
+			else if (SQL_C_TYPE_TIME == ctype)
+				rc = SQLGetData(hstmt, 1, ctype, &tms, sizeof(tms), NULL);
+			else
+				rc = SQLGetData(hstmt, 1, ctype, &ts, sizeof(ts), NULL);
+			CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+			rc = SQLGetData(hstmt, 2, SQL_C_CHAR, text, sizeof(text), NULL);
+			CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+
+			/* what the driver does before and around the conversion */
+			memset(&st, 0, sizeof(st));
+			switch (ctype)
+			{
+				case SQL_C_TYPE_DATE:
+					sscanf(text, "%4d-%2d-%2d", &st.y, &st.m, &st.d);
+					ok = CHECK_FIELD(ds.year, (SQLSMALLINT) st.y) &&
+						 CHECK_FIELD(ds.month, st.m) &&
+						 CHECK_FIELD(ds.day, st.d);
+					break;
+				case SQL_C_TYPE_TIME:
+					ref_timestamp2stime(text, &st);
+					ok = tms.hour == st.hh &&
+						 tms.minute == st.mm &&
+						 tms.second == st.ss;
+					break;
+				default:
+					if (strnicmp(text, "infinity", 8) == 0)
+					{
+						st.m = 12;
+						st.d = 31;
+						st.y = 9999;
+						st.hh = 23;
+						st.mm = 59;
+						st.ss = 59;
+					}
+					if (strnicmp(text, "-infinity", 9) == 0)
+					{
+						st.m = 1;
+						st.d = 1;
+						st.y = -9999;
+					}
+					ref_timestamp2stime(text, &st);
+					ok = CHECK_FIELD(ts.year, (SQLSMALLINT) st.y) &&
+						 CHECK_FIELD(ts.month, st.m) &&
+						 CHECK_FIELD(ts.day, st.d) &&
+						 ts.hour == st.hh &&
+						 ts.minute == st.mm &&
+						 ts.second == st.ss &&
+						 ts.fraction == (SQLUINTEGER) st.fr;
+					break;
+			}
+			if (!ok)
+			{
+				printf("%s result mismatch for %s\n", type, text);
+				mismatches++;
+			}
+		}
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+	printf("%d %s results checked, %d mismatches\n", NUM_RESULTS, type, mismatches);
+}
+
+/* a random interval from the server, with some of the fields zero */
+static int
+random_interval_expr(char *str)
+{
+	int			years = rnd(3) ? 0 : (int) rnd(200) - 100;
+	int			months = rnd(3) ? 0 : (int) rnd(30) - 15;
+	int			days = rnd(3) ? 0 : (int) rnd(2000) - 1000;
+	int			hours = rnd(3) ? 0 : (int) rnd(60) - 30;
+	int			mins = rnd(3) ? 0 : (int) rnd(120) - 60;
+	int			secs = rnd(3) ? 0 : (int) rnd(120) - 60;
+
+	return sprintf(str, "make_interval(%d, %d, 0, %d, %d, %d, %d.%06u)",
+				   years, months, days, hours, mins, secs, rnd(2) ? 0 : rnd(1000000));
+}
+
+/*
+ * Interval strings, fetched as the interval C types. interval2istruct()
+ * reads the text of any type, so the generated strings are sent as text
+ * values, and the others are intervals in the style the server has been
+ * set to.
+ */
+static void
+test_interval_results(HSTMT hstmt, int from_server)
+{
+	static char	sql[RESULTS_PER_QUERY * 150 + 100];
+	char		strs[RESULTS_PER_QUERY][100];
+	char		text[100];
+	SQLSMALLINT	ctypes[RESULTS_PER_QUERY];
+	SQL_INTERVAL_STRUCT iv, refiv;
+	SQLRETURN	rc;
+	int			i, j, pos, edge = 0, num_rows, mismatches = 0;
+
+	num_rows = from_server ? NUM_RESULTS : NUM_INTERVAL_EDGE_CASES * 13 + NUM_RESULTS;
+	for (i = 0; i < num_rows; i += RESULTS_PER_QUERY)
+	{
+		pos = sprintf(sql, "SELECT x, x::text FROM (VALUES ");
+		for (j = 0; j < RESULTS_PER_QUERY && i + j < num_rows; j++)
+		{
+			pos += sprintf(sql + pos, "%s(%d, ", j > 0 ? ", " : "", j);
+			if (from_server)
+			{
+				ctypes[j] = SQL_C_INTERVAL_YEAR + rnd(13);
+				pos += random_interval_expr(sql + pos);
+			}
+			else
+			{
+				/* each of the edge cases as every interval type */
+				if (edge < NUM_INTERVAL_EDGE_CASES * 13)
+				{
+					strcpy(strs[j], interval_edge_cases[edge / 13]);
+					ctypes[j] = SQL_C_INTERVAL_YEAR + edge % 13;
+					edge++;
+				}
+				else
+				{
+					random_interval_str(strs[j]);
+					ctypes[j] = SQL_C_INTERVAL_YEAR + rnd(13);
+				}
+				pos += sprintf(sql + pos, "'%s'::text", strs[j]);
+			}
+			pos += sprintf(sql + pos, ")");
+		}
+		sprintf(sql + pos, ") v(n, x) ORDER BY n");
+
+		rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+		CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+		for (j = 0; j < RESULTS_PER_QUERY && i + j < num_rows; j++)
+		{
+			rc = SQLFetch(hstmt);
+			CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+			memset(&iv, 0, sizeof(iv));
+			rc = SQLGetData(hstmt, 1, ctypes[j], &iv, sizeof(iv), NULL);
+			CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+			rc = SQLGetData(hstmt, 2, SQL_C_CHAR, text, sizeof(text), NULL);
+			CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+			ref_interval2istruct(ctypes[j], -1, text, &refiv);
+			if (memcmp(&iv, &refiv, sizeof(iv)) != 0)
+			{
+				printf("interval result mismatch for \"%s\" as type %d\n", text, ctypes[j]);
+				mismatches++;
+			}
+		}
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+	printf("%d interval results checked, %d mismatches\n", num_rows, mismatches);
+}
+
+static void
+exec_sql(HSTMT hstmt, const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	static const char *const timezones[] = {
+		"UTC", "Asia/Kolkata", "America/St_Johns", "Asia/Kathmandu"
+	};
+	static const char *const intervalstyles[] = {
+		"postgres", "sql_standard", "postgres_verbose", "iso_8601"
+	};
+	char		sql[100];
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	int			i;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	exec_sql(hstmt, "SET DateStyle = ISO");
+
+	printf("Testing date/time string params...\n");
+	test_string_params(hstmt);
+
+	printf("Testing TIMESTAMP_STRUCT params...\n");
+	test_timestamp_params(hstmt);
+
+	printf("Testing date/time results...\n");
+	test_results(hstmt, "timestamp", SQL_C_TYPE_TIMESTAMP);
+	test_results(hstmt, "date", SQL_C_TYPE_DATE);
+	test_results(hstmt, "time", SQL_C_TYPE_TIME);
+	/* offsets with minutes, and seconds for the old local mean times */
+	for (i = 0; i < (int) (sizeof(timezones) / sizeof(timezones[0])); i++)
+	{
+		printf("TimeZone %s: ", timezones[i]);
+		snprintf(sql, sizeof(sql), "SET TimeZone = '%s'", timezones[i]);
+		exec_sql(hstmt, sql);
+		test_results(hstmt, "timestamptz", SQL_C_TYPE_TIMESTAMP);
+	}
+
+	printf("Testing interval results...\n");
+	test_interval_results(hstmt, 0);
+	for (i = 0; i < (int) (sizeof(intervalstyles) / sizeof(intervalstyles[0])); i++)
+	{
+		printf("IntervalStyle %s: ", intervalstyles[i]);
+		snprintf(sql, sizeof(sql), "SET IntervalStyle = %s", intervalstyles[i]);
+		exec_sql(hstmt, sql);
+		test_interval_results(hstmt, 1);
+	}
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
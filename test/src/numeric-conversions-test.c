@@ -0,0 +1,284 @@
+/*
+ * Randomized test of the SQL_NUMERIC_STRUCT conversions, in both
+ * directions, against the plain digit-by-digit algorithms below. The
+ * results are fetched in the text format and in the binary format
+ * (BinaryResults=1), which the driver decodes directly.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define NUM_PARAMS		500
+#define NUM_RESULTS		1000
+#define RESULTS_PER_QUERY	100
+
+static unsigned int seed = 12345;
+
+static unsigned int
+rnd(unsigned int n)
+{
+	seed = seed * 1103515245 + 12345;
+	return ((seed >> 8) & 0xFFFFFF) % n;
+}
+
+/*
+ * Reference: the text form of a SQL_NUMERIC_STRUCT, dividing the
+ * little-endian mantissa by 10 byte by byte.
+ */
+static void
+ref_numeric_to_str(const SQL_NUMERIC_STRUCT *ns, char *str)
+{
+	unsigned char vals[SQL_MAX_NUMERIC_LEN];
+	char		digits[40];
+	int			ndigits = 0, i, pos = 0, nonzero;
+
+	memcpy(vals, ns->val, sizeof(vals));
+	do
+	{
+		unsigned int r = 0;
+
+		nonzero = 0;
+		for (i = SQL_MAX_NUMERIC_LEN - 1; i >= 0; i--)
+		{
+			unsigned int v = vals[i] + (r << 8);
+
+			vals[i] = v / 10;
+			r = v % 10;
+			if (vals[i])
+				nonzero = 1;
+		}
+		digits[ndigits++] = '0' + r;
+	} while (nonzero);
+
+	if (0 == ns->sign)
+		str[pos++] = '-';
+	for (i = (ndigits - 1 > ns->scale ? ndigits - 1 : ns->scale); i >= ns->scale; i--)
+		str[pos++] = (i < ndigits) ? digits[i] : '0';
+	if (ns->scale > 0)
+	{
+		str[pos++] = '.';
+		for (; i >= 0; i--)
+			str[pos++] = (i < ndigits) ? digits[i] : '0';
+	}
+	str[pos] = '\0';
+}
+
+/*
+ * Reference: a canonical numeric text (as numeric_out prints it) into a
+ * SQL_NUMERIC_STRUCT, multiplying the mantissa by 10 byte by byte.
+ */
+static void
+ref_str_to_numeric(const char *str, SQL_NUMERIC_STRUCT *ns)
+{
+	int			i;
+
+	memset(ns, 0, sizeof(*ns));
+	ns->sign = 1;
+	if ('-' == *str)
+	{
+		ns->sign = 0;
+		str++;
+	}
+	while ('0' == *str)
+		str++;
+	for (; *str; str++)
+	{
+		unsigned int carry;
+
+		if ('.' == *str)
+		{
+			ns->scale = (SQLSCHAR) strlen(str + 1);
+			continue;
+		}
+		ns->precision++;
+		carry = *str - '0';
+		for (i = 0; i < SQL_MAX_NUMERIC_LEN; i++)
+		{
+			unsigned int t = ns->val[i] * 10 + carry;
+
+			ns->val[i] = t & 0xFF;
+			carry = t >> 8;
+		}
+	}
+}
+
+/* A random numeric of up to 38 digits, in its canonical text form */
+static void
+random_numeric_str(char *str)
+{
+	int			intlen = rnd(3) ? rnd(12) : rnd(30);
+	int			fraclen = rnd(2) ? rnd(38 - intlen) : 0;
+	int			pos = 0, i, nonzero = 0;
+
+	if (rnd(2))
+		str[pos++] = '-';
+	if (0 == intlen)
+		str[pos++] = '0';
+	for (i = 0; i < intlen; i++, nonzero = 1)
+		str[pos++] = (0 == i ? '1' + rnd(9) : '0' + rnd(10));
+	if (fraclen > 0)
+	{
+		str[pos++] = '.';
+		for (i = 0; i < fraclen; i++)
+		{
+			str[pos] = rnd(3) ? '0' + rnd(10) : '0';
+			if ('0' != str[pos++])
+				nonzero = 1;
+		}
+	}
+	str[pos] = '\0';
+	/* no negative zero */
+	if ('-' == str[0] && !nonzero)
+		memmove(str, str + 1, pos);
+}
+
+static void
+print_numeric_struct(const SQL_NUMERIC_STRUCT *ns)
+{
+	int			i;
+
+	printf("sign %u prec %u scale %d val ", ns->sign, ns->precision, ns->scale);
+	for (i = 0; i < SQL_MAX_NUMERIC_LEN; i++)
+		printf("%02X", ns->val[i]);
+	printf("\n");
+}
+
+static void
+test_params(HSTMT hstmt)
+{
+	SQL_NUMERIC_STRUCT ns;
+	char		refstr[100];
+	char		result[10];
+	SQLLEN		cbParam1 = sizeof(ns), cbParam2 = SQL_NTS;
+	SQLRETURN	rc;
+	int			i, j, nbytes, mismatches = 0;
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT CASE WHEN ?::numeric::text = ?::numeric::text THEN 1 ELSE 0 END", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_NUMERIC, SQL_NUMERIC,
+						  0, 0, &ns, sizeof(ns), &cbParam1);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR,
+						  sizeof(refstr), 0, refstr, sizeof(refstr), &cbParam2);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	for (i = 0; i < NUM_PARAMS; i++)
+	{
+		/* a mantissa of up to 126 bits, so that it has at most 38 digits */
+		memset(&ns, 0, sizeof(ns));
+		nbytes = rnd(SQL_MAX_NUMERIC_LEN + 1);
+		for (j = 0; j < nbytes; j++)
+			ns.val[j] = rnd(256);
+		if (SQL_MAX_NUMERIC_LEN == nbytes)
+			ns.val[SQL_MAX_NUMERIC_LEN - 1] &= 0x3F;
+		ns.sign = rnd(2);
+		ns.precision = 38;
+		ns.scale = rnd(39);
+		ref_numeric_to_str(&ns, refstr);
+
+		rc = SQLExecute(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+		rc = SQLFetch(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		rc = SQLGetData(hstmt, 1, SQL_C_CHAR, result, sizeof(result), NULL);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		if (strcmp(result, "1") != 0)
+		{
+			printf("param mismatch, expected %s: ", refstr);
+			print_numeric_struct(&ns);
+			mismatches++;
+		}
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+	printf("%d params checked, %d mismatches\n", NUM_PARAMS, mismatches);
+
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+test_results(HSTMT hstmt)
+{
+	static char	numstrs[RESULTS_PER_QUERY][50];
+	static char	sql[RESULTS_PER_QUERY * 60 + 100];
+	SQL_NUMERIC_STRUCT ns, refns;
+	SQLRETURN	rc;
+	int			i, j, pos, mismatches = 0;
+
+	for (i = 0; i < NUM_RESULTS; i += RESULTS_PER_QUERY)
+	{
+		pos = sprintf(sql, "SELECT x::numeric FROM (VALUES ");
+		for (j = 0; j < RESULTS_PER_QUERY; j++)
+		{
+			random_numeric_str(numstrs[j]);
+			pos += sprintf(sql + pos, "%s(%d, '%s')", j > 0 ? ", " : "", j, numstrs[j]);
+		}
+		sprintf(sql + pos, ") v(n, x) ORDER BY n");
+
+		/* prepared, for the binary format to be used with BinaryResults */
+		rc = SQLPrepare(hstmt, (SQLCHAR *) sql, SQL_NTS);
+		CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+		rc = SQLExecute(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+		for (j = 0; j < RESULTS_PER_QUERY; j++)
+		{
+			rc = SQLFetch(hstmt);
+			CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+			memset(&ns, 0, sizeof(ns));
+			rc = SQLGetData(hstmt, 1, SQL_C_NUMERIC, &ns, sizeof(ns), NULL);
+			CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+			ref_str_to_numeric(numstrs[j], &refns);
+			if (memcmp(&ns, &refns, sizeof(ns)) != 0)
+			{
+				printf("result mismatch for %s: ", numstrs[j]);
+				print_numeric_struct(&ns);
+				mismatches++;
+			}
+		}
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+	printf("%d results checked, %d mismatches\n", NUM_RESULTS, mismatches);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	printf("Testing SQL_NUMERIC_STRUCT params...\n");
+	test_params(hstmt);
+
+	printf("Testing SQL_NUMERIC_STRUCT results in text format...\n");
+	test_results(hstmt);
+
+	test_disconnect();
+	test_connect_ext("BinaryResults=1");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	printf("Testing SQL_NUMERIC_STRUCT results in binary format...\n");
+	test_results(hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -15,6 +15,7 @@ int main(int argc, char **argv)
 	SQLSMALLINT decDigits;
 	SQLSMALLINT nullable;
 	SQLUSMALLINT supported;
+	SQLREAL		floatparam;
 
 	test_connect();
 
@@ -184,6 +185,53 @@ int main(int argc, char **argv)
 	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
 	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
 
+
+	/*** Test a SQL_C_FLOAT param stored in float8 and float4 columns ***/
+	printf("\nTesting SQL_C_FLOAT param with float8 and float4 columns...\n");
+
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE floattab (f float8, r float4)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed while creating temp table", hstmt);
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "INSERT INTO floattab VALUES (?, ?)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+
+	floatparam = 0.1f;
+	cbParam1 = 0;
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+						  SQL_C_FLOAT,	/* value type */
+						  SQL_REAL,		/* param type */
+						  0,			/* column size */
+						  0,			/* dec digits */
+						  &floatparam,	/* param value ptr */
+						  0,			/* buffer len */
+						  &cbParam1		/* StrLen_or_IndPtr */);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT,
+						  SQL_C_FLOAT,	/* value type */
+						  SQL_REAL,		/* param type */
+						  0,			/* column size */
+						  0,			/* dec digits */
+						  &floatparam,	/* param value ptr */
+						  0,			/* buffer len */
+						  &cbParam1		/* StrLen_or_IndPtr */);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT f::text, r::text FROM floattab", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
 	/* Clean up */
 	test_disconnect();
 
@@ -5,9 +5,11 @@
  *					for individual fields (TupleField structure) of a
  *					manual result set.
  *
- * Important Note:	These functions are ONLY used in building manual
- *					result sets for info functions (SQLTables,
+ * Important Note:	The set_tuplefield functions are ONLY used in building
+ *					manual result sets for info functions (SQLTables,
  *					SQLColumns, etc.)
+ *					The TA_ functions manage the arena which holds the
+ *					values of the tuple cache read from the backend.
  *
  * Classes:			n/a
  *
@@ -19,9 +21,16 @@
 
 #include "tuple.h"
 #include "misc.h"
+#include "mylog.h"
 
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
+#ifndef	WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif /* WIN32 */
 
 
 void
@@ -69,3 +78,251 @@ set_tuplefield_int4(TupleField *tuple_field, Int4 value)
 	/* +1 ... is this correct (better be on the save side-...) */
 	tuple_field->value = strdup(buffer);
 }
+
+
+/*
+ *	Tuple arena
+ *
+ *	Each value read from the backend used to be malloc'ed separately.
+ *	The arena carves the values out of a few large blocks instead and
+ *	releases them all at once.
+ */
+struct TupleArenaBlock_
+{
+	TupleArenaBlock	*next;
+	size_t		size;	/* usable size of data */
+	size_t		used;
+	size_t		mapped;	/* length of the mapping or 0 if malloc'ed */
+	char		data[1];
+};
+
+void
+TA_init(TupleArena *arena)
+{
+	arena->blocks = NULL;
+	arena->next_size = TA_ARENA_INITIAL_SIZE;
+	arena->allocated = 0;
+	arena->spill_threshold = 0;
+	arena->spill_fd = -1;
+	arena->spilled = 0;
+}
+
+/*
+ *	Let the blocks past threshold bytes spill to a temporary file.
+ */
+void
+TA_set_spill(TupleArena *arena, size_t threshold)
+{
+	arena->spill_threshold = threshold;
+}
+
+/*
+ *	Map a block from the end of the temporary file. The pages of the
+ *	file are shared, so the kernel can write them back and drop them
+ *	under memory pressure instead of running out of memory.
+ *
+ *	The blocks are mapped TA_SPILL_SEGMENT_SIZE bytes at least, which
+ *	the values are carved from, so that a big result doesn't run into
+ *	the limit of the number of mappings of the process.
+ */
+static TupleArenaBlock *
+TA_map_block(TupleArena *arena, size_t size)
+{
+#ifdef	WIN32
+	return NULL;
+#else
+	TupleArenaBlock	*block;
+	size_t		length, pagesize = (size_t) sysconf(_SC_PAGESIZE);
+	void		*addr;
+
+	if (arena->spill_fd < 0)
+	{
+		const char	*tmpdir = getenv("TMPDIR");
+		char		path[1024];
+
+		if (NULL == tmpdir || '\0' == tmpdir[0])
+			tmpdir = "/tmp";
+		SPRINTF_FIXED(path, "%s/psqlodbc_spill_XXXXXX", tmpdir);
+		if (arena->spill_fd = mkstemp(path), arena->spill_fd < 0)
+		{
+			MYLOG(0, "couldn't create the spill file in %s\n", tmpdir);
+			return NULL;
+		}
+		/* the file goes away when it's closed */
+		unlink(path);
+		MYLOG(0, "spilling the tuple arena past " FORMAT_SIZE_T " bytes\n", arena->allocated);
+	}
+	if (size < TA_SPILL_SEGMENT_SIZE)
+		size = TA_SPILL_SEGMENT_SIZE;
+	length = offsetof(TupleArenaBlock, data) + size;
+	length = (length + pagesize - 1) / pagesize * pagesize;
+	if (ftruncate(arena->spill_fd, (off_t) (arena->spilled + length)) < 0)
+	{
+		MYLOG(0, "couldn't extend the spill file to " FORMAT_SIZE_T " bytes errno=%d\n", arena->spilled + length, errno);
+		return NULL;
+	}
+	addr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, arena->spill_fd, (off_t) arena->spilled);
+	if (MAP_FAILED == addr)
+	{
+		MYLOG(0, "couldn't map " FORMAT_SIZE_T " bytes of the spill file errno=%d\n", length, errno);
+		return NULL;
+	}
+	block = (TupleArenaBlock *) addr;
+	block->size = length - offsetof(TupleArenaBlock, data);
+	block->mapped = length;
+	arena->spilled += length;
+	return block;
+#endif /* WIN32 */
+}
+
+static TupleArenaBlock *
+TA_new_block(TupleArena *arena, size_t size)
+{
+	TupleArenaBlock	*block = NULL;
+
+	if (arena->spill_threshold > 0 &&
+		arena->allocated >= arena->spill_threshold)
+	{
+		/* fall back to the heap if the file couldn't be mapped */
+		if (block = TA_map_block(arena, size), NULL == block)
+			MYLOG(0, "allocating a block of " FORMAT_SIZE_T " bytes from the heap instead of the spill file\n", size);
+	}
+	if (NULL == block)
+	{
+		if (block = (TupleArenaBlock *) malloc(offsetof(TupleArenaBlock, data) + size), NULL == block)
+			return NULL;
+		block->size = size;
+		block->mapped = 0;
+		arena->allocated += size;
+	}
+	block->used = 0;
+	return block;
+}
+
+static void
+TA_free_block(TupleArena *arena, TupleArenaBlock *block)
+{
+#ifndef	WIN32
+	if (block->mapped > 0)
+	{
+		munmap(block, block->mapped);
+		return;
+	}
+#endif /* WIN32 */
+	arena->allocated -= block->size;
+	free(block);
+}
+
+/*
+ *	Allocate size bytes from the arena.
+ */
+char *
+TA_alloc(TupleArena *arena, size_t size)
+{
+	TupleArenaBlock	*block = arena->blocks;
+	char		*buffer;
+
+	if (NULL == block || block->size - block->used < size)
+	{
+		BOOL	big = (size > arena->next_size / 4);
+
+		/*
+		 * Big values get a block of their own, so that the rest of the
+		 * current block isn't wasted.
+		 */
+		if (block = TA_new_block(arena, big ? size : arena->next_size), NULL == block)
+			return NULL;
+		/*
+		 * The block with more room left is the one in use, e.g. a mapped
+		 * segment which a big value took only a part of.
+		 */
+		if (NULL == arena->blocks ||
+			block->size - size > arena->blocks->size - arena->blocks->used)
+		{
+			block->next = arena->blocks;
+			arena->blocks = block;
+		}
+		else
+		{
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+		}
+		if (!big && arena->next_size < TA_ARENA_MAX_SIZE)
+			arena->next_size *= 2;
+	}
+	buffer = block->data + block->used;
+	block->used += size;
+
+	return buffer;
+}
+
+char *
+TA_strdup(TupleArena *arena, const char *value)
+{
+	size_t	len = strlen(value) + 1;
+	char	*buffer;
+
+	if (buffer = TA_alloc(arena, len), NULL != buffer)
+		memcpy(buffer, value, len);
+	return buffer;
+}
+
+/*
+ *	Release all the values but keep the block in use for the next ones.
+ */
+void
+TA_reset(TupleArena *arena)
+{
+	TupleArenaBlock	*block, *next;
+
+	if (NULL == (block = arena->blocks))
+		return;
+	for (next = block->next; NULL != next;)
+	{
+		TupleArenaBlock	*nnext = next->next;
+
+		TA_free_block(arena, next);
+		next = nnext;
+	}
+	if (block->mapped > 0)
+	{
+		TA_free_block(arena, block);
+		arena->blocks = NULL;
+	}
+	else
+	{
+		block->next = NULL;
+		block->used = 0;
+	}
+#ifndef	WIN32
+	/* no block refers to the file any more */
+	if (arena->spill_fd >= 0 && arena->spilled > 0)
+	{
+		if (ftruncate(arena->spill_fd, 0) < 0)
+			MYLOG(0, "couldn't truncate the spill file\n");
+		arena->spilled = 0;
+	}
+#endif /* WIN32 */
+}
+
+/*
+ *	Release all the blocks. The spill threshold is kept.
+ */
+void
+TA_free(TupleArena *arena)
+{
+	TupleArenaBlock	*block, *next;
+	size_t		threshold = arena->spill_threshold;
+
+	for (block = arena->blocks; NULL != block; block = next)
+	{
+		next = block->next;
+		TA_free_block(arena, block);
+	}
+#ifndef	WIN32
+	if (arena->spill_fd >= 0)
+		close(arena->spill_fd);
+#endif /* WIN32 */
+	TA_init(arena);
+	arena->spill_threshold = threshold;
+}
@@ -64,6 +64,37 @@ void		set_tuplefield_int2(TupleField *tuple_field, Int2 value);
 void		set_tuplefield_int4(TupleField *tuple_field, Int4 value);
 SQLLEN	ClearCachedRows(TupleField *tuple, int num_fields, SQLLEN num_rows);
 SQLLEN	ReplaceCachedRows(TupleField *otuple, const TupleField *ituple, int num_fields, SQLLEN num_rows);
+int	MoveCachedRows(TupleField *otuple, TupleField *ituple, Int2 num_fields, SQLLEN num_rows);
+
+/*
+ *	Bump allocator which holds the values of a tuple cache.
+ *	The values are released all together by TA_reset() or TA_free().
+ *	Once spill_threshold bytes are allocated, the further blocks are
+ *	mapped from a temporary file instead of the heap, in segments of at
+ *	least TA_SPILL_SEGMENT_SIZE bytes.
+ */
+typedef struct TupleArenaBlock_ TupleArenaBlock;
+typedef struct
+{
+	TupleArenaBlock	*blocks;	/* the block in use comes first */
+	size_t		next_size;	/* size of the next block to allocate */
+	size_t		allocated;	/* total size of the malloc'ed blocks */
+	size_t		spill_threshold;	/* 0 means never spill */
+	int		spill_fd;	/* the temporary file or -1 */
+	size_t		spilled;	/* size of the mapped blocks */
+} TupleArena;
+
+#define	TA_ARENA_INITIAL_SIZE	(8 * 1024)
+#define	TA_ARENA_MAX_SIZE	(1024 * 1024)
+#define	TA_SPILL_SEGMENT_SIZE	(64 * 1024 * 1024)
+#define	TA_is_used(arena)	(NULL != (arena)->blocks)
+
+void		TA_init(TupleArena *arena);
+void		TA_set_spill(TupleArena *arena, size_t threshold);
+char		*TA_alloc(TupleArena *arena, size_t size);
+char		*TA_strdup(TupleArena *arena, const char *value);
+void		TA_reset(TupleArena *arena);
+void		TA_free(TupleArena *arena);
 
 typedef struct _PG_BM_ {
 	Int4	index;